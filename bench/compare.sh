@@ -0,0 +1,32 @@
+#!/bin/sh
+# Bandingake rong hasil bench/run.sh
+#
+#   sh bench/compare.sh lawas.json anyar.json
+#
+# Saben benchmark dibandingake miturut min_ms. Sing luwih alon tinimbang
+# BENCH_AMBANG persen (bawaan 10) ditandhani lan script metu karo status 1.
+
+if [ $# -ne 2 ]; then
+    echo "Usage: sh bench/compare.sh lawas.json anyar.json" >&2
+    exit 2
+fi
+
+AMBANG=${BENCH_AMBANG:-10}
+
+# Baris hasil: "jeneng": { "min_ms": N, ...
+awk -v ambang="$AMBANG" '
+    BEGIN { printf "%-28s %10s %10s %8s\n", "benchmark", "lawas ms", "anyar ms", "owah" }
+    match($0, /^ *"[^"]*": \{ "min_ms": [0-9.]+/) {
+        s = substr($0, RSTART, RLENGTH)
+        sub(/^ *"/, "", s)
+        jeneng = s; sub(/".*/, "", jeneng)
+        ms = s; sub(/.*: /, "", ms)
+        if (FNR == NR) { lawas[jeneng] = ms; next }
+        if (!(jeneng in lawas)) { printf "%-28s %10s %10.1f        anyar\n", jeneng, "-", ms; next }
+        owah = lawas[jeneng] > 0 ? (ms - lawas[jeneng]) * 100 / lawas[jeneng] : 0
+        tandha = owah > ambang ? "  LUWIH ALON" : ""
+        if (owah > ambang) alon++
+        printf "%-28s %10.1f %10.1f %+7.1f%%%s\n", jeneng, lawas[jeneng], ms, owah, tandha
+    }
+    END { exit alon > 0 }
+' "$1" "$2"
@@ -0,0 +1,144 @@
+#!/bin/sh
+# Benchmark Jawa: micro (primitif runtime) lan makro (transpile, build, mlayu)
+#
+#   sh bench/run.sh [-o hasil.json] [saringan]
+#
+# Hasil ditulis sebagai JSON, siji baris per benchmark, supaya bisa
+# dibandingake antar versi karo bench/compare.sh. Saringan milih benchmark
+# sing jenenge ngandhut teks kuwi (umpamane "micro/" utawa "split").
+#
+# Variabel lingkungan:
+#   JAWA          biner jawa (bawaan ./jawa)
+#   BENCH_ULANG   pira kali saben benchmark dilakokake (bawaan 5)
+#   BENCH_FUNGSI  jumlah fungsi ing program gedhe makro (bawaan 200)
+
+set -e
+
+# Objek runtime (obj/*.o) dirujuk relatif marang root repo
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+cd "$ROOT"
+
+JAWA=${JAWA:-./jawa}
+ULANG=${BENCH_ULANG:-5}
+FUNGSI=${BENCH_FUNGSI:-200}
+SARINGAN=
+HASIL=
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+        -o) HASIL=$2; shift 2 ;;
+        *) SARINGAN=$1; shift ;;
+    esac
+done
+
+if [ ! -x "$JAWA" ]; then
+    echo "bench: $JAWA ora ana, jalankan make dhisik" >&2
+    exit 1
+fi
+
+KOMIT=$(git rev-parse --short HEAD 2>/dev/null || echo lokal)
+VERSI=$("$JAWA" version | sed 's/.* v//')
+# Bawaane ing build/, ora ing tengah sumber
+if [ -z "$HASIL" ]; then
+    mkdir -p build/bench
+    HASIL=build/bench/hasil-$KOMIT.json
+fi
+
+KERJA=$(mktemp -d "${TMPDIR:-/tmp}/jawa-bench.XXXXXX")
+trap 'rm -rf "$KERJA"' EXIT INT TERM
+export JAWA_CACHE="$KERJA/cache"
+
+# Wektu saiki ing nanodetik; date BSD ora ngerti %N
+case $(date +%s%N) in
+    *N) sekarang() { perl -MTime::HiRes=time -e 'printf "%.0f\n", time * 1e9'; } ;;
+    *) sekarang() { date +%s%N; } ;;
+esac
+
+# ukur <jeneng> <perintah...>: lakokake BENCH_ULANG kali, catet
+# milidetik paling cepet, median lan kabeh putaran
+BARIS=
+ukur() {
+    jeneng=$1
+    shift
+    case "$jeneng" in *"$SARINGAN"*) ;; *) return 0 ;; esac
+    wektu=
+    n=0
+    while [ $n -lt "$ULANG" ]; do
+        awal=$(sekarang)
+        "$@" > /dev/null
+        akhir=$(sekarang)
+        wektu="$wektu $(( (akhir - awal) / 1000 ))"
+        n=$((n + 1))
+    done
+    baris=$(echo $wektu | tr ' ' '\n' | sort -n | awk -v j="$jeneng" '
+        { us[NR] = $1; runs = runs (NR > 1 ? ", " : "") sprintf("%.1f", $1 / 1000) }
+        END {
+            med = NR % 2 ? us[(NR + 1) / 2] : (us[NR / 2] + us[NR / 2 + 1]) / 2
+            printf "    \"%s\": { \"min_ms\": %.1f, \"median_ms\": %.1f, \"runs_ms\": [%s] }",
+                   j, us[1] / 1000, med / 1000, runs
+        }')
+    echo "$baris" | sed 's/^ *//' >&2
+    BARIS="$BARIS${BARIS:+,
+}$baris"
+}
+
+# ---- Micro: saben bench/micro/*.jw dibuild sepisan lan dilakokake ----
+seq 1 1000000 | sed 's/^/baris nomer /' > "$KERJA/baris.txt"
+for src in bench/micro/*.jw; do
+    jeneng=$(basename "$src" .jw)
+    case "micro/$jeneng" in *"$SARINGAN"*) ;; *) continue ;; esac
+    "$JAWA" build "$src" "$KERJA/$jeneng" > /dev/null
+    ukur "micro/$jeneng" sh -c 'cd "$1" && ./"$2"' sh "$KERJA" "$jeneng"
+done
+
+# ---- Makro: program gedhe digawe, siji unit per fungsi ----
+GEDHE="$KERJA/gedhe.jw"
+gawe_gedhe() {
+    awk -v n="$FUNGSI" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            printf "gawe fungsi_%d(a: int, b: int): int\n{\n", i
+            printf "    owahi c: int = a * %d + b\n", i + 1
+            printf "    bali c + %d\n}\n\n", i
+        }
+        print "owahi total: int = 0"
+        for (i = 0; i < n; i++) {
+            printf "owahi teks_%d = \"nilai \" + fungsi_%d(%d, 3)\n", i, i, i
+            printf "total = total + teks_%d.length\n", i
+        }
+        print "cithak(total)"
+    }' > "$GEDHE"
+}
+
+gawe_gedhe
+# Cache kosong: transpile lan kompilasi kabeh unit
+ukur "macro/build_cold" sh -c 'rm -rf "$JAWA_CACHE" && "$1" build "$2" "$3"' sh "$JAWA" "$GEDHE" "$KERJA/gedhe"
+# Cache isi: transpile, hash lan link, tanpa kompilasi C
+ukur "macro/build_cached" "$JAWA" build "$GEDHE" "$KERJA/gedhe"
+# Siji fungsi diowahi saben putaran: mung unit kuwi dikompilasi maneh
+ukur "macro/build_one_changed" sh -c '
+    n=$(cat "$4.ke" 2>/dev/null || echo 1000); n=$((n + 1)); echo $n > "$4.ke"
+    sed "s/a \* 1 + b$/a * $n + b/" "$2" > "$4.jw"
+    "$1" build "$4.jw" "$3"' sh "$JAWA" "$GEDHE" "$KERJA/gedhe" "$KERJA/owah"
+ukur "macro/run_large" "$KERJA/gedhe"
+
+# Program cilik saka awal nganti rampung
+cat > "$KERJA/halo.jw" <<'EOF'
+owahi jeneng = "donya"
+cithak("Halo " + jeneng)
+EOF
+ukur "macro/build_run_cold" sh -c 'rm -rf "$JAWA_CACHE" && "$1" build "$2.jw" "$2" && "$2"' sh "$JAWA" "$KERJA/halo"
+ukur "macro/mlayu_cached" "$JAWA" mlayu "$KERJA/halo.jw"
+
+{
+    echo "{"
+    echo "  \"jawa\": \"$VERSI\","
+    echo "  \"commit\": \"$KOMIT\","
+    echo "  \"date\": \"$(date -u +%Y-%m-%dT%H:%M:%SZ)\","
+    echo "  \"host\": \"$(uname -sm)\","
+    echo "  \"runs\": $ULANG,"
+    echo "  \"results\": {"
+    [ -z "$BARIS" ] || echo "$BARIS"
+    echo "  }"
+    echo "}"
+} > "$HASIL"
+echo "bench: hasil ing $HASIL" >&2
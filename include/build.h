@@ -0,0 +1,92 @@
+#ifndef BUILD_H
+#define BUILD_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Incremental native builds. The generated program is split into one C
+// translation unit per function, per class, the main program and the
+// runtime; all units include one shared header. Objects are cached by a
+// hash of their text, so an edit only recompiles the units it changed.
+// Units of imported modules include their module's own header instead,
+// so their objects are shared by every program importing the module.
+
+typedef struct {
+    char name[64];   // for diagnostics, e.g. "gawe_hitung"
+    char *text;
+    size_t len;
+    int header;      // 0 = plan header, k = module_headers[k - 1]
+} BuildUnit;
+
+typedef struct {
+    char *text;
+    size_t len;
+} BuildHeader;
+
+typedef struct {
+    char *header;
+    size_t header_len;
+    BuildUnit *units;
+    int count;
+    int capacity;
+    BuildHeader *module_headers;
+    int module_header_count;
+    char cflags[128];   // compile flags; part of every object's cache key
+    char ldflags[128];  // link flags
+} BuildPlan;
+
+// Default flags, and the ones "jawa build --release" uses
+#define BUILD_CFLAGS "-O2 -std=c11"
+#define BUILD_LDFLAGS "-O2"
+#define BUILD_RELEASE_CFLAGS "-O3 -march=native -flto -std=c11"
+#define BUILD_RELEASE_LDFLAGS "-O3 -march=native -flto"
+
+
+void build_plan_init(BuildPlan *plan);
+void build_plan_free(BuildPlan *plan);
+void build_plan_set_flags(BuildPlan *plan, const char *cflags, const char *ldflags);
+
+// Scratch stream whose contents become a header or unit
+FILE *build_stream_open(void);
+
+// Take over the text written to f (f is closed)
+void build_plan_set_header(BuildPlan *plan, FILE *f);
+void build_plan_add_unit(BuildPlan *plan, const char *name, FILE *f);
+
+// Header for the units of one imported module (f is closed); returns its
+// id (>= 1), or 0 on failure
+int build_plan_add_module_header(BuildPlan *plan, FILE *f);
+
+// Add a copy of text as a unit compiled against header id
+void build_plan_add_unit_text(BuildPlan *plan, int header, const char *name,
+                              const char *text, size_t len);
+
+// FNV-1a, 64 bit; start with h = BUILD_HASH_INIT
+#define BUILD_HASH_INIT 1469598103934665603ULL
+uint64_t build_hash(uint64_t h, const void *data, size_t len);
+
+// Compile units missing from the cache in parallel, then link outPath.
+// Returns 0 on success, 2 on cache I/O errors, 3 if compiling or linking failed.
+int build_plan_link(BuildPlan *plan, const char *outPath);
+
+// Profile-guided build of outPath as one translation unit: compile with
+// -fprofile-generate, run the training command (or the instrumented
+// binary on train_input's stdin), then rebuild with -fprofile-use. The
+// profile is kept in <cache>/pgo-<hash> and reused while the program and
+// flags stay the same. In train, "{}" stands for the instrumented binary,
+// which is also exported as $JAWA_PGO_BIN. Returns like build_plan_link.
+int build_plan_pgo(BuildPlan *plan, const char *outPath,
+                   const char *train, const char *train_input);
+
+#ifdef JAWA_WITH_TCC
+// Compile the whole plan in memory with libtcc and call its main
+int build_plan_run(BuildPlan *plan, int argc, char **argv);
+#endif
+
+// Object cache directory: $JAWA_CACHE, else ~/.jawa/cache.
+// Returns false if no directory could be created.
+bool build_cache_dir(char *buf, size_t bufsz);
+
+#endif // BUILD_H
@@ -36,6 +36,7 @@ typedef struct {
     char *mode;        // Mode akses
     char *path;        // Path file
     bool is_open;      // Status file (terbuka/tertutup)
+    bool interaktif;   // Terminal/pipe: output di-flush sebelum membaca
     FileErrorCode last_error; // Kode error terakhir
     char *error_message;      // Pesan error terakhir
 } JawaFile;
@@ -0,0 +1,22 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+// Run shell commands with at most max_jobs of them at once.
+// status[i] receives the exit code of cmds[i] (non-zero on failure).
+// Returns the number of commands that failed.
+// Under GNU make (or jobs_start_server) every job beyond the first also
+// needs a jobserver token, so nested builds share one global limit.
+int jobs_run(char *const cmds[], int count, int max_jobs, int *status);
+
+// Same, but job i runs fn(i, arg) in a forked worker; its return value
+// is the exit code.
+int jobs_run_fn(int count, int max_jobs, int (*fn)(int index, void *arg), void *arg, int *status);
+
+// Become the jobserver for n jobs unless make already provides one.
+// Child processes find it through MAKEFLAGS.
+int jobs_start_server(int n);
+
+// Default parallelism: $JAWA_JOBS, otherwise the number of online CPUs
+int jobs_default_count(void);
+
+#endif // JOBS_H
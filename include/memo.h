@@ -0,0 +1,30 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include "tugas.h"
+#include <stdbool.h>
+
+// Tabel memo untuk fungsi "@cache" / "ajek gawe". Kunci = semua argumen
+// fungsi, nilai = hasilnya. Jumlah isi dibatasi; bila penuh, isi yang
+// paling lama tidak dipakai (LRU) dibuang.
+//
+// Kunci string disalin ke tabel. Hasil string disimpan apa adanya: string
+// Jawa tidak pernah di-free, jadi hasil yang dibuang tetap sah.
+
+// Isi paling banyak bila @cache tidak menyebut ukuran
+#define MEMO_UKURAN 65536
+
+typedef struct JawaMemo JawaMemo;
+
+// jenis: satu huruf per argumen, 'i' (int/bool), 'd' (double) atau
+// 's' (string); paling banyak 16. ukuran <= 0 berarti MEMO_UKURAN. Bila
+// aman bukan nol, golek/simpen boleh dipanggil dari banyak thread.
+JawaMemo* memo_anyar(const char* jenis, long long ukuran, int aman);
+
+// Mencari hasil untuk kunci; true dan *asil diisi bila ada
+bool memo_golek(JawaMemo* m, const JawaNilai* kunci, JawaNilai* asil);
+
+// Menyimpan (atau mengganti) hasil untuk kunci
+void memo_simpen(JawaMemo* m, const JawaNilai* kunci, JawaNilai asil);
+
+#endif // MEMO_H
@@ -1,8 +1,33 @@
 #ifndef NATIVE_H
 #define NATIVE_H
 
+#include <stdbool.h>
+
+// Optimization options of "jawa build"
+typedef struct {
+    bool release;             // -O3 -march=native -flto
+    bool pgo;                 // profile-guided: instrument, train, rebuild
+    const char *train;        // training shell command; "{}" = the binary
+    const char *train_input;  // else: file fed to the binary's stdin
+    bool debug;               // -g, with #line directives to the .jw source
+    bool profile;             // debug build linked with the sampler (profil.h)
+    bool stats;               // count builtin calls, dump JSON at exit (statistik.h)
+} BuildOptions;
+
 // Transpile a .jw source file to C and build a native binary at outPath
 // Returns 0 on success, non-zero on failure.
 int build_native(const char *srcPath, const char *outPath);
+int build_native_with(const char *srcPath, const char *outPath, const BuildOptions *opts);
+
+// Transpile and run a .jw file ("jawa mlayu"). Built with JAWA_WITH_TCC
+// the program is compiled in memory; otherwise a temporary binary is
+// built with the system compiler. Returns the program's exit code.
+int run_native(const char *srcPath, int argc, char **argv);
+
+// "jawa profile": build srcPath with the sampling profiler, run it with
+// argv (argv[0] is the script) and report the hot .jw lines and functions.
+// Folded stacks for flamegraph.pl are written to folded_path. Returns the
+// program's exit code, or non-zero if building failed.
+int profile_native(const char *srcPath, const char *folded_path, int hz, int argc, char **argv);
 
 #endif // NATIVE_H
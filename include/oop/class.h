@@ -54,7 +54,8 @@ typedef struct JawaObject {
     struct JawaObject *next;
 } JawaObject;
 
-// Global class registry
+// Class registry of the current compilation. Multi-file builds fork one
+// process per input, so it is never shared between compilations.
 extern JawaClass *g_classes;
 
 // Function declarations
@@ -73,6 +74,8 @@ void object_set_property(JawaObject *obj, const char *name, void *value);
 
 // Code generation
 void generate_class_c_code(FILE *out, JawaClass *cls);
+void generate_class_struct_c_code(FILE *out, JawaClass *cls);   // struct + method prototypes
+void generate_class_methods_c_code(FILE *out, JawaClass *cls);  // method bodies
 void generate_object_c_code(FILE *out);
 
 #endif // OOP_CLASS_H
@@ -54,9 +54,15 @@ typedef struct JawaObjectEx {
 // Mencari kelas berdasarkan nama
 JawaClass* class_find_ex(const char *name);
 
-// Mendaftarkan kelas baru
+// Mendaftarkan kelas baru tanpa anggota; langsung terlihat di registry
 JawaClass* class_register_ex(const char *name);
 
+// Membuat kelas yang belum terlihat thread lain. Tambahkan properti,
+// metode dan induknya dulu, baru pasang dengan class_publish_ex; kelas
+// yang sudah terpasang tidak boleh diubah lagi.
+JawaClass* class_new_ex(const char *name);
+void class_publish_ex(JawaClass *cls);
+
 // Menambahkan properti ke kelas
 void class_add_property_ex(JawaClass *cls, const char *name, PropertyType type, bool is_private);
 
@@ -0,0 +1,49 @@
+#ifndef OPTIMIZER_H
+#define OPTIMIZER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include "lexer.h"
+#include "parser.h"
+
+// Constant folding works on the C text emitted by the expression parser.
+// Operands are addressed by their offsets in the output buffer:
+//   out[start .. lend)   left operand
+//   out[rstart .. *oi)   right operand
+// On success the whole span from start is replaced by the folded literal.
+
+// Fold arithmetic, comparison and logical operators on literal operands
+bool fold_binary(char *out, size_t outsz, int *oi, int start, int lend, int rstart, TokKind op);
+
+// Rewrite a constant expression at out[start .. *oi) as a plain literal,
+// e.g. "(!false)" -> "true", "(-(-2))" -> "2"
+bool fold_constant(char *out, size_t outsz, int *oi, int start);
+
+// Fold string concatenation "a" + <literal> into a single C literal.
+// right is the right operand as emitted, right_ty its Jawa type.
+bool fold_string_concat(char *out, size_t outsz, int *oi, int start, const char *right, Ty right_ty);
+
+// Evaluate an emitted condition: 1 = always true, 0 = always false, -1 = unknown
+int fold_condition(const char *expr);
+
+// True if expr[0 .. len) is a single runtime call returning a fresh
+// string, which may then be modified in place
+bool is_fresh_string(const char *expr, int len);
+
+// Loop-invariant hoisting. A loop is first translated in discovery mode,
+// where hoistable calls are recorded as candidates; candidates whose
+// operands the loop never assigns are then declared in front of it and
+// substituted while the loop is emitted for real.
+
+// Offer the call in buf for hoisting. operands are the call's arguments as
+// emitted; on a hit buf is rewritten to the temporary's name.
+void hoist_call(ParserContext *ctx, char *buf, size_t bufsz, const char *const operands[], int n, Ty ty);
+
+// Append variables assigned or declared on a source line to names
+void hoist_collect_mutations(const char *line, char *names, size_t namesz);
+
+// Declare candidates [base, hoist_count) that read no mutated variable
+void hoist_emit(ParserContext *ctx, int base, const char *mutated, FILE *out);
+
+#endif // OPTIMIZER_H
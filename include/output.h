@@ -0,0 +1,36 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include <stddef.h>
+
+// Buffer stdout untuk program hasil build. Semua cithak/tulis masuk ke
+// satu buffer besar tanpa lock stdio, lalu ditulis sekaligus saat penuh,
+// saat program selesai, sebelum membaca stdin, atau lewat cithak_flush.
+// Mode per baris (flush tiap '\n') dipakai bila stdout adalah terminal
+// atau JAWA_STDOUT=line; JAWA_STDOUT=full memaksa buffer penuh.
+
+// Menambahkan len byte s ke buffer
+void cithak_tulis(const char* s, size_t len);
+
+// Satu statement cithak: pola berisi teks biasa dan penanda nilai
+//   %s string, %i long long, %f double, %b bool (int), %% tanda persen
+void cithak_format(const char* pola, ...);
+
+// Menulis isi buffer ke stdout
+void cithak_flush(void);
+
+// Output badan loop paralel ditampung per chunk di thread pemanggil lalu
+// ditulis urut nomor chunk. t = NULL kembali menulis ke buffer stdout.
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} CithakTangkapan;
+
+void cithak_tangkap(CithakTangkapan* t);
+
+// Dipanggil runtime tugas sebelum worker pertama dibuat: sejak itu buffer
+// dikunci, dan satu statement cithak tidak tercampur dengan thread lain
+void cithak_bareng(void);
+
+#endif // OUTPUT_H
@@ -20,13 +20,22 @@ int handle_paket_command(int argc, char **argv);
 // Fungsi untuk memasang paket
 int pasang_paket(const char *nama_paket, const char *versi);
 
+// Pasang ketergantungan <proyek_dir>/paket.json dari registri lokal
+// (<registri>/<nama>/<versi>.zip) dan tulis <proyek_dir>/paket.lock
+int pasang_proyek(const char *proyek_dir, const char *registri);
+
 // Dapatkan jalur direktori paket Jawa
 char *get_jawa_packages_dir();
 
 // Parse file konfigurasi paket
 JawaPaket *parse_paket_json(const char *json_path);
 
-// Fungsi bantuan untuk resolusi impor
+// Parse isi paket.json yang sudah dibaca ke memori
+JawaPaket *parse_paket_json_teks(const char *json_str);
+
+// Fungsi bantuan untuk resolusi impor: "./x", "../x" (relatif base_dir,
+// ".jw" boleh tidak ditulis) atau nama paket (paket_jawa/ proyek, lalu
+// ~/.jawa/paket). NULL bila berkas tidak ditemukan.
 char *resolve_import_path(const char *base_dir, const char *import_path);
 
 // Bebaskan memori paket
@@ -0,0 +1,21 @@
+#ifndef PAKET_ZIP_H
+#define PAKET_ZIP_H
+
+#include <stddef.h>
+
+// Pembaca arsip zip untuk paket: entri "stored" dan "deflate" diekstrak
+// langsung di proses (zlib), tanpa menjalankan unzip/powershell.
+
+// Mengekstrak seluruh isi zip_path ke direktori tujuan (dibuat bila belum
+// ada). Entri dengan path absolut atau ".." ditolak. 1 = berhasil.
+int zip_ekstrak(const char *zip_path, const char *tujuan);
+
+// Membaca satu entri (mis. "paket.json") ke memori yang diakhiri '\0';
+// NULL bila tidak ada. Panjang isi ditulis ke *len bila len bukan NULL.
+char *zip_waca_berkas(const char *zip_path, const char *nama, size_t *len);
+
+// Sidik SHA-256 arsip dalam heksadesimal (64 karakter + '\0'); dipakai
+// sebagai kunci penyimpanan paket. 1 = berhasil.
+int zip_sidik(const char *zip_path, char sidik[65]);
+
+#endif // PAKET_ZIP_H
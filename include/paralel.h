@@ -0,0 +1,27 @@
+#ifndef PARALEL_H
+#define PARALEL_H
+
+#include "tugas.h"
+
+// Runtime loop paralel ("ngulang paralel"). Iterasi dibagi menjadi chunk
+// yang dikerjakan pool thread; pada jadwal dinamis thread yang sudah
+// selesai mencuri separuh sisa chunk thread lain (work stealing).
+
+// Badan loop untuk iterasi [awal, akhir). red menunjuk slot reduksi chunk
+// ini: nilai awalnya sudah diisi, badan loop menulis hasilnya kembali.
+typedef void (*ParalelFn)(long long awal, long long akhir, void* env, JawaNilai* red);
+
+// Menjalankan fn untuk iterasi 0 .. n-1.
+//   benang  jumlah thread; 0 = $JAWA_THREADS atau jumlah CPU
+//   dinamis 0 = satu blok per thread, 1 = chunk kecil + work stealing
+//   chunk   ukuran chunk dinamis; 0 = otomatis
+//   hasil   nilai reduksi sebelum loop, diganti hasil akhirnya
+//   ops     satu karakter per reduksi: '+' jumlah, '<' min, '>' max
+//   jenis   satu karakter per reduksi: 'i' (field .i) atau 'd' (field .d)
+// Slot '+' dimulai dari 0, slot min/max dari nilai sebelum loop. Hasil
+// chunk digabung urut nomor chunk, dan output cithak dari badan loop
+// ditulis dalam urutan iterasi, jadi hasilnya tidak tergantung jadwal.
+void paralel_kanggo(long long n, int benang, int dinamis, long long chunk,
+                    ParalelFn fn, void* env, JawaNilai* hasil, const char* ops, const char* jenis);
+
+#endif // PARALEL_H
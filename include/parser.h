@@ -3,28 +3,80 @@
 
 #include "lexer.h"
 #include <stdio.h>
+#include <stdbool.h>
 
 // Type system
 typedef enum { 
-    TY_UNK=0, TY_INT, TY_DOUBLE, TY_BOOL, TY_STRING, TY_ARRAY, TY_MAP
+    TY_UNK=0, TY_INT, TY_DOUBLE, TY_BOOL, TY_STRING, TY_ARRAY, TY_MAP,
+    TY_TASK, TY_CHAN
 } Ty;
 
 // Variable tracking
 typedef struct { 
     char name[128]; 
     Ty ty; 
+    Ty elem;          // result type of a tugas, element type of a kanal
 } VarInfo;
 
+// Function declared with "gawe async": calling it starts a task
+typedef struct {
+    char name[64];
+    Ty ret;
+} AsyncFn;
+
+// Memoized function ("@cache" line or "ajek gawe"): results are kept in
+// an LRU table keyed by the arguments
+typedef struct {
+    bool on;
+    long long size;   // entries; 0 = runtime default
+    bool safe;        // "aman": table may be used from several threads
+} MemoSpec;
+
+// Loop-invariant call hoisted in front of a loop (see optimizer.c)
+typedef struct {
+    char call[256];   // emitted C call, e.g. "string_length(s)"
+    char deps[128];   // variables the call reads, space separated
+    char temp[32];    // name of the hoisted temporary
+    Ty ty;            // type of the temporary
+    bool active;      // substitute temp for call while emitting the loop
+} HoistEntry;
+
 // Parser context
 typedef struct {
     VarInfo vars[256];
     int var_count;
+    HoistEntry hoists[64];
+    int hoist_count;
+    int hoist_serial;
+    bool hoist_discover; // record hoisting candidates instead of substituting
+    AsyncFn async_fns[64];
+    int async_count;
+    Ty task_ty;          // result type of the last tugas expression parsed
+    int split_serial;    // numbers the split_count_N temporaries
+    char *line_file;     // quoted source name for #line directives; NULL = none
+    long *line_starts;   // offset of every source line, for line_file
+    int line_count;
+    char fn_name[64];        // "gawe" function being translated; "" elsewhere
+    char fn_params[16][64];  // its parameter names
+    int fn_param_count;      // -1 if it has more than fit in fn_params
+    bool fn_tail_loop;       // self tail calls jump back to the jawa_ulang label
+    MemoSpec fn_memo;        // "@cache" / "ajek gawe" options of the next function
 } ParserContext;
 
 // Parser functions
 void parser_init(ParserContext *ctx);
 void parser_add_var(ParserContext *ctx, const char *name, Ty ty);
 Ty parser_get_var_type(ParserContext *ctx, const char *name);
+void parser_set_var_elem(ParserContext *ctx, const char *name, Ty elem);
+Ty parser_get_var_elem(ParserContext *ctx, const char *name);
+void parser_add_async(ParserContext *ctx, const char *name, Ty ret);
+bool parser_is_async(ParserContext *ctx, const char *name, Ty *ret);
+
+// Field of JawaNilai holding a value of type ty: "i", "d" or "s"
+const char *parser_nilai_field(Ty ty);
+
+// Element type of "kanal<T>" (s points after "kanal"); TY_UNK without <T>
+Ty parser_kanal_elem(const char *s);
 
 // Expression parsing
 Ty parse_expr(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx);
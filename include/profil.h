@@ -0,0 +1,22 @@
+#ifndef PROFIL_H
+#define PROFIL_H
+
+// Profiler sampling untuk "jawa profile". Hanya di-link ke biner profil;
+// konstruktornya aktif bila $JAWA_PROFIL berisi path berkas sampel.
+// Tiap $JAWA_PROFIL_HZ kali per detik (bawaan 1000, waktu CPU lewat
+// SIGPROF) tumpukan panggilan dicatat ke memori, lalu ditulis saat
+// program selesai:
+//
+//   JAWAPROFIL 1 <hz>
+//   <n> <pigura> ...       satu baris per sampel, pigura terdalam dulu
+//   ilang <cacah>          sampel yang tidak muat di buffer
+//   detik <waktu CPU>      kernel bisa memberi sampel lebih jarang dari hz
+//
+// Pigura di biner program ditulis sebagai offset "0x..." (siap untuk
+// addr2line), pigura di pustaka lain sebagai "@<nama pustaka>". Pigura
+// pertama adalah alamat instruksi, sisanya alamat kembali.
+
+// Menghentikan sampling dan menulis berkas sampel; dipasang lewat atexit
+void profil_rampung(void);
+
+#endif // PROFIL_H
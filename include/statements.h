@@ -10,6 +10,7 @@ void parse_variable_declaration(const char *line, FILE *out, ParserContext *ctx)
 void parse_array_declaration(const char *line, FILE *out, ParserContext *ctx);
 void parse_map_declaration(const char *line, FILE *out, ParserContext *ctx);
 void parse_print_statement(const char *line, FILE *out, ParserContext *ctx);
+void parse_flush_statement(FILE *out);
 void parse_if_statement(const char *line, FILE *out, ParserContext *ctx);
 void parse_else_statement(const char *line, FILE *out);
 void parse_while_statement(const char *line, FILE *out, ParserContext *ctx);
@@ -19,18 +20,35 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx);
 void parse_return_statement(const char *line, FILE *out, ParserContext *ctx);
 void parse_standalone_function_call(const char *line, FILE *out, ParserContext *ctx);
 
+// Constant "yen" conditions: 1 = always true, 0 = always false, -1 = runtime
+int eval_if_condition(const char *line, ParserContext *ctx);
+
+// "bali fn(a, b)": the function returns the result of calling itself.
+// Stores up to max argument texts in args (may be NULL) and returns the
+// argument count, or -1 if line is not such a tail call.
+int self_tail_call(const char *line, const char *fn, char args[][256], int max);
+
+// "@cache", "@cache(N)", "@cache(N, aman)" or "ajek gawe ...": fills spec
+// and returns the rest of the line ("" when the annotation stands on its
+// own line and applies to the next "gawe"), or NULL for other lines.
+// Unknown options are reported when warn is set.
+const char *memo_annotation(const char *line, MemoSpec *spec, bool warn);
+
 // Helper functions
 bool is_variable_declaration(const char *line);
 bool is_array_declaration(const char *line);
 bool is_map_declaration(const char *line);
 bool is_print_statement(const char *line);
+bool is_flush_statement(const char *line);
 bool is_if_statement(const char *line);
 bool is_else_statement(const char *line);
 bool is_while_statement(const char *line);
 bool is_for_statement(const char *line);
+bool is_parallel_for_statement(const char *line);
 bool is_assignment(const char *line);
 bool is_function_definition(const char *line);
 bool is_return_statement(const char *line);
 bool is_standalone_function_call(const char *line);
+bool is_await_statement(const char *line);
 
 #endif // STATEMENTS_H
@@ -0,0 +1,65 @@
+#ifndef STATISTIK_H
+#define STATISTIK_H
+
+#include <stddef.h>
+
+// Pencacah runtime untuk "jawa build --stats". Tiap thread punya blok
+// cacahan sendiri (tanpa kunci maupun atomik di jalur panas); saat
+// program selesai semua blok dijumlah lan ditulis sebagai JSON ke
+// $JAWA_STATS, atau ke stderr bila tidak diisi.
+//
+// Per operasi dicacah jumlah panggilan, bait (memori yang dialokasikan,
+// atau bait yang dibaca/ditulis untuk I/O) dan histogram ukuran bait
+// dalam keranjang pangkat dua.
+
+// Daftar operasi: X(id, "nama di JSON")
+#define STATISTIK_JENIS(X) \
+    X(STAT_STR_DUP, "str_dup") \
+    X(STAT_STRING_CONCAT, "string_concat") \
+    X(STAT_STRING_SUBSTRING, "string_substring") \
+    X(STAT_STRING_REPLACE, "string_replace") \
+    X(STAT_STRING_SPLIT, "string_split") \
+    X(STAT_STRING_UPPER, "string_toUpperCase") \
+    X(STAT_STRING_LOWER, "string_toLowerCase") \
+    X(STAT_STRING_INDEXOF, "string_indexOf") \
+    X(STAT_STRING_LENGTH, "string_length") \
+    X(STAT_INT_TO_STRING, "int_to_string") \
+    X(STAT_DOUBLE_TO_STRING, "double_to_string") \
+    X(STAT_STRING_TO_NUMBER, "string_to_number") \
+    X(STAT_STRING_ARENA, "string_arena") \
+    X(STAT_ARRAY_SPLIT, "array_from_split") \
+    X(STAT_FILE_BUKA, "file_buka") \
+    X(STAT_FILE_WACA, "file_waca") \
+    X(STAT_FILE_TULIS, "file_tulis") \
+    X(STAT_CITHAK, "cithak") \
+    X(STAT_TUGAS, "tugas_mulai") \
+    X(STAT_KANAL_KIRIM, "kanal_kirim") \
+    X(STAT_PARALEL, "paralel_kanggo")
+
+#define STATISTIK_ENUM(id, nama) id,
+typedef enum { STATISTIK_JENIS(STATISTIK_ENUM) STAT_JENIS } StatJenis;
+#undef STATISTIK_ENUM
+
+// Nama JSON tiap jenis
+extern const char* const statistik_jeneng[STAT_JENIS];
+
+// Bukan nol sesudah statistik_mulai; modul runtime yang sudah dikompilasi
+// hanya mencacah bila aktif
+extern int statistik_aktif;
+
+// Mengaktifkan pencacah dan memasang penulisan JSON lewat atexit. Dipanggil
+// konstruktor unit runtime program yang dibuild dengan --stats.
+void statistik_mulai(void);
+
+// Satu panggilan jenis
+void statistik_panggil(int jenis);
+
+// bait yang dialokasikan / dibaca / ditulis oleh jenis
+void statistik_bait(int jenis, size_t bait);
+
+#define STATISTIK_PANGGIL(jenis) \
+    do { if (statistik_aktif) statistik_panggil(jenis); } while (0)
+#define STATISTIK_BAIT(jenis, bait) \
+    do { if (statistik_aktif) statistik_bait((jenis), (bait)); } while (0)
+
+#endif // STATISTIK_H
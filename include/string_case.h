@@ -0,0 +1,20 @@
+#ifndef STRING_CASE_H
+#define STRING_CASE_H
+
+#include <stddef.h>
+
+// Konversi huruf besar/kecil untuk len byte dari src ke dst; mengembalikan
+// jumlah byte yang ditulis (tanpa NUL).
+// Blok ASCII diproses 16 byte sekaligus (SSE2); urutan UTF-8 di-decode
+// dan huruf Latin-1/Latin Extended-A ikut dipetakan, karakter lain
+// disalin apa adanya. Pemetaan bawaan Unicode: ı (U+0131) besarnya "I",
+// İ (U+0130) kecilnya "i" + U+0307.
+//
+// Hasil huruf besar tidak pernah lebih panjang dari input, jadi dst boleh
+// sama dengan src. Hasil huruf kecil panjangnya string_huruf_cilik_dawane();
+// in-place hanya boleh bila nilai itu sama dengan len.
+size_t string_huruf_gedhe(char* dst, const char* src, size_t len);
+size_t string_huruf_cilik(char* dst, const char* src, size_t len);
+size_t string_huruf_cilik_dawane(const char* src, size_t len);
+
+#endif // STRING_CASE_H
@@ -1,13 +1,17 @@
 #ifndef STRING_ENHANCED_H
 #define STRING_ENHANCED_H
 
+#include "string_ops.h"
+
 // Menghapus spasi dari kedua sisi string
 // resep → resep (tidak berubah)
 // " resep " → "resep"
 char* string_trim_ex(const char* str);
 
-// Mengubah string menjadi array/daftar karakter
+// Mengubah string menjadi array/daftar karakter (per karakter UTF-8)
 // "Jawa" → ["J", "a", "w", "a"]
+// Hasil satu blok memori: bebaskan dengan satu free(hasil).
+// Untuk sekadar menelusuri karakter, pakai string_utf8_next.
 char** string_ke_karakter(const char* str, int* count);
 
 // Mengecek apakah string berisi substring
@@ -30,10 +34,17 @@ int string_mungkasi(const char* str, const char* suffix);
 // ["Jawa", "Sunda", "Bali"] + ", " → "Jawa, Sunda, Bali"
 char* string_gabung_array(char** arr, int count, const char* delimiter);
 
+// Menggabungkan JawaArray (elemen char*) dengan delimiter
+char* string_gabung_daftar(const JawaArray* arr, const char* delimiter);
+
 // Mengulang string sebanyak n kali
 // "Jawa" ulang 3 → "JawaJawaJawa"
 char* string_ulang(const char* str, int count);
 
+// Mengganti banyak pola sekaligus dalam satu kali pindai (Aho-Corasick)
+// "a b c" + ["a", "c"] -> ["1", "3"] → "1 b 3"
+char* string_ganti_banyak(const char* str, const char* const* finds, const char* const* replaces, int count);
+
 // Mengonversi string ke format JSON
 // "Jawa" → "\"Jawa\""
 char* string_ke_json(const char* str);
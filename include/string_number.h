@@ -0,0 +1,29 @@
+#ifndef STRING_NUMBER_H
+#define STRING_NUMBER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Konversi angka <-> teks tanpa sprintf/strtod di jalur umum.
+
+// Ukuran buffer minimum untuk string_tulis_int / string_tulis_double
+#define STRING_INT_MAX 24
+#define STRING_DOUBLE_MAX 32
+
+// Menulis value dalam desimal ke buf (diakhiri NUL), mengembalikan panjangnya
+size_t string_tulis_int(char* buf, long long value);
+
+// Menulis double dengan digit terpendek yang dibaca balik sebagai nilai
+// yang sama. Bilangan bulat ditulis tanpa ".0"; nan/inf seperti printf.
+size_t string_tulis_double(char* buf, double value);
+
+// Membaca bilangan bulat/desimal dari len byte s. Spasi di awal dan akhir
+// diabaikan; mengembalikan false bila ada karakter lain atau overflow.
+bool string_maca_int(const char* s, size_t len, long long* out);
+bool string_maca_double(const char* s, size_t len, double* out);
+
+// Salinan len byte s (plus NUL) dari arena per thread. Tidak boleh
+// di-free; cocok untuk string hasil konversi yang umurnya sepanjang program.
+char* string_arena_dup(const char* s, size_t len);
+
+#endif // STRING_NUMBER_H
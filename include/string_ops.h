@@ -3,6 +3,7 @@
 
 #include <stdio.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // String operations
 char* string_concat(const char* a, const char* b);
@@ -12,8 +13,13 @@ int string_length(const char* str);
 char* string_substring(const char* str, int start, int length);
 char* string_to_upper(const char* str);
 char* string_to_lower(const char* str);
+char* string_to_upper_inplace(char* str);   // converts str itself, returns it
+char* string_to_lower_inplace(char* str);
 bool string_contains(const char* str, const char* substr);
 char* string_trim(const char* str);
+// Trim without copying: returns the first non-space byte and stores the
+// trimmed length in *len. The view is not NUL-terminated at the end.
+const char* string_trim_view(const char* str, size_t* len);
 
 // Array/List operations
 typedef struct {
@@ -0,0 +1,12 @@
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+#include <stddef.h>
+
+// Mencari needle di dalam haystack (seperti memmem).
+// Mengembalikan pointer ke kemunculan pertama, atau NULL.
+// Needle kosong ditemukan di posisi 0.
+// Memakai AVX2/SSE2 bila CPU mendukung, selain itu versi skalar.
+const char* string_golek(const char* hay, size_t hay_len, const char* needle, size_t needle_len);
+
+#endif // STRING_SEARCH_H
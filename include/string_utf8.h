@@ -0,0 +1,46 @@
+#ifndef STRING_UTF8_H
+#define STRING_UTF8_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Teks UTF-8. String yang valid diindeks per karakter (code point);
+// string yang tidak valid tetap diperlakukan per byte.
+
+// Mengecek apakah len byte dari s adalah UTF-8 yang valid
+// (tanpa overlong, surrogate, atau code point di atas U+10FFFF)
+bool string_utf8_valid(const char* s, size_t len);
+
+// Jumlah karakter dalam len byte UTF-8 yang valid (SSE2 bila ada)
+size_t string_utf8_count(const char* s, size_t len);
+
+// Jumlah karakter, atau len bila s bukan UTF-8 yang valid
+size_t string_utf8_chars(const char* s, size_t len);
+
+// Offset byte dari karakter ke-n (len bila n melewati akhir).
+// String panjang memakai indeks jarang yang dibangun sekali lalu
+// di-cache per thread, jadi akses berikutnya O(1) teramortisasi.
+// Indeks dipakai ulang selama alamat dan panjangnya sama dan
+// string_utf8_lali() belum dipanggil sejak indeks dibangun.
+size_t string_utf8_offset(const char* s, size_t len, size_t n);
+
+// Membuang semua indeks string_utf8_offset (semua thread). Panggil setelah
+// mengubah isi string di tempat atau membebaskan string yang pernah
+// diindeks; konversi huruf in-place (string_case.h) sudah memanggilnya.
+void string_utf8_lali(void);
+
+// Iterator karakter tanpa alokasi
+typedef struct {
+    const char* pos;
+    const char* end;
+} Utf8Iter;
+
+void string_utf8_iter(Utf8Iter* it, const char* s, size_t len);
+
+// Karakter berikutnya: code point di *cp, byte aslinya di *bytes/*nbytes.
+// Byte yang tidak valid menghasilkan U+FFFD sepanjang 1 byte.
+// Mengembalikan false di akhir string.
+bool string_utf8_next(Utf8Iter* it, uint32_t* cp, const char** bytes, size_t* nbytes);
+
+#endif // STRING_UTF8_H
@@ -0,0 +1,51 @@
+#ifndef TUGAS_H
+#define TUGAS_H
+
+// Runtime tugas ("gawe async" / "tunggu"). Tugas dijalankan pool worker
+// (M tugas di atas N thread); tiap worker punya antrian sendiri dan
+// mencuri dari antrian worker lain bila kosong. Thread yang menunggu
+// tugas yang belum mulai menjalankannya sendiri; worker yang tertahan
+// (tunggu, I/O file, kanal) diganti worker baru supaya tugas lain tetap
+// jalan.
+
+// Nilai hasil tugas dan isi kanal; bool disimpan di i
+typedef union {
+    long long i;
+    double d;
+    const char* s;
+} JawaNilai;
+
+typedef struct JawaTugas JawaTugas;
+typedef struct JawaKanal JawaKanal;
+
+// Badan tugas: arg dibebaskan runtime setelah fn selesai
+typedef void (*TugasFn)(void* arg, JawaNilai* hasil);
+
+// Menjadwalkan fn(arg); jumlah worker dari $JAWA_THREADS atau jumlah CPU
+JawaTugas* tugas_mulai(TugasFn fn, void* arg);
+
+// Menunggu *t selesai, mengembalikan hasilnya lalu membebaskan tugas.
+// *t dijadikan NULL; tunggu pada handle NULL mengembalikan nilai nol.
+JawaNilai tugas_tunggu(JawaTugas** t);
+
+// Melepas handle yang tidak akan ditunggu; tugas tetap dijalankan
+void tugas_lali(JawaTugas* t);
+
+// Menunggu semua tugas yang sudah dijadwalkan. Dipasang lewat atexit saat
+// tugas pertama dibuat, jadi program tidak berhenti di tengah tugas.
+void tugas_entekke(void);
+
+// Dipanggil di sekitar operasi yang bisa lama tertahan (baca/tulis file,
+// menunggu kanal). Di luar worker tidak melakukan apa-apa.
+void tugas_blokir_mulai(void);
+void tugas_blokir_rampung(void);
+
+// Kanal berkapasitas tetap (minimal 1). kirim menunggu selama kanal
+// penuh, tampa menunggu selama kosong. Setelah kanal_tutup, tampa pada
+// kanal kosong mengembalikan nilai nol dan kirim diabaikan.
+JawaKanal* kanal_anyar(long long kapasitas);
+void kanal_kirim(JawaKanal* k, JawaNilai v);
+JawaNilai kanal_tampa(JawaKanal* k);
+void kanal_tutup(JawaKanal* k);
+
+#endif // TUGAS_H
@@ -0,0 +1,553 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "build.h"
+#include "jobs.h"
+
+#ifdef JAWA_WITH_TCC
+#include <libtcc.h>
+#include "file_ops.h"
+#include "string_search.h"
+#include "string_case.h"
+#include "string_utf8.h"
+#include "string_number.h"
+#include "output.h"
+#include "paralel.h"
+#include "tugas.h"
+#include "memo.h"
+#endif
+
+#ifdef _WIN32
+#define PATH_SEPARATOR "\\"
+#define mkdir(path, mode) mkdir(path)
+#define popen _popen
+#define pclose _pclose
+#define NULL_DEVICE "NUL"
+#else
+#define PATH_SEPARATOR "/"
+#define NULL_DEVICE "/dev/null"
+#endif
+
+// Runtime objects and libraries every program links with
+#define BUILD_RUNTIME " obj/file_ops.o obj/string_search.o obj/string_case.o obj/string_utf8.o obj/string_number.o obj/output.o obj/paralel.o obj/tugas.o obj/statistik.o obj/memo.o -lm -lpthread"
+
+void build_plan_init(BuildPlan *plan) {
+    memset(plan, 0, sizeof(*plan));
+    build_plan_set_flags(plan, BUILD_CFLAGS, BUILD_LDFLAGS);
+}
+
+void build_plan_set_flags(BuildPlan *plan, const char *cflags, const char *ldflags) {
+    snprintf(plan->cflags, sizeof(plan->cflags), "%s", cflags);
+    snprintf(plan->ldflags, sizeof(plan->ldflags), "%s", ldflags);
+}
+
+void build_plan_free(BuildPlan *plan) {
+    free(plan->header);
+    for (int i = 0; i < plan->count; i++) free(plan->units[i].text);
+    free(plan->units);
+    for (int i = 0; i < plan->module_header_count; i++) free(plan->module_headers[i].text);
+    free(plan->module_headers);
+    build_plan_init(plan);
+}
+
+FILE *build_stream_open(void) {
+    return tmpfile();
+}
+
+static char *read_stream(FILE *f, size_t *len) {
+    *len = 0;
+    if (!f) return NULL;
+    fflush(f);
+    long size = ftell(f);
+    if (size < 0) size = 0;
+    char *text = malloc((size_t)size + 1);
+    if (text) {
+        rewind(f);
+        *len = fread(text, 1, (size_t)size, f);
+        text[*len] = 0;
+    }
+    fclose(f);
+    return text;
+}
+
+void build_plan_set_header(BuildPlan *plan, FILE *f) {
+    free(plan->header);
+    plan->header = read_stream(f, &plan->header_len);
+}
+
+static BuildUnit *next_unit(BuildPlan *plan, const char *name, int header) {
+    if (plan->count == plan->capacity) {
+        int cap = plan->capacity ? plan->capacity * 2 : 16;
+        BuildUnit *units = realloc(plan->units, cap * sizeof(BuildUnit));
+        if (!units) return NULL;
+        plan->units = units;
+        plan->capacity = cap;
+    }
+    BuildUnit *u = &plan->units[plan->count];
+    snprintf(u->name, sizeof(u->name), "%s", name);
+    u->header = header;
+    return u;
+}
+
+void build_plan_add_unit(BuildPlan *plan, const char *name, FILE *f) {
+    BuildUnit *u = next_unit(plan, name, 0);
+    if (!u) { if (f) fclose(f); return; }
+    u->text = read_stream(f, &u->len);
+    if (u->text) plan->count++;
+}
+
+void build_plan_add_unit_text(BuildPlan *plan, int header, const char *name,
+                              const char *text, size_t len) {
+    BuildUnit *u = next_unit(plan, name, header);
+    if (!u || !(u->text = malloc(len + 1))) return;
+    memcpy(u->text, text, len);
+    u->text[len] = 0;
+    u->len = len;
+    plan->count++;
+}
+
+int build_plan_add_module_header(BuildPlan *plan, FILE *f) {
+    BuildHeader *h = realloc(plan->module_headers, (plan->module_header_count + 1) * sizeof(BuildHeader));
+    if (!h) { if (f) fclose(f); return 0; }
+    plan->module_headers = h;
+    h = &h[plan->module_header_count];
+    h->text = read_stream(f, &h->len);
+    return h->text ? ++plan->module_header_count : 0;
+}
+
+uint64_t build_hash(uint64_t h, const void *data, size_t len) {
+    const unsigned char *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static uint64_t hash_command_output(uint64_t h, const char *cmd) {
+    FILE *p = popen(cmd, "r");
+    if (p) {
+        char buf[4096];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), p)) > 0) h = build_hash(h, buf, n);
+        pclose(p);
+    }
+    return h;
+}
+
+// Key part for compile flags and the compiler. "cc" is whatever is first
+// on PATH, so its --version output (version, and for clang the target and
+// install dir) is hashed to keep objects from another compiler out.
+// "-march=native" means whatever CPU the compiler detects, so the driver's
+// expansion of it (gcc lists the resolved -march and -m options, clang the
+// -target-cpu) is hashed too; a cache shared between hosts then never hands
+// out objects tuned for another CPU. Both are detected once per process.
+static uint64_t flags_hash(const char *flags) {
+    static uint64_t compiler, host;
+    static bool compiler_done, host_done;
+    if (!compiler_done) {
+        compiler_done = true;
+        compiler = hash_command_output(BUILD_HASH_INIT, "cc --version 2>&1");
+    }
+    uint64_t h = build_hash(BUILD_HASH_INIT, flags, strlen(flags));
+    h = build_hash(h, &compiler, sizeof(compiler));
+    if (!strstr(flags, "-march=native")) return h;
+    if (!host_done) {
+        host_done = true;
+        host = hash_command_output(BUILD_HASH_INIT, "cc -march=native -### -E -x c " NULL_DEVICE " 2>&1");
+    }
+    return build_hash(h, &host, sizeof(host));
+}
+
+static bool ensure_dir(const char *path) {
+    struct stat st;
+    if (stat(path, &st) == 0) return S_ISDIR(st.st_mode);
+    return mkdir(path, 0700) == 0;
+}
+
+bool build_cache_dir(char *buf, size_t bufsz) {
+    const char *dir = getenv("JAWA_CACHE");
+    if (dir && *dir) {
+        snprintf(buf, bufsz, "%s", dir);
+        return ensure_dir(buf);
+    }
+
+    const char *home = getenv("JAWA_HOME");
+    if (!home) home = getenv("HOME");
+    if (!home) return false;
+
+    snprintf(buf, bufsz, "%s%s.jawa", home, PATH_SEPARATOR);
+    if (!ensure_dir(buf)) return false;
+    size_t n = strlen(buf);
+    snprintf(buf + n, bufsz - n, "%scache", PATH_SEPARATOR);
+    return ensure_dir(buf);
+}
+
+static bool file_exists(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0;
+}
+
+static bool write_file(const char *path, const char *text, size_t len) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    bool ok = fwrite(text, 1, len, f) == len;
+    if (fclose(f) != 0) ok = false;
+    return ok;
+}
+
+int build_plan_link(BuildPlan *plan, const char *outPath) {
+    char cache[FILENAME_MAX];
+    if (!build_cache_dir(cache, sizeof(cache))) {
+        // No usable home directory: keep the cache next to the output
+        snprintf(cache, sizeof(cache), "%s.jwcache", outPath);
+        if (!ensure_dir(cache)) {
+            perror("open build cache");
+            return 2;
+        }
+    }
+
+    // A unit's header goes into its key: the plan header is shared by the
+    // program's units, each imported module has its own
+    int nh = plan->module_header_count + 1;
+    uint64_t *hh = calloc(nh, sizeof(uint64_t));
+    char (*header_names)[32] = calloc(nh, sizeof(*header_names));
+    if (!hh || !header_names) {
+        free(hh);
+        free(header_names);
+        return 2;
+    }
+    for (int k = 0; k < nh; k++) {
+        const char *text = k ? plan->module_headers[k - 1].text : plan->header;
+        size_t len = k ? plan->module_headers[k - 1].len : plan->header_len;
+        hh[k] = build_hash(BUILD_HASH_INIT, text, len);
+        snprintf(header_names[k], sizeof(header_names[k]), "h%016llx.h", (unsigned long long)hh[k]);
+        char header_path[FILENAME_MAX];
+        snprintf(header_path, sizeof(header_path), "%s%s%s", cache, PATH_SEPARATOR, header_names[k]);
+        if (file_exists(header_path)) continue;
+        // Write under a private name first: parallel builds share the cache
+        char tmp_path[FILENAME_MAX];
+        snprintf(tmp_path, sizeof(tmp_path), "%s.%ld", header_path, (long)getpid());
+        if (!write_file(tmp_path, text, len) || rename(tmp_path, header_path) != 0) {
+            perror("write build header");
+            unlink(tmp_path);
+            free(hh);
+            free(header_names);
+            return 2;
+        }
+    }
+
+    int n = plan->count;
+    char **objs = calloc(n, sizeof(char *));
+    char **srcs = calloc(n, sizeof(char *));
+    char **tmps = calloc(n, sizeof(char *));
+    char **cmds = calloc(n, sizeof(char *));
+    int *idx = calloc(n, sizeof(int));
+    int *status = calloc(n, sizeof(int));
+    int pending = 0;
+    int rc = 0;
+    if (n && (!objs || !srcs || !tmps || !cmds || !idx || !status)) {
+        rc = 2;
+        goto done;
+    }
+
+    for (int i = 0; i < n && rc == 0; i++) {
+        BuildUnit *u = &plan->units[i];
+        uint64_t fh = flags_hash(plan->cflags);
+        uint64_t h = build_hash(hh[u->header], &fh, sizeof(fh));
+        h = build_hash(h, u->text, u->len);
+
+        size_t plen = strlen(cache) + 64;
+        objs[i] = malloc(plen);
+        if (!objs[i]) { rc = 2; break; }
+        snprintf(objs[i], plen, "%s%s%016llx.o", cache, PATH_SEPARATOR, (unsigned long long)h);
+        if (file_exists(objs[i])) continue;
+
+        // Unit sources and objects get per-process names until they are
+        // complete, so concurrent builds never see half-written files
+        srcs[i] = malloc(plen);
+        tmps[i] = malloc(plen);
+        if (!srcs[i] || !tmps[i]) { rc = 2; break; }
+        snprintf(srcs[i], plen, "%s%s%016llx.%ld.c", cache, PATH_SEPARATOR, (unsigned long long)h, (long)getpid());
+        snprintf(tmps[i], plen, "%s%s%016llx.%ld.o", cache, PATH_SEPARATOR, (unsigned long long)h, (long)getpid());
+
+        FILE *f = fopen(srcs[i], "wb");
+        if (!f) { perror("write build unit"); rc = 2; break; }
+        fprintf(f, "#include \"%s\"\n", header_names[u->header]);
+        fwrite(u->text, 1, u->len, f);
+        if (fclose(f) != 0) { perror("write build unit"); rc = 2; break; }
+
+        size_t clen = strlen(srcs[i]) + strlen(tmps[i]) + strlen(cache) + strlen(plan->cflags) + 64;
+        cmds[pending] = malloc(clen);
+        if (!cmds[pending]) { rc = 2; break; }
+        snprintf(cmds[pending], clen, "cc %s -I'%s' -c -o '%s' '%s'", plan->cflags, cache, tmps[i], srcs[i]);
+        idx[pending++] = i;
+    }
+
+    if (rc == 0 && pending > 0) {
+        jobs_run(cmds, pending, jobs_default_count(), status);
+        for (int j = 0; j < pending; j++) {
+            int i = idx[j];
+            if (status[j] != 0) {
+                fprintf(stderr, "Failed to compile %s (rc=%d)\n", plan->units[i].name, status[j]);
+                unlink(tmps[i]);
+                rc = 3;
+            } else if (rename(tmps[i], objs[i]) != 0) {
+                perror("store build object");
+                rc = 2;
+            }
+        }
+    }
+
+    if (rc == 0) {
+        // Link every unit with the runtime objects
+        size_t llen = strlen(outPath) + strlen(plan->ldflags) + strlen(BUILD_RUNTIME) + 32;
+        for (int i = 0; i < n; i++) llen += strlen(objs[i]) + 3;
+        char *cmd = malloc(llen);
+        if (!cmd) {
+            rc = 2;
+        } else {
+            size_t k = snprintf(cmd, llen, "cc %s -o '%s'", plan->ldflags, outPath);
+            for (int i = 0; i < n; i++) k += snprintf(cmd + k, llen - k, " '%s'", objs[i]);
+            snprintf(cmd + k, llen - k, "%s", BUILD_RUNTIME);
+            int lrc = system(cmd);
+            if (lrc != 0) {
+                fprintf(stderr, "Failed to build native binary (rc=%d)\n", lrc);
+                rc = 3;
+            }
+            free(cmd);
+        }
+    }
+
+done:
+    for (int i = 0; i < n; i++) {
+        if (srcs && srcs[i]) { unlink(srcs[i]); free(srcs[i]); }
+        if (tmps && tmps[i]) free(tmps[i]);
+        if (objs && objs[i]) free(objs[i]);
+    }
+    for (int j = 0; j < pending; j++) free(cmds[j]);
+    free(objs); free(srcs); free(tmps); free(cmds); free(idx); free(status);
+    free(hh); free(header_names);
+    return rc;
+}
+
+// The whole program as one translation unit: header followed by every unit
+static char *plan_source(BuildPlan *plan, size_t *out_len) {
+    size_t len = plan->header_len;
+    for (int i = 0; i < plan->count; i++) len += plan->units[i].len + 1;
+    char *code = malloc(len + 1);
+    if (!code) return NULL;
+    memcpy(code, plan->header, plan->header_len);
+    size_t k = plan->header_len;
+    for (int i = 0; i < plan->count; i++) {
+        memcpy(code + k, plan->units[i].text, plan->units[i].len);
+        k += plan->units[i].len;
+        code[k++] = '\n';
+    }
+    code[k] = 0;
+    *out_len = k;
+    return code;
+}
+
+// Compile dir/prog.c to dir/prog.o and link outPath. gcc names profile
+// data after the object, so both PGO passes must use the same paths.
+static int pgo_compile(const char *dir, const char *cflags, const char *ldflags,
+                       const char *outPath) {
+    char cmd[3 * FILENAME_MAX + 512];
+    snprintf(cmd, sizeof(cmd), "cc %s -c -o '%s%sprog.o' '%s%sprog.c'",
+             cflags, dir, PATH_SEPARATOR, dir, PATH_SEPARATOR);
+    int rc = system(cmd);
+    if (rc != 0) {
+        fprintf(stderr, "Failed to compile program (rc=%d)\n", rc);
+        return 3;
+    }
+    snprintf(cmd, sizeof(cmd), "cc %s -o '%s' '%s%sprog.o'" BUILD_RUNTIME,
+             ldflags, outPath, dir, PATH_SEPARATOR);
+    rc = system(cmd);
+    if (rc != 0) {
+        fprintf(stderr, "Failed to build native binary (rc=%d)\n", rc);
+        return 3;
+    }
+    return 0;
+}
+
+// Run the training workload against the instrumented binary
+static int pgo_train(const char *bin, const char *train, const char *train_input) {
+    char cmd[2 * FILENAME_MAX + 1024];
+    if (train && *train) {
+        // Substitute "{}" with the quoted binary path
+        size_t k = 0;
+        for (const char *p = train; *p && k + strlen(bin) + 3 < sizeof(cmd); p++) {
+            if (p[0] == '{' && p[1] == '}') {
+                k += snprintf(cmd + k, sizeof(cmd) - k, "'%s'", bin);
+                p++;
+            } else {
+                cmd[k++] = *p;
+            }
+        }
+        cmd[k] = 0;
+    } else {
+#ifdef _WIN32
+        snprintf(cmd, sizeof(cmd), "\"%s\" < \"%s\" > NUL", bin, train_input ? train_input : "NUL");
+#else
+        snprintf(cmd, sizeof(cmd), "'%s' < '%s' > /dev/null", bin, train_input ? train_input : "/dev/null");
+#endif
+    }
+#ifdef _WIN32
+    _putenv_s("JAWA_PGO_BIN", bin);
+#else
+    setenv("JAWA_PGO_BIN", bin, 1);
+#endif
+    return system(cmd);
+}
+
+int build_plan_pgo(BuildPlan *plan, const char *outPath,
+                   const char *train, const char *train_input) {
+    char cache[FILENAME_MAX];
+    if (!build_cache_dir(cache, sizeof(cache))) {
+        snprintf(cache, sizeof(cache), "%s.jwcache", outPath);
+        if (!ensure_dir(cache)) {
+            perror("open build cache");
+            return 2;
+        }
+    }
+
+    size_t len;
+    char *code = plan_source(plan, &len);
+    if (!code) return 2;
+
+    // Profiles are only valid for the exact program and flags; the
+    // training workload is the user's business and not part of the key
+    uint64_t h = build_hash(flags_hash(plan->cflags), code, len);
+    char dir[FILENAME_MAX], path[FILENAME_MAX + 32], bin[FILENAME_MAX + 32];
+    snprintf(dir, sizeof(dir), "%s%spgo-%016llx", cache, PATH_SEPARATOR, (unsigned long long)h);
+    snprintf(path, sizeof(path), "%s%sprog.c", dir, PATH_SEPARATOR);
+    if (!ensure_dir(dir) || (!file_exists(path) && !write_file(path, code, len))) {
+        perror("write profile directory");
+        free(code);
+        return 2;
+    }
+    free(code);
+
+    char flags[sizeof(plan->cflags) + 128];
+    int rc;
+    snprintf(path, sizeof(path), "%s%sprog.gcda", dir, PATH_SEPARATOR);
+    if (!file_exists(path)) {
+        snprintf(bin, sizeof(bin), "%s%sprog-instrumented", dir, PATH_SEPARATOR);
+        char ldflags[sizeof(plan->ldflags) + 64];
+        snprintf(flags, sizeof(flags), "%s -fprofile-generate -fprofile-update=atomic", plan->cflags);
+        snprintf(ldflags, sizeof(ldflags), "%s -fprofile-generate", plan->ldflags);
+        if ((rc = pgo_compile(dir, flags, ldflags, bin)) != 0) return rc;
+
+        fprintf(stderr, "Training %s...\n", outPath);
+        rc = pgo_train(bin, train, train_input);
+        unlink(bin);
+        if (rc != 0) fprintf(stderr, "Warning: training run exited with rc=%d\n", rc);
+        if (!file_exists(path)) fprintf(stderr, "Warning: training produced no profile; building without it\n");
+    }
+
+    snprintf(flags, sizeof(flags), "%s -fprofile-use -fprofile-correction -Wno-missing-profile", plan->cflags);
+    return pgo_compile(dir, flags, plan->ldflags, outPath);
+}
+
+#ifdef JAWA_WITH_TCC
+// Runtime functions the generated code links against; in memory they
+// resolve to jawa's own copies instead of the obj/*.o runtime
+static const struct {
+    const char *name;
+    const void *addr;
+} runtime_symbols[] = {
+    { "file_buka", (const void *)file_buka },
+    { "file_tutup", (const void *)file_tutup },
+    { "file_waca_kabeh", (const void *)file_waca_kabeh },
+    { "file_waca_baris", (const void *)file_waca_baris },
+    { "file_tulis", (const void *)file_tulis },
+    { "file_tulis_baris", (const void *)file_tulis_baris },
+    { "file_akhir", (const void *)file_akhir },
+    { "file_info", (const void *)file_info },
+    { "file_ada", (const void *)file_ada },
+    { "file_hapus", (const void *)file_hapus },
+    { "file_ubah_nama", (const void *)file_ubah_nama },
+    { "file_ubah_posisi", (const void *)file_ubah_posisi },
+    { "file_posisi", (const void *)file_posisi },
+    { "file_waca_bytes", (const void *)file_waca_bytes },
+    { "file_error_message", (const void *)file_error_message },
+    { "file_bisa_dibaca", (const void *)file_bisa_dibaca },
+    { "file_bisa_ditulis", (const void *)file_bisa_ditulis },
+    { "file_buat_direktori", (const void *)file_buat_direktori },
+    { "file_adalah_direktori", (const void *)file_adalah_direktori },
+    { "file_list_direktori", (const void *)file_list_direktori },
+    { "string_golek", (const void *)string_golek },
+    { "string_huruf_gedhe", (const void *)string_huruf_gedhe },
+    { "string_huruf_cilik", (const void *)string_huruf_cilik },
+    { "string_huruf_cilik_dawane", (const void *)string_huruf_cilik_dawane },
+    { "string_utf8_chars", (const void *)string_utf8_chars },
+    { "string_utf8_offset", (const void *)string_utf8_offset },
+    { "string_tulis_int", (const void *)string_tulis_int },
+    { "string_tulis_double", (const void *)string_tulis_double },
+    { "string_maca_int", (const void *)string_maca_int },
+    { "string_maca_double", (const void *)string_maca_double },
+    { "string_arena_dup", (const void *)string_arena_dup },
+    { "cithak_tulis", (const void *)cithak_tulis },
+    { "cithak_format", (const void *)cithak_format },
+    { "cithak_flush", (const void *)cithak_flush },
+    { "paralel_kanggo", (const void *)paralel_kanggo },
+    { "tugas_mulai", (const void *)tugas_mulai },
+    { "tugas_tunggu", (const void *)tugas_tunggu },
+    { "tugas_lali", (const void *)tugas_lali },
+    { "kanal_anyar", (const void *)kanal_anyar },
+    { "kanal_kirim", (const void *)kanal_kirim },
+    { "kanal_tampa", (const void *)kanal_tampa },
+    { "kanal_tutup", (const void *)kanal_tutup },
+    { "memo_anyar", (const void *)memo_anyar },
+    { "memo_golek", (const void *)memo_golek },
+    { "memo_simpen", (const void *)memo_simpen },
+};
+
+int build_plan_run(BuildPlan *plan, int argc, char **argv) {
+    size_t len;
+    char *code = plan_source(plan, &len);
+    if (!code) return 2;
+
+    TCCState *s = tcc_new();
+    if (!s) {
+        free(code);
+        return 2;
+    }
+    tcc_set_output_type(s, TCC_OUTPUT_MEMORY);
+    int rc = tcc_compile_string(s, code);
+    free(code);
+    if (rc == -1) {
+        tcc_delete(s);
+        return 3;
+    }
+
+    for (size_t i = 0; i < sizeof(runtime_symbols) / sizeof(runtime_symbols[0]); i++) {
+        tcc_add_symbol(s, runtime_symbols[i].name, runtime_symbols[i].addr);
+    }
+
+#ifdef TCC_RELOCATE_AUTO
+    rc = tcc_relocate(s, TCC_RELOCATE_AUTO);
+#else
+    rc = tcc_relocate(s);
+#endif
+    int (*entry)(int, char **) = rc < 0 ? NULL : (int (*)(int, char **))tcc_get_symbol(s, "main");
+    if (!entry) {
+        fprintf(stderr, "Failed to load generated program\n");
+        tcc_delete(s);
+        return 3;
+    }
+
+    rc = entry(argc, argv);
+    // Tasks still run code from this state: finish them before deleting it
+    tugas_entekke();
+    cithak_flush();
+    tcc_delete(s);
+    return rc;
+}
+#endif
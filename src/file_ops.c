@@ -1,5 +1,8 @@
 #include "file_ops.h"
 #include "string_ops.h"
+#include "output.h"
+#include "tugas.h"
+#include "statistik.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -65,7 +68,11 @@ JawaFile* file_buka(const char *path, const char *mode) {
     }
     
     const char *c_mode = convert_mode(mode);
+    STATISTIK_PANGGIL(STAT_FILE_BUKA);
+    // Operasi disk bisa lama: worker tugas lain mengambil alih selama menunggu
+    tugas_blokir_mulai();
     FILE *f = fopen(path, c_mode);
+    tugas_blokir_rampung();
     
     JawaFile *jf = malloc(sizeof(JawaFile));
     if (!jf) {
@@ -78,6 +85,11 @@ JawaFile* file_buka(const char *path, const char *mode) {
     jf->mode = strdup(mode);
     jf->path = strdup(path);
     jf->is_open = (f != NULL);
+    jf->interaktif = false;
+    if (f) {
+        struct stat st;
+        jf->interaktif = fstat(fileno(f), &st) == 0 && !S_ISREG(st.st_mode);
+    }
     jf->last_error = jf->is_open ? FILE_OK : FILE_NOT_FOUND;
     jf->error_message = NULL;
     
@@ -130,6 +142,7 @@ char* file_waca_kabeh(JawaFile *jf) {
     }
     
     FILE *f = (FILE*)jf->file;
+    if (jf->interaktif) cithak_flush();  // prompt harus tampil dulu
     
     // Simpan posisi saat ini
     long current_pos = ftell(f);
@@ -154,8 +167,12 @@ char* file_waca_kabeh(JawaFile *jf) {
     }
     
     // Baca file
+    tugas_blokir_mulai();
     size_t read_size = fread(buffer, 1, size, f);
+    tugas_blokir_rampung();
     buffer[read_size] = '\0';
+    STATISTIK_PANGGIL(STAT_FILE_WACA);
+    STATISTIK_BAIT(STAT_FILE_WACA, read_size);
     
     // Kembalikan ke posisi semula
     fseek(f, current_pos, SEEK_SET);
@@ -173,11 +190,17 @@ char* file_waca_baris(JawaFile *jf) {
     }
     
     FILE *f = (FILE*)jf->file;
+    if (jf->interaktif) cithak_flush();  // prompt harus tampil dulu
     
     char buffer[4096]; // Use a larger buffer
-    if (fgets(buffer, sizeof(buffer), f)) {
+    tugas_blokir_mulai();
+    char *got = fgets(buffer, sizeof(buffer), f);
+    tugas_blokir_rampung();
+    if (got) {
         // Hapus newline jika ada
         size_t len = strlen(buffer);
+        STATISTIK_PANGGIL(STAT_FILE_WACA);
+        STATISTIK_BAIT(STAT_FILE_WACA, len);
         if (len > 0 && buffer[len-1] == '\n') {
             buffer[len-1] = '\0';
             // Also remove \r if present (for Windows files)
@@ -210,14 +233,18 @@ int file_tulis(JawaFile *jf, const char *text) {
     }
     
     FILE *f = (FILE*)jf->file;
+    tugas_blokir_mulai();
     int result = fputs(text, f);
+    if (result >= 0) fflush(f);
+    tugas_blokir_rampung();
+    STATISTIK_PANGGIL(STAT_FILE_TULIS);
+    STATISTIK_BAIT(STAT_FILE_TULIS, strlen(text));
     
     if (result < 0) {
         set_file_error(jf, FILE_UNKNOWN_ERROR, "Error writing to file");
         return 0;
     }
-    
-    fflush(f);
+
     return 1; // Success
 }
 
@@ -236,14 +263,18 @@ int file_tulis_baris(JawaFile *jf, const char *text) {
     }
     
     FILE *f = (FILE*)jf->file;
+    tugas_blokir_mulai();
     int result = fprintf(f, "%s\n", text);
+    if (result >= 0) fflush(f);
+    tugas_blokir_rampung();
+    STATISTIK_PANGGIL(STAT_FILE_TULIS);
+    STATISTIK_BAIT(STAT_FILE_TULIS, strlen(text) + 1);
     
     if (result < 0) {
         set_file_error(jf, FILE_UNKNOWN_ERROR, "Error writing line to file");
         return 0;
     }
-    
-    fflush(f);
+
     return 1; // Success
 }
 
@@ -320,6 +351,7 @@ char* file_waca_bytes(JawaFile *jf, size_t bytes) {
     }
     
     FILE *f = (FILE*)jf->file;
+    if (jf->interaktif) cithak_flush();  // prompt harus tampil dulu
     
     // Alokasi buffer
     char *buffer = malloc(bytes + 1);
@@ -329,8 +361,12 @@ char* file_waca_bytes(JawaFile *jf, size_t bytes) {
     }
     
     // Baca bytes
+    tugas_blokir_mulai();
     size_t read_size = fread(buffer, 1, bytes, f);
+    tugas_blokir_rampung();
     buffer[read_size] = '\0';
+    STATISTIK_PANGGIL(STAT_FILE_WACA);
+    STATISTIK_BAIT(STAT_FILE_WACA, read_size);
     
     return buffer;
 }
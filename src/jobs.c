@@ -0,0 +1,257 @@
+#include "jobs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
+
+int jobs_default_count(void) {
+    const char *env = getenv("JAWA_JOBS");
+    if (env && atoi(env) > 0) return atoi(env);
+#if defined(_WIN32)
+    return 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
+
+#ifdef _WIN32
+int jobs_start_server(int n) {
+    (void)n;
+    return 0;
+}
+
+int jobs_run(char *const cmds[], int count, int max_jobs, int *status) {
+    int failed = 0;
+    (void)max_jobs;
+    for (int i = 0; i < count; i++) {
+        status[i] = system(cmds[i]);
+        if (status[i] != 0) failed++;
+    }
+    return failed;
+}
+
+int jobs_run_fn(int count, int max_jobs, int (*fn)(int index, void *arg), void *arg, int *status) {
+    int failed = 0;
+    (void)max_jobs;
+    for (int i = 0; i < count; i++) {
+        status[i] = fn(i, arg);
+        if (status[i] != 0) failed++;
+    }
+    return failed;
+}
+#else
+
+// GNU make jobserver client. Every process owns one implicit job slot;
+// each further concurrent job needs a token byte read from the shared
+// pipe, which goes back when the job ends.
+static struct {
+    bool checked;
+    bool active;
+    int rfd;      // non-blocking descriptor for taking tokens
+    int wfd;      // descriptor for returning them
+} g_jobserver = { false, false, -1, -1 };
+
+// Open our own file description for the read side, so non-blocking reads
+// do not change the mode of the pipe make and its other children use.
+static int open_nonblocking(const char *path) {
+    return open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+}
+
+static void jobserver_init(void) {
+    if (g_jobserver.checked) return;
+    g_jobserver.checked = true;
+
+    const char *flags = getenv("MAKEFLAGS");
+    if (!flags) return;
+
+    // The last --jobserver-auth wins; older makes spell it --jobserver-fds
+    const char *auth = NULL;
+    for (const char *p = flags; (p = strstr(p, "--jobserver-")) != NULL; p++) {
+        if (strncmp(p, "--jobserver-auth=", 17) == 0) auth = p + 17;
+        else if (strncmp(p, "--jobserver-fds=", 16) == 0) auth = p + 16;
+    }
+    if (!auth) return;
+
+    if (strncmp(auth, "fifo:", 5) == 0) {
+        char path[512];
+        int i = 0;
+        auth += 5;
+        while (auth[i] && auth[i] != ' ' && i < (int)sizeof(path) - 1) {
+            path[i] = auth[i];
+            i++;
+        }
+        path[i] = 0;
+        g_jobserver.rfd = open_nonblocking(path);
+        g_jobserver.wfd = open(path, O_WRONLY | O_CLOEXEC);
+    } else {
+        int r, w;
+        if (sscanf(auth, "%d,%d", &r, &w) != 2 || r < 0 || w < 0) return;
+        if (fcntl(r, F_GETFD) == -1 || fcntl(w, F_GETFD) == -1) return;  // not passed to us
+        char path[64];
+        snprintf(path, sizeof(path), "/proc/self/fd/%d", r);
+        g_jobserver.rfd = open_nonblocking(path);
+        g_jobserver.wfd = w;
+    }
+    if (g_jobserver.rfd < 0 || g_jobserver.wfd < 0) {
+        // Cannot read tokens safely: stay within our implicit slot
+        fprintf(stderr, "jawa: jobserver unavailable, building serially\n");
+        g_jobserver.rfd = -1;
+        g_jobserver.wfd = -1;
+        g_jobserver.active = true;
+        return;
+    }
+    g_jobserver.active = true;
+}
+
+int jobs_start_server(int n) {
+    jobserver_init();
+    if (g_jobserver.active || n < 2) return 0;
+
+    int fds[2];
+    if (pipe(fds) != 0) return -1;
+    for (int i = 0; i < n - 1; i++) {
+        if (write(fds[1], "+", 1) != 1) break;
+    }
+    g_jobserver.rfd = fds[0];
+    g_jobserver.wfd = fds[1];
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    g_jobserver.active = true;
+
+    // Child jawa processes (and make, if they run it) share the same pool
+    char flags[128];
+    snprintf(flags, sizeof(flags), "-j%d --jobserver-auth=%d,%d", n, fds[0], fds[1]);
+    setenv("MAKEFLAGS", flags, 1);
+    return 0;
+}
+
+// Returns the token byte, or -1 if none is free right now
+static int token_take(void) {
+    if (g_jobserver.rfd < 0) return -1;
+    unsigned char c;
+    if (read(g_jobserver.rfd, &c, 1) == 1) return c;
+    return -1;
+}
+
+static void token_give(int c) {
+    if (c < 0 || g_jobserver.wfd < 0) return;
+    unsigned char b = (unsigned char)c;
+    while (write(g_jobserver.wfd, &b, 1) < 0 && errno == EINTR) {}
+}
+
+// Shared scheduler: start() launches job i and returns its pid
+static int run_jobs(int count, int max_jobs, pid_t (*start)(int index, void *arg), void *arg, int *status) {
+    int failed = 0;
+    int next = 0;
+    int running = 0;
+    pid_t *pids = calloc(count > 0 ? count : 1, sizeof(pid_t));
+    int *tokens = calloc(count > 0 ? count : 1, sizeof(int));
+    if (!pids || !tokens) {
+        free(pids);
+        free(tokens);
+        return count;
+    }
+    if (max_jobs < 1) max_jobs = 1;
+    jobserver_init();
+
+    while (next < count || running > 0) {
+        // Start as many jobs as the limit (and the jobserver) allows
+        while (running < max_jobs && next < count) {
+            int token = -1;
+            if (running > 0 && g_jobserver.active) {
+                token = token_take();
+                if (token < 0) break;
+            }
+            fflush(NULL);
+            pid_t pid = start(next, arg);
+            if (pid < 0) {
+                token_give(token);
+                if (running > 0) break;   // retry once something finishes
+                status[next] = 127;
+                failed++;
+                next++;
+                continue;
+            }
+            tokens[next] = token;
+            pids[next++] = pid;
+            running++;
+        }
+        if (running == 0) break;
+
+        int wstatus;
+        pid_t done;
+        if (g_jobserver.active && g_jobserver.rfd >= 0 && next < count && running < max_jobs) {
+            // Waiting for a token as well as a child: poll both
+            done = waitpid(-1, &wstatus, WNOHANG);
+            if (done == 0) {
+                struct pollfd pfd = { g_jobserver.rfd, POLLIN, 0 };
+                poll(&pfd, 1, 20);
+                continue;
+            }
+        } else {
+            done = wait(&wstatus);
+        }
+        if (done < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (int i = 0; i < next; i++) {
+            if (pids[i] != done) continue;
+            pids[i] = 0;
+            status[i] = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : 128;
+            if (status[i] != 0) failed++;
+            token_give(tokens[i]);
+            running--;
+            break;
+        }
+    }
+
+    free(pids);
+    free(tokens);
+    return failed;
+}
+
+static pid_t start_command(int index, void *arg) {
+    char *const *cmds = arg;
+    pid_t pid = fork();
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", cmds[index], (char *)NULL);
+        _exit(127);
+    }
+    return pid;
+}
+
+int jobs_run(char *const cmds[], int count, int max_jobs, int *status) {
+    return run_jobs(count, max_jobs, start_command, (void *)cmds, status);
+}
+
+typedef struct {
+    int (*fn)(int index, void *arg);
+    void *arg;
+} FnJob;
+
+static pid_t start_fn(int index, void *arg) {
+    FnJob *job = arg;
+    pid_t pid = fork();
+    if (pid == 0) {
+        int rc = job->fn(index, job->arg);
+        fflush(NULL);
+        _exit(rc);
+    }
+    return pid;
+}
+
+int jobs_run_fn(int count, int max_jobs, int (*fn)(int index, void *arg), void *arg, int *status) {
+    FnJob job = { fn, arg };
+    return run_jobs(count, max_jobs, start_fn, &job, status);
+}
+#endif
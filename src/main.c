@@ -1,17 +1,175 @@
 #include <stdio.h>
+#include <stdbool.h>
 #include <string.h>
 #include <stdlib.h>  // For system() function
 #include "native.h"
 #include "package_manager.h"
+#include "jobs.h"
 
 #define JAWA_VERSION "0.3"
 
+// Input/output pairs for a multi-file build
+typedef struct {
+    char **inputs;
+    char **outputs;
+    int count;
+    int capacity;
+    BuildOptions opts;
+} BuildList;
+
+static void build_list_add(BuildList *list, const char *input, const char *output) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->inputs = realloc(list->inputs, list->capacity * sizeof(char *));
+        list->outputs = realloc(list->outputs, list->capacity * sizeof(char *));
+    }
+    list->inputs[list->count] = strdup(input);
+    if (output) {
+        list->outputs[list->count] = strdup(output);
+    } else {
+        // a.jw -> a, anything else -> name.bin
+        size_t len = strlen(input);
+        char *out = malloc(len + 5);
+        strcpy(out, input);
+        if (len > 3 && strcmp(input + len - 3, ".jw") == 0) out[len - 3] = 0;
+        else strcat(out, ".bin");
+        list->outputs[list->count] = out;
+    }
+    list->count++;
+}
+
+// Manifest: one "input.jw [output]" per line, '#' starts a comment
+static int read_manifest(const char *path, BuildList *list) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = 0;
+        char input[512], output[512];
+        int n = sscanf(line, "%511s %511s", input, output);
+        if (n >= 1) build_list_add(list, input, n == 2 ? output : NULL);
+    }
+    fclose(f);
+    return 0;
+}
+
+static int build_one(int index, void *arg) {
+    BuildList *list = arg;
+    int rc = build_native_with(list->inputs[index], list->outputs[index], &list->opts);
+    if (rc != 0) fprintf(stderr, "Gagal build %s (rc=%d)\n", list->inputs[index], rc);
+    return rc;
+}
+
+// Take --release, --pgo, -g, --stats, --train CMD and --train-input FILE out of argv;
+// returns the number of arguments left
+static int parse_build_options(int argc, char **argv, BuildOptions *opts) {
+    int n = 2;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--release") == 0) {
+            opts->release = true;
+        } else if (strcmp(argv[i], "--pgo") == 0) {
+            opts->pgo = true;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            opts->debug = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            opts->stats = true;
+        } else if (strcmp(argv[i], "--train") == 0 && i + 1 < argc) {
+            opts->train = argv[++i];
+            opts->pgo = true;
+        } else if (strcmp(argv[i], "--train-input") == 0 && i + 1 < argc) {
+            opts->train_input = argv[++i];
+            opts->pgo = true;
+        } else {
+            argv[n++] = argv[i];
+        }
+    }
+    argv[n] = NULL;
+    return n;
+}
+
+// jawa build [-j N] [-f manifest] a.jw b.jw ...
+static int build_many(int argc, char **argv, const BuildOptions *opts) {
+    BuildList list = {0};
+    list.opts = *opts;
+    int jobs = 0;
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "-j", 2) == 0) {
+            const char *n = argv[i][2] ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : "0");
+            jobs = atoi(n);
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            if (read_manifest(argv[++i], &list) != 0) return 1;
+        } else {
+            build_list_add(&list, argv[i], NULL);
+        }
+    }
+    if (list.count == 0) {
+        fprintf(stderr, "build mode needs input files\n");
+        return 1;
+    }
+    if (jobs <= 0) jobs = jobs_default_count();
+
+    // Files and their C compiles draw from one pool of job slots
+    jobs_start_server(jobs);
+    int *status = calloc(list.count, sizeof(int));
+    int failed = jobs_run_fn(list.count, jobs, build_one, &list, status);
+    if (failed) fprintf(stderr, "%d dari %d file gagal dibuild\n", failed, list.count);
+
+    for (int i = 0; i < list.count; i++) {
+        free(list.inputs[i]);
+        free(list.outputs[i]);
+    }
+    free(list.inputs);
+    free(list.outputs);
+    free(status);
+    return failed ? 3 : 0;
+}
+
+// jawa profile [-o out.folded] [--hz N] script.jw [args...]
+static int profile_command(int argc, char **argv) {
+    const char *folded = NULL;
+    int hz = 0;
+    int i = 2;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) folded = argv[++i];
+        else if (strcmp(argv[i], "--hz") == 0 && i + 1 < argc) hz = atoi(argv[++i]);
+        else break;
+    }
+    if (i >= argc) {
+        fprintf(stderr, "profile mode needs an input file\n");
+        return 1;
+    }
+
+    // script.jw -> script.folded
+    char path[FILENAME_MAX];
+    if (!folded) {
+        snprintf(path, sizeof(path), "%s", argv[i]);
+        size_t len = strlen(path);
+        if (len > 3 && strcmp(path + len - 3, ".jw") == 0) path[len - 3] = 0;
+        len = strlen(path);
+        snprintf(path + len, sizeof(path) - len, ".folded");
+        folded = path;
+    }
+    return profile_native(argv[i], folded, hz, argc - i, argv + i);
+}
+
 int main(int argc, char **argv) {
     if (argc < 2) {
         printf("Jawa Programming Language v%s\n", JAWA_VERSION);
         printf("Usage:\n");
         printf("  %s build input.jw output_bin    - Kompilasi file .jw ke biner\n", argv[0]);
+        printf("  %s build [-j N] [-f daftar] a.jw b.jw ... - Kompilasi banyak file paralel\n", argv[0]);
+        printf("      --release                  - Optimasi -O3 -march=native -flto\n");
+        printf("      --pgo [--train \"cmd {}\" | --train-input berkas]\n");
+        printf("                                 - Build berpandu profil: latih lalu build ulang\n");
+        printf("      -g                         - Info debug dengan nomor baris .jw\n");
+        printf("      --stats                    - Cacah panggilan builtin, JSON ke $JAWA_STATS/stderr\n");
         printf("  %s mlayu input.jw                 - Jalankan file .jw tanpa kompilasi\n", argv[0]);
+        printf("  %s profile [-o berkas.folded] [--hz N] input.jw [argumen]\n", argv[0]);
+        printf("                                 - Jalankan dengan profiler, laporan per baris/fungsi\n");
         printf("  %s paket <perintah> [argumen]   - Kelola paket Jawa\n", argv[0]);
         printf("  %s version                      - Tampilkan versi\n", argv[0]);
         return 1;
@@ -23,43 +181,40 @@ int main(int argc, char **argv) {
     }
     
     if (strcmp(argv[1], "paket") == 0) {
-        return handle_paket_command(argc, argv);
+        return handle_paket_command(argc, argv) ? 0 : 1;
     }
     
     if (argc < 3) {
         printf("Jawa Programming Language v%s\n", JAWA_VERSION);
         printf("Usage:\n");
         printf("  %s build input.jw output_bin    - Kompilasi file .jw ke biner\n", argv[0]);
+        printf("  %s build [-j N] [-f daftar] a.jw b.jw ... - Kompilasi banyak file paralel\n", argv[0]);
+        printf("      --release                  - Optimasi -O3 -march=native -flto\n");
+        printf("      --pgo [--train \"cmd {}\" | --train-input berkas]\n");
+        printf("                                 - Build berpandu profil: latih lalu build ulang\n");
+        printf("      -g                         - Info debug dengan nomor baris .jw\n");
+        printf("      --stats                    - Cacah panggilan builtin, JSON ke $JAWA_STATS/stderr\n");
         printf("  %s mlayu input.jw                 - Jalankan file .jw tanpa kompilasi\n", argv[0]);
+        printf("  %s profile [-o berkas.folded] [--hz N] input.jw [argumen]\n", argv[0]);
+        printf("                                 - Jalankan dengan profiler, laporan per baris/fungsi\n");
         printf("  %s paket <perintah> [argumen]   - Kelola paket Jawa\n", argv[0]);
         printf("  %s version                      - Tampilkan versi\n", argv[0]);
         return 1;
     }
     
     if (strcmp(argv[1], "build") == 0) {
-        if (argc != 4) { fprintf(stderr, "build mode needs input & output\n"); return 1; }
-        int rc = build_native(argv[2], argv[3]);
+        BuildOptions opts = {0};
+        argc = parse_build_options(argc, argv, &opts);
+        // Classic form is "build in.jw out"; anything else is a batch build
+        bool single = argc == 4 && argv[2][0] != '-' && argv[3][0] != '-' &&
+                      !(strlen(argv[3]) > 3 && strcmp(argv[3] + strlen(argv[3]) - 3, ".jw") == 0);
+        if (!single) return build_many(argc, argv, &opts);
+        int rc = build_native_with(argv[2], argv[3], &opts);
         return rc;
     } else if (strcmp(argv[1], "mlayu") == 0) {
-        // Implementasi sederhana untuk menjalankan file langsung
-        char temp_out[256];
-        sprintf(temp_out, "%s.temp.bin", argv[2]);
-        
-        int rc = build_native(argv[2], temp_out);
-        if (rc != 0) return rc;
-        
-        // Jalankan file yang sudah dibuild
-#ifdef _WIN32
-        system(temp_out);
-#else
-        char run_cmd[512];
-        sprintf(run_cmd, "./%s", temp_out);
-        system(run_cmd);
-#endif
-        
-        // Hapus file sementara
-        remove(temp_out);
-        return 0;
+        return run_native(argv[2], argc - 2, argv + 2);
+    } else if (strcmp(argv[1], "profile") == 0) {
+        return profile_command(argc, argv);
     } else {
         fprintf(stderr, "Unknown command\n");
         return 1;
@@ -0,0 +1,231 @@
+#include "memo.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define ARGUMEN_MAX 16
+#define EMBER_AWAL 64
+
+typedef struct MemoIsi {
+    uint64_t hash;
+    struct MemoIsi* sabanjure;          // rantai ember
+    struct MemoIsi* ngarep;             // LRU: lebih baru dipakai
+    struct MemoIsi* mburi;              // LRU: lebih lama
+    JawaNilai asil;
+    JawaNilai kunci[];                  // salinan string kunci menyusul
+} MemoIsi;
+
+struct JawaMemo {
+    int argc;
+    char jenis[ARGUMEN_MAX];
+    size_t ukuran;
+    size_t cacah;
+    MemoIsi** ember;
+    size_t ember_cacah;                 // pangkat dua
+    MemoIsi* anyar;                     // paling baru dipakai
+    MemoIsi* lawas;                     // dibuang lebih dulu
+    int aman;
+#ifndef _WIN32
+    pthread_mutex_t kunci;
+#endif
+};
+
+JawaMemo* memo_anyar(const char* jenis, long long ukuran, int aman) {
+    size_t argc = jenis ? strlen(jenis) : 0;
+    if (argc > ARGUMEN_MAX) return NULL;
+    JawaMemo* m = calloc(1, sizeof(JawaMemo));
+    if (!m) return NULL;
+    m->argc = (int)argc;
+    memcpy(m->jenis, jenis, argc);
+    m->ukuran = ukuran > 0 ? (size_t)ukuran : MEMO_UKURAN;
+    m->ember_cacah = EMBER_AWAL;
+    m->ember = calloc(m->ember_cacah, sizeof(MemoIsi*));
+    if (!m->ember) {
+        free(m);
+        return NULL;
+    }
+    m->aman = aman;
+#ifndef _WIN32
+    if (aman) pthread_mutex_init(&m->kunci, NULL);
+#endif
+    return m;
+}
+
+static void kunci_mlebu(JawaMemo* m) {
+#ifndef _WIN32
+    if (m->aman) pthread_mutex_lock(&m->kunci);
+#else
+    (void)m;
+#endif
+}
+
+static void kunci_metu(JawaMemo* m) {
+#ifndef _WIN32
+    if (m->aman) pthread_mutex_unlock(&m->kunci);
+#else
+    (void)m;
+#endif
+}
+
+static uint64_t campur(uint64_t h, uint64_t x) {
+    h ^= x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+static uint64_t hash_kunci(const JawaMemo* m, const JawaNilai* kunci) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (int i = 0; i < m->argc; i++) {
+        uint64_t x;
+        if (m->jenis[i] == 's') {
+            // FNV-1a isi string; NULL beda dengan ""
+            x = kunci[i].s ? 0xcbf29ce484222325ULL : 0;
+            for (const unsigned char* c = (const unsigned char*)kunci[i].s; c && *c; c++) {
+                x = (x ^ *c) * 0x100000001b3ULL;
+            }
+        } else if (m->jenis[i] == 'd') {
+            memcpy(&x, &kunci[i].d, sizeof(x));
+        } else {
+            x = (uint64_t)kunci[i].i;
+        }
+        h = campur(h, x);
+    }
+    // Finalizer splitmix64 supaya bit bawah (indeks ember) ikut teraduk
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    return h ^ (h >> 31);
+}
+
+static bool kunci_padha(const JawaMemo* m, const JawaNilai* a, const JawaNilai* b) {
+    for (int i = 0; i < m->argc; i++) {
+        if (m->jenis[i] == 's') {
+            if (!a[i].s || !b[i].s ? a[i].s != b[i].s : strcmp(a[i].s, b[i].s) != 0) return false;
+        } else if (m->jenis[i] == 'd') {
+            if (memcmp(&a[i].d, &b[i].d, sizeof(double)) != 0) return false;
+        } else if (a[i].i != b[i].i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static MemoIsi* golek_isi(JawaMemo* m, const JawaNilai* kunci, uint64_t hash) {
+    for (MemoIsi* e = m->ember[hash & (m->ember_cacah - 1)]; e; e = e->sabanjure) {
+        if (e->hash == hash && kunci_padha(m, e->kunci, kunci)) return e;
+    }
+    return NULL;
+}
+
+static void lru_copot(JawaMemo* m, MemoIsi* e) {
+    if (e->ngarep) e->ngarep->mburi = e->mburi;
+    else m->anyar = e->mburi;
+    if (e->mburi) e->mburi->ngarep = e->ngarep;
+    else m->lawas = e->ngarep;
+}
+
+static void lru_ngarep(JawaMemo* m, MemoIsi* e) {
+    e->ngarep = NULL;
+    e->mburi = m->anyar;
+    if (m->anyar) m->anyar->ngarep = e;
+    m->anyar = e;
+    if (!m->lawas) m->lawas = e;
+}
+
+static void buang_lawas(JawaMemo* m) {
+    MemoIsi* e = m->lawas;
+    if (!e) return;
+    lru_copot(m, e);
+    MemoIsi** p = &m->ember[e->hash & (m->ember_cacah - 1)];
+    while (*p != e) p = &(*p)->sabanjure;
+    *p = e->sabanjure;
+    m->cacah--;
+    free(e);
+}
+
+// Ember digandakan begitu isi lebih banyak dari ember
+static void ember_tambah(JawaMemo* m) {
+    size_t anyar_cacah = m->ember_cacah * 2;
+    MemoIsi** anyar = calloc(anyar_cacah, sizeof(MemoIsi*));
+    if (!anyar) return;
+    for (size_t i = 0; i < m->ember_cacah; i++) {
+        MemoIsi* e = m->ember[i];
+        while (e) {
+            MemoIsi* terus = e->sabanjure;
+            MemoIsi** p = &anyar[e->hash & (anyar_cacah - 1)];
+            e->sabanjure = *p;
+            *p = e;
+            e = terus;
+        }
+    }
+    free(m->ember);
+    m->ember = anyar;
+    m->ember_cacah = anyar_cacah;
+}
+
+bool memo_golek(JawaMemo* m, const JawaNilai* kunci, JawaNilai* asil) {
+    if (!m) return false;
+    uint64_t hash = hash_kunci(m, kunci);
+    kunci_mlebu(m);
+    MemoIsi* e = golek_isi(m, kunci, hash);
+    if (e) {
+        *asil = e->asil;
+        if (e != m->anyar) {
+            lru_copot(m, e);
+            lru_ngarep(m, e);
+        }
+    }
+    kunci_metu(m);
+    return e != NULL;
+}
+
+void memo_simpen(JawaMemo* m, const JawaNilai* kunci, JawaNilai asil) {
+    if (!m) return;
+    uint64_t hash = hash_kunci(m, kunci);
+
+    // Satu blok per isi: kunci, lalu salinan string kunci
+    size_t teks = 0;
+    for (int i = 0; i < m->argc; i++) {
+        if (m->jenis[i] == 's' && kunci[i].s) teks += strlen(kunci[i].s) + 1;
+    }
+    MemoIsi* e = malloc(sizeof(MemoIsi) + m->argc * sizeof(JawaNilai) + teks);
+    if (!e) return;
+    e->hash = hash;
+    e->asil = asil;
+    char* salin = (char*)(e->kunci + m->argc);
+    for (int i = 0; i < m->argc; i++) {
+        e->kunci[i] = kunci[i];
+        if (m->jenis[i] == 's' && kunci[i].s) {
+            size_t n = strlen(kunci[i].s) + 1;
+            memcpy(salin, kunci[i].s, n);
+            e->kunci[i].s = salin;
+            salin += n;
+        }
+    }
+
+    kunci_mlebu(m);
+    // Rekursi atau thread lain mungkin sudah menyimpan kunci yang sama
+    MemoIsi* lawas = golek_isi(m, kunci, hash);
+    if (lawas) {
+        lawas->asil = asil;
+        if (lawas != m->anyar) {
+            lru_copot(m, lawas);
+            lru_ngarep(m, lawas);
+        }
+        kunci_metu(m);
+        free(e);
+        return;
+    }
+    if (m->cacah >= m->ukuran) buang_lawas(m);
+    if (m->cacah >= m->ember_cacah) ember_tambah(m);
+    MemoIsi** p = &m->ember[hash & (m->ember_cacah - 1)];
+    e->sabanjure = *p;
+    *p = e;
+    lru_ngarep(m, e);
+    m->cacah++;
+    kunci_metu(m);
+}
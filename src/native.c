@@ -4,44 +4,107 @@
 #include <ctype.h>
 #include <unistd.h>
 #include <sys/stat.h>
+#ifndef _WIN32
+#include <sys/wait.h>
+#else
+#define strtok_r strtok_s
+#endif
 
 #include "lexer.h"
 #include "parser.h"
 #include "statements.h"
 #include "file_ops.h"
 #include "oop/class.h"
+#include "optimizer.h"
+#include "build.h"
+#include "native.h"
+#include "package_manager.h"
+#include "statistik.h"
 
 static void write_preamble(FILE *c) {
     fputs("#include <stdio.h>\n#include <stdint.h>\n#include <stdbool.h>\n", c);
     fputs("#include <string.h>\n#include <stdlib.h>\n#include <ctype.h>\n\n", c);
     
-    // Add string helper function
+    // Runtime state shared by all units, defined in the runtime unit
     fputs("// String helper functions\n", c);
-    fputs("char* str_dup(const char* s) {\n", c);
-    fputs("    if (!s) return NULL;\n", c);
-    fputs("    int len = strlen(s);\n", c);
-    fputs("    char* result = malloc(len + 1);\n", c);
-    fputs("    strcpy(result, s);\n", c);
-    fputs("    return result;\n", c);
-    fputs("}\n\n", c);
-    
-    // Add global variable for split operations  
-    fputs("int temp_count = 0;\n", c);
-    fputs("int debug_split_count = 0;\n\n", c);
+    fputs("char* str_dup(const char* s);\n\n", c);
     
     // Add string function prototypes
     fputs("// Built-in string functions\n", c);
     fputs("char* string_toUpperCase(const char* str);\n", c);
     fputs("char* string_toLowerCase(const char* str);\n", c);
+    fputs("char* string_toUpperCase_inplace(char* str);\n", c);
+    fputs("char* string_toLowerCase_inplace(char* str);\n", c);
+    fputs("size_t string_huruf_gedhe(char* dst, const char* src, size_t len);\n", c);
+    fputs("size_t string_huruf_cilik(char* dst, const char* src, size_t len);\n", c);
+    fputs("size_t string_huruf_cilik_dawane(const char* src, size_t len);\n", c);
     fputs("int string_length(const char* str);\n", c);
     fputs("char* string_substring(const char* str, int start, int end);\n", c);
     fputs("char* string_replace(const char* str, const char* old_str, const char* new_str);\n", c);
     fputs("int string_indexOf(const char* str, const char* search);\n", c);
+    fputs("const char* string_golek(const char* hay, size_t hay_len, const char* needle, size_t needle_len);\n", c);
+    fputs("size_t string_utf8_chars(const char* s, size_t len);\n", c);
+    fputs("size_t string_utf8_offset(const char* s, size_t len, size_t n);\n", c);
     fputs("char* string_concat(const char* a, const char* b);\n", c);
     fputs("char** string_split(const char* str, const char* delimiter, int* count);\n", c);
+    fputs("char** string_split_char(const char* str, char delimiter, int* count);\n", c);
+    fputs("char* string_replace_n(const char* str, const char* old_str, size_t old_len, const char* new_str, size_t new_len);\n", c);
+    fputs("bool string_ngandhut(const char* str, const char* needle);\n", c);
+    fputs("bool string_miwiti(const char* str, const char* prefix);\n", c);
+    fputs("bool string_mungkasi(const char* str, const char* suffix);\n", c);
+    fputs("char* string_ulang(const char* str, int count);\n", c);
+    fputs("char* string_ganti_banyak(const char* str, const char* const* finds, const char* const* replaces, int count);\n", c);
     fputs("char* int_to_string(int value);\n", c);
     fputs("char* long_to_string(long long value);\n", c);
-    fputs("char* double_to_string(double value);\n\n", c);
+    fputs("char* double_to_string(double value);\n", c);
+    fputs("int string_toInt(const char* str);\n", c);
+    fputs("double string_toDouble(const char* str);\n", c);
+    fputs("size_t string_tulis_int(char* buf, long long value);\n", c);
+    fputs("size_t string_tulis_double(char* buf, double value);\n", c);
+    fputs("bool string_maca_int(const char* s, size_t len, long long* out);\n", c);
+    fputs("bool string_maca_double(const char* s, size_t len, double* out);\n", c);
+    fputs("char* string_arena_dup(const char* s, size_t len);\n", c);
+    fputs("void tulis(const char* text);\n", c);
+    fputs("void cithak(const char* text);\n", c);
+    fputs("void cithak_tulis(const char* s, size_t len);\n", c);
+    fputs("void cithak_format(const char* pola, ...);\n", c);
+    fputs("void cithak_flush(void);\n\n", c);
+    
+    // Literal needle, prefix or suffix: len is a constant, so the compiler
+    // turns these into a strchr or an inline compare of len bytes
+    fputs("// Built-in string tests on literal arguments\n", c);
+    fputs("static inline bool string_ngandhut_n(const char* str, const char* needle, size_t len) {\n", c);
+    fputs("    if (!str) return false;\n", c);
+    fputs("    if (len == 1) return strchr(str, needle[0]) != NULL;\n", c);
+    fputs("    return string_golek(str, strlen(str), needle, len) != NULL;\n", c);
+    fputs("}\n", c);
+    fputs("static inline bool string_miwiti_n(const char* str, const char* prefix, size_t len) {\n", c);
+    fputs("    return str && strncmp(str, prefix, len) == 0;\n", c);
+    fputs("}\n", c);
+    fputs("static inline bool string_mungkasi_n(const char* str, const char* suffix, size_t len) {\n", c);
+    fputs("    size_t n = str ? strlen(str) : 0;\n", c);
+    fputs("    return str && n >= len && memcmp(str + n - len, suffix, len) == 0;\n", c);
+    fputs("}\n\n", c);
+    
+    // Tasks ("gawe async" / "tunggu"), channels and memo tables ("@cache")
+    fputs("// Built-in task functions\n", c);
+    fputs("typedef union { long long i; double d; const char* s; } JawaNilai;\n", c);
+    fputs("void paralel_kanggo(long long n, int benang, int dinamis, long long chunk,\n", c);
+    fputs("                    void (*fn)(long long, long long, void*, JawaNilai*), void* env, JawaNilai* hasil,\n", c);
+    fputs("                    const char* ops, const char* jenis);\n", c);
+    fputs("typedef struct JawaTugas JawaTugas;\n", c);
+    fputs("typedef struct JawaKanal JawaKanal;\n", c);
+    fputs("JawaTugas* tugas_mulai(void (*fn)(void*, JawaNilai*), void* arg);\n", c);
+    fputs("JawaNilai tugas_tunggu(JawaTugas** t);\n", c);
+    fputs("void tugas_lali(JawaTugas* t);\n", c);
+    fputs("JawaKanal* kanal_anyar(long long kapasitas);\n", c);
+    fputs("void kanal_kirim(JawaKanal* k, JawaNilai v);\n", c);
+    fputs("JawaNilai kanal_tampa(JawaKanal* k);\n", c);
+    fputs("void kanal_tutup(JawaKanal* k);\n", c);
+    fputs("typedef struct JawaMemo JawaMemo;\n", c);
+    fputs("JawaMemo* memo_anyar(const char* jenis, long long ukuran, int aman);\n", c);
+    fputs("bool memo_golek(JawaMemo* m, const JawaNilai* kunci, JawaNilai* asil);\n", c);
+    fputs("void memo_simpen(JawaMemo* m, const JawaNilai* kunci, JawaNilai asil);\n\n", c);
     
     // Add file operations function prototypes
     fputs("// Built-in file operations functions\n", c);
@@ -78,28 +141,33 @@ static void write_preamble(FILE *c) {
     fputs("JawaArray* create_array_literal(...);\n", c);
     fputs("JawaArray* create_array_literal_from_split(char** elements, int count);\n", c);
     fputs("char* array_get_string(JawaArray* arr, int index);\n", c);
-    fputs("int array_get_length(JawaArray* arr);\n\n", c);
+    fputs("int array_get_length(JawaArray* arr);\n", c);
+    fputs("char* string_gabung_daftar(JawaArray* arr, const char* delimiter);\n\n", c);
 }
 
+// Skip from the "bolo" line to the brace closing the class; the opening
+// brace may be on a later line
 static void skip_class_block(FILE *in, char *line, size_t line_size) {
     int class_brace_depth = 0;
+    bool opened = false;
     do {
         for (const char *c = line; *c; c++) {
-            if (*c == '{') class_brace_depth++;
+            if (*c == '{') { class_brace_depth++; opened = true; }
             if (*c == '}') class_brace_depth--;
         }
-        if (class_brace_depth <= 0) break;
+        if (opened && class_brace_depth <= 0) break;
     } while (fgets(line, line_size, in));
 }
 
-static void parse_classes(FILE *in, FILE *out) {
+static void parse_classes(FILE *in) {
     char line[512];
     JawaClass *current_class = NULL;
     bool in_class = false;
     bool in_method = false;
     char method_body[2048] = {0};
     int method_body_len = 0;
-    int brace_depth = 0;
+    int brace_depth = 0;         // 1 inside the class body, 2+ in a method
+    bool class_opened = false;
     
     // Method parsing state
     char current_method_name[64] = {0};
@@ -131,18 +199,23 @@ static void parse_classes(FILE *in, FILE *out) {
             current_class = class_create(class_name);
             in_class = true;
             brace_depth = 0;
+            for (const char *c = q; *c; c++) {
+                if (*c == '{') brace_depth++;
+                if (*c == '}') brace_depth--;
+            }
+            class_opened = brace_depth > 0;
             continue;
         }
         
         if (in_class && current_class) {
             // Count braces
             for (const char *c = p; *c; c++) {
-                if (*c == '{') brace_depth++;
+                if (*c == '{') { brace_depth++; class_opened = true; }
                 if (*c == '}') brace_depth--;
             }
             
             // Handle property declarations inside class
-            if (is_variable_declaration(p)) {
+            if (!in_method && is_variable_declaration(p)) {
                 // Parse property: owahi name: type = value
                 const char *q = p + (strncmp(p, "owahi", 5) == 0 ? 6 : 
                                     strncmp(p, "cendhak", 7) == 0 ? 8 : 5);
@@ -249,7 +322,7 @@ static void parse_classes(FILE *in, FILE *out) {
             
             // Collect method body
             if (in_method) {
-                if (brace_depth == 0 && strchr(p, '}')) {
+                if (brace_depth <= 1 && strchr(p, '}')) {
                     // End of method - process collected body
                     // For now, use simple method body with proper statement parsing later
                     // The method_body contains raw statements that need processing
@@ -283,23 +356,240 @@ static void parse_classes(FILE *in, FILE *out) {
             }
             
             // End of class
-            if (brace_depth == 0 && strchr(p, '}')) {
+            if (class_opened && brace_depth <= 0) {
                 in_class = false;
                 current_class = NULL;
             }
         }
     }
+}
+
+// #line directives: index where each line of in starts so the line of
+// any ftell position can be found; file is the name the directives carry
+static void source_lines_init(FILE *in, ParserContext *ctx, const char *file) {
+    size_t flen = strlen(file);
+    ctx->line_file = malloc(2 * flen + 3);
+    if (!ctx->line_file) return;
+    char *q = ctx->line_file;
+    *q++ = '"';
+    for (const char *c = file; *c; c++) {
+        if (*c == '"' || *c == '\\') *q++ = '\\';
+        *q++ = *c;
+    }
+    *q++ = '"';
+    *q = 0;
+
+    int cap = 256;
+    ctx->line_starts = malloc(cap * sizeof(long));
+    ctx->line_count = 0;
+    long pos = 0;
+    int ch;
+    bool at_start = true;
+    rewind(in);
+    while (ctx->line_starts && (ch = fgetc(in)) != EOF) {
+        if (at_start) {
+            if (ctx->line_count == cap) {
+                long *grown = realloc(ctx->line_starts, (cap *= 2) * sizeof(long));
+                if (!grown) break;
+                ctx->line_starts = grown;
+            }
+            ctx->line_starts[ctx->line_count++] = pos;
+        }
+        at_start = ch == '\n';
+        pos++;
+    }
+    rewind(in);
+}
+
+static void source_lines_free(ParserContext *ctx) {
+    free(ctx->line_file);
+    free(ctx->line_starts);
+    ctx->line_file = NULL;
+    ctx->line_starts = NULL;
+    ctx->line_count = 0;
+}
+
+// Line (from 1) of the source line just read, i.e. ending before pos
+static int source_line_at(const ParserContext *ctx, long pos) {
+    int lo = 0, hi = ctx->line_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (ctx->line_starts[mid] < pos) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo > 0 ? lo : 1;
+}
+
+static void emit_line_no(FILE *out, const ParserContext *ctx, int line) {
+    if (ctx->line_file && line > 0) fprintf(out, "#line %d %s\n", line, ctx->line_file);
+}
+
+// #line for the statement fgets just read from in
+static void emit_line(FILE *in, FILE *out, const ParserContext *ctx) {
+    if (ctx->line_file && ctx->line_starts) emit_line_no(out, ctx, source_line_at(ctx, ftell(in)));
+}
+
+// Prototypes go to the shared header (out); each function body becomes its own unit
+static const char *skip_ws(const char *p) {
+    while (p && *p && isspace((unsigned char)*p)) p++;
+    return p;
+}
+
+// The closing quote of the string literal opening at p, honouring \"
+// escapes; the last character of the line if it is unterminated
+static const char *skip_string(const char *p) {
+    for (p++; *p && *p != '"'; p++) {
+        if (*p == '\\' && p[1]) p++;
+    }
+    return *p ? p : p - 1;
+}
+
+// Net braces opened on a line, ignoring string literals and // comments
+static int brace_delta(const char *p) {
+    int delta = 0;
+    for (; *p; p++) {
+        if (*p == '"') p = skip_string(p);
+        else if (p[0] == '/' && p[1] == '/') break;
+        else if (*p == '{') delta++;
+        else if (*p == '}') delta--;
+    }
+    return delta;
+}
+
+// Skip a block whose opening brace is at or after `from` (a position in line),
+// reading further lines as needed. Returns the text after the matching '}'.
+static const char *skip_dead_block(FILE *in, const char *from, char *line, size_t line_size) {
+    int depth = 0;
+    bool opened = false;
+    const char *c = from;
+    for (;;) {
+        for (; *c; c++) {
+            if (*c == '"') c = skip_string(c);
+            else if (c[0] == '/' && c[1] == '/') break;
+            else if (*c == '{') { depth++; opened = true; }
+            else if (*c == '}' && opened && --depth == 0) return c + 1;
+        }
+        if (!fgets(line, line_size, in)) return NULL;
+        c = line;
+    }
+}
+
+// "yen" with a constant condition: only the arm that can run is emitted.
+// live holds the depths of always-true blocks whose "liyane" arms are
+// still to be dropped. Returns true when the line was handled here.
+typedef struct {
+    int depth[64];
+    int count;
+} LiveIf;
+
+static bool fold_constant_if(FILE *in, const char *p, char *line, size_t line_size, FILE *out,
+                             ParserContext *ctx, int *depth, LiveIf *live) {
+    // Closing brace of an always-true "yen": every "liyane" arm is dead
+    if (live->count > 0 && *p == '}' && *depth == live->depth[live->count - 1]) {
+        live->count--;
+        (*depth)--;
+        fputs("}\n", out);
+        const char *rest = skip_ws(p + 1);
+        while (rest && strncmp(rest, "liyane", 6) == 0) {
+            rest = skip_ws(skip_dead_block(in, rest, line, line_size));
+        }
+        return true;
+    }
     
-    // Generate all class code
-    generate_object_c_code(out);
+    if (!is_if_statement(p)) return false;
+    int cond = eval_if_condition(p, ctx);
+    if (cond == 1 && live->count < (int)(sizeof(live->depth) / sizeof(live->depth[0]))) {
+        fputs("{\n", out);
+        *depth += brace_delta(p);
+        live->depth[live->count++] = *depth;
+        return true;
+    }
+    if (cond != 0) return false;
+    const char *rest = skip_ws(skip_dead_block(in, p, line, line_size));
+    if (rest && strncmp(rest, "liyane", 6) == 0) {
+        rest = skip_ws(rest + 6);
+        if (*rest == '{') {
+            fputs("{\n", out);
+            (*depth)++;
+        } else if (is_if_statement(rest)) {
+            // "} liyane yen (...) {" continues as a plain "yen"
+            parse_if_statement(rest, out, ctx);
+            (*depth)++;
+        }
+    }
+    return true;
 }
 
-static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx) {
+static void parse_statement(const char *p, FILE *out, ParserContext *ctx);
+static int hoist_loop_invariants(FILE *in, const char *header, FILE *scratch, FILE *out, ParserContext *ctx);
+
+// Function bodies at most this many statements long, without blocks, are
+// defined "static inline" in the shared header so every unit can inline them
+#define INLINE_MAX_STATEMENTS 3
+
+typedef struct {
+    int statements;     // lines inside the body
+    bool blocks;        // nested yen/loop blocks
+    bool tail_call;     // "bali name(...)" with argc arguments (any if argc < 0)
+} FunctionShape;
+
+// Read the body following a "gawe" header without consuming it
+static FunctionShape scan_function(FILE *in, const char *header, const char *name, int argc) {
+    FunctionShape shape = {0, false, false};
+    long pos = ftell(in);
+    char line[512];
+    int depth = brace_delta(header);
+    bool opened = depth > 0;
+    while ((!opened || depth > 0) && fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+        if (len && (line[len-1]=='\n' || line[len-1]=='\r')) line[--len]=0;
+        const char *p = skip_ws(line);
+        if (!*p) continue;
+        int delta = brace_delta(p);
+        if (!opened) {
+            opened = delta > 0;
+            depth += delta;
+            continue;
+        }
+        if (depth + delta <= 0) break;
+        shape.statements++;
+        if (delta != 0 || depth > 1) shape.blocks = true;
+        int n = self_tail_call(p, name, NULL, 0);
+        if (n >= 0 && (argc < 0 || n == argc)) shape.tail_call = true;
+        depth += delta;
+    }
+    fseek(in, pos, SEEK_SET);
+    return shape;
+}
+
+// Small functions of the program itself; module functions are called
+// through their interface and keep a unit of their own
+static bool inline_function(FILE *in, const char *header, const char *name, bool inline_small) {
+    if (!inline_small) return false;
+    const char *n = skip_ws(header + 4);
+    if (strncmp(n, "async", 5) == 0 && isspace((unsigned char)n[5])) return false;
+    FunctionShape shape = scan_function(in, header, name, -1);
+    return shape.statements <= INLINE_MAX_STATEMENTS && !shape.blocks && !shape.tail_call;
+}
+
+static void parse_function_definitions(FILE *in, FILE *out, BuildPlan *plan, ParserContext *ctx,
+                                       bool inline_small) {
     char line[512];
     bool in_function = false;
     bool in_function_body = false;
+    int body_depth = 0;
     bool in_class = false;
     int class_brace_depth = 0;
+    FILE *fn = NULL;
+    bool fn_inline = false;
+    FILE *inlines = NULL;       // static inline definitions, appended to out
+    FILE *scratch = NULL;       // loop bodies translated for hoisting
+    int loop_depth[64];         // body depths of loops with hoisted temporaries
+    int loop_base[64];
+    int loop_count = 0;
+    LiveIf live = { .count = 0 };
+    char fn_name[64] = {0};
+    MemoSpec memo = {0};        // "@cache" seen, for the next "gawe"
     
     rewind(in);
     
@@ -322,10 +612,7 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
         
         if (in_class) {
             // Count braces in class
-            for (const char *c = p; *c; c++) {
-                if (*c == '{') class_brace_depth++;
-                if (*c == '}') class_brace_depth--;
-            }
+            class_brace_depth += brace_delta(p);
             
             if (class_brace_depth <= 0) {
                 in_class = false;
@@ -333,10 +620,20 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
             continue; // Skip everything inside class
         }
 
+        // "@cache" applies to the next function, "ajek" to the one it prefixes
+        const char *rest = memo_annotation(p, &memo, false);
+        if (rest && !*rest) continue;
+        if (rest) p = rest;
+
         if (strncmp(p, "gawe ", 5) == 0) {
             // Extract function name for prototype
             const char *name_start = p + 5;
             while (*name_start && isspace((unsigned char)*name_start)) name_start++;
+            bool is_async = strncmp(name_start, "async", 5) == 0 && isspace((unsigned char)name_start[5]);
+            if (is_async) {
+                name_start += 5;
+                while (*name_start && isspace((unsigned char)*name_start)) name_start++;
+            }
             
             char func_name[64];
             int i = 0;
@@ -348,6 +645,7 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
             // Parse return type if specified  
             const char *return_part = strchr(p, ')');
             const char *c_return_type = "double"; // default
+            Ty return_ty = TY_DOUBLE;
             if (return_part) {
                 return_part++; // Skip ')'
                 while (*return_part && isspace((unsigned char)*return_part)) return_part++;
@@ -355,15 +653,20 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
                     return_part++;
                     while (*return_part && isspace((unsigned char)*return_part)) return_part++;
                     
-                    if (strncmp(return_part, "string", 6) == 0) c_return_type = "const char*";
-                    else if (strncmp(return_part, "int", 3) == 0) c_return_type = "int";
-                    else if (strncmp(return_part, "bool", 4) == 0) c_return_type = "bool";
+                    if (strncmp(return_part, "string", 6) == 0) { c_return_type = "const char*"; return_ty = TY_STRING; }
+                    else if (strncmp(return_part, "int", 3) == 0) { c_return_type = "int"; return_ty = TY_INT; }
+                    else if (strncmp(return_part, "bool", 4) == 0) { c_return_type = "bool"; return_ty = TY_BOOL; }
                     else if (strncmp(return_part, "double", 6) == 0) c_return_type = "double";
                 }
             }
             
+            // Calls to an async function start a task instead
+            if (is_async) parser_add_async(ctx, func_name, return_ty);
+            
             // Default return type is double, default params are typed based on annotation
-            fprintf(out, "%s %s(", c_return_type, func_name);
+            char params[1024];
+            int pn = 0;
+            params[0] = 0;
             
             // Find parameter list
             const char *paren_start = strchr(p, '(');
@@ -385,7 +688,8 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
                     if (strlen(start) > 0) {
                         // Split by comma and generate typed params
                         char *param_copy = strdup(start);
-                        char *token = strtok(param_copy, ",");
+                        char *save = NULL;
+                        char *token = strtok_r(param_copy, ",", &save);
                         bool first = true;
                         while (token) {
                             // Trim token
@@ -393,7 +697,7 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
                             char *token_end = token + strlen(token) - 1;
                             while (token_end > token && isspace((unsigned char)*token_end)) *token_end-- = 0;
                             
-                            if (!first) fprintf(out, ", ");
+                            if (!first) sb_add(params, sizeof(params), &pn, ", ");
                             
                             // Parse parameter with type annotation: "name: type" or just "name"
                             char *colon = strchr(token, ':');
@@ -418,29 +722,34 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
                                     if (strncmp(type_start, "int", 3) == 0) c_type = "int";
                                     else if (strncmp(type_start, "string", 6) == 0) c_type = "const char*";
                                     else if (strncmp(type_start, "bool", 4) == 0) c_type = "bool";
+                                    else if (strncmp(type_start, "kanal", 5) == 0) c_type = "JawaKanal*";
+                                    else if (strncmp(type_start, "tugas", 5) == 0) c_type = "JawaTugas*";
                                     
-                                    fprintf(out, "%s %s", c_type, param_name);
+                                    sb_add(params, sizeof(params), &pn, "%s %s", c_type, param_name);
                                 }
                             } else {
                                 // No type annotation, default to double
-                                fprintf(out, "double %s", token);
+                                sb_add(params, sizeof(params), &pn, "double %s", token);
                             }
                             first = false;
                             
-                            token = strtok(NULL, ",");
+                            token = strtok_r(NULL, ",", &save);
                         }
                         free(param_copy);
                     }
                 }
             }
-            fprintf(out, ");\n");
+            // A memoized function keeps one table, so it is never inlined
+            bool inl = !memo.on && inline_function(in, p, func_name, inline_small);
+            fprintf(out, "%s%s %s(%s);\n", inl ? "static inline " : "", c_return_type, func_name, params);
+            if (is_async) fprintf(out, "JawaTugas* %s_async(%s);\n", func_name, params);
         }
+        memo.on = false;
     }
     fputs("\n", out);
     
     // Second pass: Generate function implementations
     rewind(in);
-    fputs("// Function implementations\n", out);
     in_class = false;
     class_brace_depth = 0;
     
@@ -461,10 +770,7 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
         
         if (in_class) {
             // Count braces in class
-            for (const char *c = p; *c; c++) {
-                if (*c == '{') class_brace_depth++;
-                if (*c == '}') class_brace_depth--;
-            }
+            class_brace_depth += brace_delta(p);
             
             if (class_brace_depth <= 0) {
                 in_class = false;
@@ -472,41 +778,599 @@ static void parse_function_definitions(FILE *in, FILE *out, ParserContext *ctx)
             continue; // Skip everything inside class
         }
 
+        if (!in_function) {
+            const char *rest = memo_annotation(p, &memo, true);
+            if (rest && !*rest) continue;
+            if (rest) p = rest;
+            if (memo.on && strncmp(p, "gawe ", 5) != 0) {
+                fprintf(stderr, "Warning: @cache is not followed by a gawe function\n");
+                memo.on = false;
+            }
+        }
+
         if (strncmp(p, "gawe ", 5) == 0) {
+            if (fn && !fn_inline) build_plan_add_unit(plan, fn_name, fn);
+            const char *n = p + 5;
+            while (*n && isspace((unsigned char)*n)) n++;
+            if (strncmp(n, "async", 5) == 0 && isspace((unsigned char)n[5])) {
+                n += 5;
+                while (*n && isspace((unsigned char)*n)) n++;
+            }
+            int i = snprintf(fn_name, sizeof(fn_name), "gawe_");
+            while (*n && *n != '(' && !isspace((unsigned char)*n) && i < (int)sizeof(fn_name) - 1) {
+                fn_name[i++] = *n++;
+            }
+            fn_name[i] = 0;
+            fn_inline = !memo.on && inline_function(in, p, fn_name + 5, inline_small);
+            ctx->fn_memo = memo;
+            memo.on = false;
+            if (fn_inline && !inlines) inlines = build_stream_open();
+            fn = fn_inline ? inlines : build_stream_open();
+            if (!fn) return;
             in_function = true;
-            parse_function_definition(p, out, ctx);
+            // The header already opens the body; "{" may end this line
+            body_depth = brace_delta(p);
+            in_function_body = body_depth > 0;
+            emit_line(in, fn, ctx);
+            if (fn_inline) fputs("static inline ", fn);
+            parse_function_definition(p, fn, ctx);
+            if (scan_function(in, p, ctx->fn_name, ctx->fn_param_count).tail_call) {
+                ctx->fn_tail_loop = true;
+                fputs("jawa_ulang:;\n", fn);
+            }
             continue;
         }
         
         if (in_function) {
-            if (strcmp(p, "{") == 0) {
-                in_function_body = true;
+            int delta = brace_delta(p);
+            if (!in_function_body) {
                 // Don't write extra {, function header already has it
+                body_depth = delta;
+                in_function_body = body_depth > 0;
                 continue;
-            } else if (strcmp(p, "}") == 0) {
+            } else if (body_depth + delta <= 0) {
                 in_function_body = false;
                 in_function = false;
-                fputs("}\n\n", out);
-            } else if (in_function_body) {
-                // Parse function body statements
-                if (is_variable_declaration(p)) {
-                    parse_variable_declaration(p, out, ctx);
-                } else if (is_print_statement(p)) {
-                    parse_print_statement(p, out, ctx);
-                } else if (is_return_statement(p)) {
-                    parse_return_statement(p, out, ctx);
-                } else if (is_assignment(p)) {
-                    parse_assignment(p, out, ctx);
-                } else if (is_standalone_function_call(p)) {
-                    parse_standalone_function_call(p, out, ctx);
+                ctx->fn_name[0] = 0;
+                ctx->fn_tail_loop = false;
+                ctx->hoist_count = 0;
+                loop_count = 0;
+                live.count = 0;
+                fputs("}\n\n", fn);
+                if (!fn_inline) build_plan_add_unit(plan, fn_name, fn);
+                fn = NULL;
+            } else if (fold_constant_if(in, p, line, sizeof(line), fn, ctx, &body_depth, &live)) {
+                continue;
+            } else {
+                // Parse function body statements, blocks included
+                if ((is_for_statement(p) || (is_while_statement(p) && strchr(p, '{'))) &&
+                    loop_count < (int)(sizeof(loop_depth) / sizeof(loop_depth[0]))) {
+                    if (!scratch) scratch = tmpfile();
+                    loop_base[loop_count] = hoist_loop_invariants(in, p, scratch, fn, ctx);
+                    loop_depth[loop_count++] = body_depth + 1;
+                }
+                emit_line(in, fn, ctx);
+                if (is_return_statement(p)) {
+                    parse_return_statement(p, fn, ctx);
+                } else {
+                    parse_statement(p, fn, ctx);
+                }
+                body_depth += delta;
+                while (loop_count > 0 && body_depth < loop_depth[loop_count - 1]) {
+                    ctx->hoist_count = loop_base[--loop_count];
                 }
             }
         }
     }
+    if (fn && !fn_inline) build_plan_add_unit(plan, fn_name, fn);
+    if (scratch) fclose(scratch);
+    
+    // Inline definitions follow every prototype and class in the header
+    if (inlines) {
+        char buf[4096];
+        size_t got;
+        rewind(inlines);
+        while ((got = fread(buf, 1, sizeof(buf), inlines)) > 0) fwrite(buf, 1, got, out);
+        fclose(inlines);
+    }
+}
+
+// `impor "spec"` line; copies spec
+static bool import_spec(const char *p, char *spec, size_t specsz) {
+    if (strncmp(p, "impor", 5) != 0 || !isspace((unsigned char)p[5])) return false;
+    p = skip_ws(p + 5);
+    const char *end = *p == '"' ? strchr(p + 1, '"') : NULL;
+    if (!end || (size_t)(end - p - 1) >= specsz) return false;
+    memcpy(spec, p + 1, end - p - 1);
+    spec[end - p - 1] = 0;
+    return true;
 }
-static void parse_main_program(FILE *in, FILE *out, ParserContext *ctx) {
+
+static void parse_statement(const char *p, FILE *out, ParserContext *ctx) {
+    if (is_variable_declaration(p)) {
+        parse_variable_declaration(p, out, ctx);
+    } else if (is_print_statement(p)) {
+        parse_print_statement(p, out, ctx);
+    } else if (is_flush_statement(p)) {
+        parse_flush_statement(out);
+    } else if (is_if_statement(p)) {
+        parse_if_statement(p, out, ctx);
+    } else if (is_else_statement(p)) {
+        parse_else_statement(p, out);
+    } else if (is_while_statement(p)) {
+        parse_while_statement(p, out, ctx);
+    } else if (is_for_statement(p)) {
+        parse_for_statement(p, out, ctx);
+    } else if (strcmp(p, "{") == 0) {
+        fputs("{\n", out);
+    } else if (strcmp(p, "}") == 0) {
+        fputs("}\n", out);
+    } else if (is_assignment(p)) {
+        parse_assignment(p, out, ctx);
+    } else if (is_standalone_function_call(p) || is_await_statement(p)) {
+        parse_standalone_function_call(p, out, ctx);
+    }
+    // Other statements can be added here
+}
+
+// Translate a loop into the scratch file to discover calls whose operands
+// the loop never assigns, and declare them in front of the loop. The body's
+// "{" may end the header or stand on the next line.
+// Returns the hoist table size to restore once the loop is closed.
+static int hoist_loop_invariants(FILE *in, const char *header, FILE *scratch, FILE *out, ParserContext *ctx) {
+    int base = ctx->hoist_count;
+    if (!scratch) return base;
+    
+    long pos = ftell(in);
+    if (pos < 0) return base;
+    
+    // Discovery must not leak declarations or temporaries of the loop body
+    // into ctx: the loop is translated for real right after
+    VarInfo *saved_vars = malloc(sizeof(ctx->vars));
+    if (!saved_vars) return base;
+    memcpy(saved_vars, ctx->vars, sizeof(ctx->vars));
+    int saved_var_count = ctx->var_count;
+    int saved_split_serial = ctx->split_serial;
+    Ty saved_task_ty = ctx->task_ty;
+    
+    char mutated[2048] = " ";
+    char body[512];
+    int depth = brace_delta(header);
+    bool opened = depth > 0;
+    
+    rewind(scratch);
+    ctx->hoist_discover = true;
+    hoist_collect_mutations(header, mutated, sizeof(mutated));
+    parse_statement(header, scratch, ctx);
+    
+    while ((depth > 0 || !opened) && fgets(body, sizeof(body), in)) {
+        size_t len = strlen(body);
+        if (len && (body[len-1]=='\n' || body[len-1]=='\r')) body[--len]=0;
+        
+        const char *p = skip_ws(body);
+        if (!*p) continue;
+        // A loop without a block has nothing worth hoisting
+        if (!opened && *p != '{') break;
+        opened = true;
+        
+        depth += brace_delta(p);
+        hoist_collect_mutations(p, mutated, sizeof(mutated));
+        parse_statement(p, scratch, ctx);
+    }
+    ctx->hoist_discover = false;
+    
+    memcpy(ctx->vars, saved_vars, sizeof(ctx->vars));
+    ctx->var_count = saved_var_count;
+    ctx->split_serial = saved_split_serial;
+    ctx->task_ty = saved_task_ty;
+    free(saved_vars);
+    fseek(in, pos, SEEK_SET);
+    
+    // Candidates recorded in an unterminated loop are not trusted
+    if (!opened || depth > 0) {
+        ctx->hoist_count = base;
+        return base;
+    }
+    hoist_emit(ctx, base, mutated, out);
+    return base;
+}
+
+// Parallel loops ("ngulang paralel"): the body moves into its own unit as
+// a chunk function, which paralel_kanggo runs on the runtime's thread pool.
+// Variables the body reads are copied into an environment struct, so they
+// are read-only inside the loop; reduction variables get an accumulator
+// per chunk.
+typedef struct {
+    char var[128];          // loop variable
+    char from[1024];        // start, step and bound as emitted C
+    char step[256];
+    char to[1024];
+    const char *cmp;        // "<", "<=", ">" or ">="
+    char red_name[8][128];
+    char red_ops[9];        // '+' jumlah, '<' min, '>' max
+    int red_count;
+    int threads;
+    int dynamic;
+    long long chunk;
+} ParallelLoop;
+
+static const char *c_type_of(Ty ty) {
+    switch (ty) {
+        case TY_INT: return "int";
+        case TY_BOOL: return "bool";
+        case TY_STRING: return "const char*";
+        case TY_ARRAY: return "JawaArray*";
+        case TY_TASK: return "JawaTugas*";
+        case TY_CHAN: return "JawaKanal*";
+        default: return "double";
+    }
+}
+
+static bool ctx_has_var(ParserContext *ctx, const char *name) {
+    for (int i = 0; i < ctx->var_count; i++) {
+        if (strcmp(ctx->vars[i].name, name) == 0) return true;
+    }
+    return false;
+}
+
+// Translate text as an expression; false if it is empty or a double
+static bool parallel_int_expr(const char *text, char *out, size_t outsz, ParserContext *ctx) {
+    int oi = 0;
+    out[0] = 0;
+    Lexer L = {.p = text};
+    lex_next(&L);
+    if (L.cur.kind == T_EOF) return false;
+    Ty ty = parse_expr(&L, out, outsz, &oi, ctx);
+    return ty != TY_DOUBLE && oi > 0;
+}
+
+// Header "ngulang paralel (owahi i = a; i < b; i++) clauses {".
+// Returns false (after a warning if the form was close) for loops that
+// should run sequentially instead.
+static bool parse_parallel_header(const char *line, ParallelLoop *pl, ParserContext *ctx) {
+    memset(pl, 0, sizeof(*pl));
+    const char *q = strstr(line, "paralel") + 7;
+    q = skip_ws(q);
+    if (*q != '(') return false;
+    
+    const char *close = q;
+    int level = 0;
+    for (; *close; close++) {
+        if (*close == '(') level++;
+        else if (*close == ')' && --level == 0) break;
+    }
+    if (*close != ')') return false;
+    
+    char head[1024];
+    int hl = (int)(close - q - 1);
+    if (hl >= (int)sizeof(head)) return false;
+    memcpy(head, q + 1, hl);
+    head[hl] = 0;
+    char *semi1 = strchr(head, ';');
+    char *semi2 = semi1 ? strchr(semi1 + 1, ';') : NULL;
+    if (!semi2) return false;
+    *semi1 = 0;
+    *semi2 = 0;
+    
+    // Init: [owahi] i [: int] = a
+    const char *p = skip_ws(head);
+    if (strncmp(p, "owahi", 5) == 0 && isspace((unsigned char)p[5])) p = skip_ws(p + 5);
+    int ni = 0;
+    while (is_ident_char((unsigned char)*p) && ni < 127) pl->var[ni++] = *p++;
+    pl->var[ni] = 0;
+    p = skip_ws(p);
+    if (*p == ':') {
+        p = skip_ws(p + 1);
+        if (strncmp(p, "int", 3) != 0) return false;
+        p = skip_ws(p + 3);
+    }
+    if (!ni || *p != '=' || !parallel_int_expr(p + 1, pl->from, sizeof(pl->from), ctx)) return false;
+    
+    // Condition: i < b, i <= b, i > b or i >= b
+    Lexer L = {.p = semi1 + 1};
+    lex_next(&L);
+    if (L.cur.kind != T_IDENT || strcmp(L.cur.lex, pl->var) != 0) return false;
+    lex_next(&L);
+    switch (L.cur.kind) {
+        case T_LT: pl->cmp = "<"; break;
+        case T_LE: pl->cmp = "<="; break;
+        case T_GT: pl->cmp = ">"; break;
+        case T_GE: pl->cmp = ">="; break;
+        default: return false;
+    }
+    if (!parallel_int_expr(L.p, pl->to, sizeof(pl->to), ctx)) return false;
+    
+    // Step: i++, ++i, i--, --i, i += k or i -= k
+    char incr[256];
+    int ii = 0;
+    for (p = semi2 + 1; *p && ii < (int)sizeof(incr) - 1; p++) {
+        if (!isspace((unsigned char)*p)) incr[ii++] = *p;
+    }
+    incr[ii] = 0;
+    size_t vl = strlen(pl->var);
+    char step[256];
+    if ((strncmp(incr, "++", 2) == 0 && strcmp(incr + 2, pl->var) == 0) ||
+        (strncmp(incr, pl->var, vl) == 0 && strcmp(incr + vl, "++") == 0)) {
+        strcpy(pl->step, "1");
+    } else if ((strncmp(incr, "--", 2) == 0 && strcmp(incr + 2, pl->var) == 0) ||
+               (strncmp(incr, pl->var, vl) == 0 && strcmp(incr + vl, "--") == 0)) {
+        strcpy(pl->step, "-1");
+    } else if (strncmp(incr, pl->var, vl) == 0 && (incr[vl] == '+' || incr[vl] == '-') && incr[vl + 1] == '=' &&
+               parallel_int_expr(incr + vl + 2, step, sizeof(step), ctx)) {
+        snprintf(pl->step, sizeof(pl->step), incr[vl] == '-' ? "-(%s)" : "(%s)", step);
+    } else {
+        return false;
+    }
+    
+    // Clauses: jumlah(x) min(x) max(x) benang(n) jadwal(statis|dinamis[, n])
+    L.p = close + 1;
+    lex_next(&L);
+    while (L.cur.kind == T_IDENT) {
+        char clause[64];
+        snprintf(clause, sizeof(clause), "%s", L.cur.lex);
+        lex_next(&L);
+        if (L.cur.kind != T_LPAREN) break;
+        lex_next(&L);
+        if (strcmp(clause, "jumlah") == 0 || strcmp(clause, "min") == 0 || strcmp(clause, "max") == 0) {
+            Ty ty = parser_get_var_type(ctx, L.cur.lex);
+            if (L.cur.kind != T_IDENT || (ty != TY_INT && ty != TY_DOUBLE) || pl->red_count >= 8) {
+                fprintf(stderr, "Warning: %s(%s) needs an int or double variable, loop runs sequentially\n",
+                        clause, L.cur.lex);
+                return false;
+            }
+            snprintf(pl->red_name[pl->red_count], sizeof(pl->red_name[0]), "%s", L.cur.lex);
+            pl->red_ops[pl->red_count++] = clause[0] == 'j' ? '+' : clause[1] == 'i' ? '<' : '>';
+            lex_next(&L);
+        } else if (strcmp(clause, "benang") == 0 && L.cur.kind == T_INT) {
+            pl->threads = atoi(L.cur.lex);
+            lex_next(&L);
+        } else if (strcmp(clause, "jadwal") == 0 && L.cur.kind == T_IDENT) {
+            pl->dynamic = strcmp(L.cur.lex, "dinamis") == 0;
+            lex_next(&L);
+            if (L.cur.kind == T_COMMA) {
+                lex_next(&L);
+                if (L.cur.kind == T_INT) pl->chunk = atoll(L.cur.lex);
+                lex_next(&L);
+            }
+        } else {
+            fprintf(stderr, "Warning: unknown clause '%s' on parallel loop, loop runs sequentially\n", clause);
+            return false;
+        }
+        if (L.cur.kind != T_RPAREN) return false;
+        lex_next(&L);
+    }
+    return L.cur.kind == T_LBRACE;
+}
+
+// Name declared by an "owahi"/"cendhak"/"ajek" line
+static void declared_name(const char *p, char *name, size_t namesz) {
+    while (*p && !isspace((unsigned char)*p)) p++;
+    p = skip_ws(p);
+    size_t n = 0;
+    while (is_ident_char((unsigned char)*p) && n + 1 < namesz) name[n++] = *p++;
+    name[n] = 0;
+}
+
+// Lower a parallel loop; on false nothing was consumed from in
+static bool parse_parallel_loop(FILE *in, const char *header, FILE *out, BuildPlan *plan,
+                                ParserContext *ctx, int *serial) {
+    ParallelLoop pl;
+    if (!parse_parallel_header(header, &pl, ctx)) return false;
+    
+    long pos = ftell(in);
+    if (pos < 0) return false;
+    int header_line = ctx->line_starts ? source_line_at(ctx, pos) : 0;
+    
+    // The body, up to the line that closes the loop
+    char (*body)[512] = NULL;
+    int *body_line = NULL;
+    int count = 0, cap = 0;
     char line[512];
-    bool in_function = false;
+    int depth = brace_delta(header);
+    bool closed = false;
+    while (fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+        if (len && (line[len-1]=='\n' || line[len-1]=='\r')) line[--len]=0;
+        const char *p = skip_ws(line);
+        if (!*p) continue;
+        depth += brace_delta(p);
+        if (depth <= 0) {
+            closed = strcmp(p, "}") == 0;
+            break;
+        }
+        if (count == cap) {
+            cap = cap ? cap * 2 : 32;
+            void *grown = realloc(body, sizeof(*body) * cap);
+            if (!grown) break;
+            body = grown;
+            grown = realloc(body_line, sizeof(int) * cap);
+            if (!grown) break;
+            body_line = grown;
+        }
+        body_line[count] = ctx->line_starts ? source_line_at(ctx, ftell(in)) : 0;
+        snprintf(body[count++], sizeof(body[0]), "%s", p);
+    }
+    // Captures: outer variables the body mentions, except its own
+    // declarations, the loop variable and the reductions
+    char declared[2048] = " ";
+    for (int i = 0; i < count; i++) {
+        if (!is_variable_declaration(body[i])) continue;
+        char name[128];
+        declared_name(body[i], name, sizeof(name));
+        if (strlen(declared) + strlen(name) + 2 < sizeof(declared)) {
+            strcat(declared, name);
+            strcat(declared, " ");
+        }
+    }
+    char captures[2048] = " ";
+    for (int i = 0; i < count; i++) {
+        char prev = ' ';
+        for (const char *p = body[i]; *p; ) {
+            if (*p == '"') {
+                for (p++; *p && *p != '"'; p++) {
+                    if (*p == '\\' && p[1]) p++;
+                }
+                if (*p) p++;
+                prev = '"';
+                continue;
+            }
+            if (!isalpha((unsigned char)*p) && *p != '_') {
+                if (!isspace((unsigned char)*p)) prev = *p;
+                p += is_ident_char((unsigned char)*p) ? strspn(p, "0123456789") : 1;
+                continue;
+            }
+            char name[128];
+            size_t n = 0;
+            while (is_ident_char((unsigned char)*p)) {
+                if (n + 1 < sizeof(name)) name[n++] = *p;
+                p++;
+            }
+            name[n] = 0;
+            bool member = prev == '.';
+            prev = 'a';
+            if (member || !ctx_has_var(ctx, name) || strcmp(name, pl.var) == 0) continue;
+            char key[132];
+            snprintf(key, sizeof(key), " %s ", name);
+            if (strstr(declared, key) || strstr(captures, key)) continue;
+            bool is_red = false;
+            for (int r = 0; r < pl.red_count; r++) is_red |= strcmp(pl.red_name[r], name) == 0;
+            if (is_red || strlen(captures) + strlen(key) >= sizeof(captures)) continue;
+            strcat(captures, key + 1);
+        }
+    }
+    
+    // Captures are copied into each chunk, so a write to one would be lost
+    // (and race); "bali" cannot leave the loop from a chunk function
+    bool sequential = !closed;
+    for (int i = 0; i < count && !sequential; i++) {
+        if (is_return_statement(body[i]) && (!body[i][4] || isspace((unsigned char)body[i][4]))) {
+            fprintf(stderr, "Warning: 'bali' inside a parallel loop, loop runs sequentially\n");
+            sequential = true;
+        } else if (is_assignment(body[i])) {
+            char name[128], key[132];
+            size_t n = 0;
+            for (const char *p = body[i]; is_ident_char((unsigned char)*p) && n + 1 < sizeof(name); p++) name[n++] = *p;
+            name[n] = 0;
+            snprintf(key, sizeof(key), " %s ", name);
+            if (strstr(captures, key) || strcmp(name, pl.var) == 0) {
+                fprintf(stderr, "Warning: parallel loop assigns '%s', which is not a jumlah/min/max "
+                        "reduction; loop runs sequentially\n", name);
+                sequential = true;
+            }
+        }
+    }
+    FILE *u = sequential ? NULL : build_stream_open();
+    if (!u) {
+        free(body);
+        free(body_line);
+        fseek(in, pos, SEEK_SET);
+        return false;
+    }
+    
+    char fn_name[64];
+    snprintf(fn_name, sizeof(fn_name), "jawa_paralel_%d", (*serial)++);
+    
+    // Environment struct, shared by the chunk function and the caller
+    char env[4096];
+    int ei = 0;
+    sb_add(env, sizeof(env), &ei, "struct %s_env {\n    long long _awal;\n    long long _langkah;\n", fn_name);
+    for (char *c = captures + 1; *c; ) {
+        char *sp = strchr(c, ' ');
+        *sp = 0;
+        sb_add(env, sizeof(env), &ei, "    %s %s;\n", c_type_of(parser_get_var_type(ctx, c)), c);
+        *sp = ' ';
+        c = sp + 1;
+    }
+    sb_add(env, sizeof(env), &ei, "}");
+    
+    // Chunk function
+    fprintf(u, "%s;\n\n", env);
+    fprintf(u, "void %s(long long _mulai, long long _akhir, void *_p, JawaNilai *_red) {\n", fn_name);
+    fprintf(u, "struct %s_env *_env = _p;\n", fn_name);
+    for (char *c = captures + 1; *c; ) {
+        char *sp = strchr(c, ' ');
+        *sp = 0;
+        fprintf(u, "%s %s = _env->%s;\n", c_type_of(parser_get_var_type(ctx, c)), c, c);
+        *sp = ' ';
+        c = sp + 1;
+    }
+    // Accumulators keep the variable's own type, so int sums stay exact
+    char jenis[9] = {0};
+    for (int r = 0; r < pl.red_count; r++) {
+        Ty ty = parser_get_var_type(ctx, pl.red_name[r]);
+        jenis[r] = parser_nilai_field(ty)[0];
+        fprintf(u, "%s %s = _red[%d].%c;\n", c_type_of(ty), pl.red_name[r], r, jenis[r]);
+    }
+    fprintf(u, "for (long long _k = _mulai; _k < _akhir; _k++) {\n");
+    fprintf(u, "int %s = (int)(_env->_awal + _k * _env->_langkah);\n", pl.var);
+    
+    VarInfo *saved_vars = malloc(sizeof(ctx->vars));
+    int saved_var_count = ctx->var_count;
+    int saved_hoists = ctx->hoist_count;
+    if (saved_vars) memcpy(saved_vars, ctx->vars, sizeof(ctx->vars));
+    ctx->hoist_count = 0;   // hoisted temporaries live in the caller
+    parser_add_var(ctx, pl.var, TY_INT);
+    for (int i = 0; i < count; i++) {
+        if (ctx->line_starts) emit_line_no(u, ctx, body_line[i]);
+        parse_statement(body[i], u, ctx);
+    }
+    ctx->hoist_count = saved_hoists;
+    if (saved_vars) {
+        memcpy(ctx->vars, saved_vars, sizeof(ctx->vars));
+        ctx->var_count = saved_var_count;
+        free(saved_vars);
+    }
+    
+    fputs("}\n", u);
+    for (int r = 0; r < pl.red_count; r++) fprintf(u, "_red[%d].%c = %s;\n", r, jenis[r], pl.red_name[r]);
+    fputs("}\n", u);
+    build_plan_add_unit(plan, fn_name, u);
+    free(body);
+    free(body_line);
+    
+    // Call site: evaluate the range once, fill the environment, run
+    fprintf(out, "{\n%s _env;\n", env);
+    fprintf(out, "extern void %s(long long, long long, void *, JawaNilai *);\n", fn_name);
+    fprintf(out, "long long _a = %s, _b = %s, _s = %s;\n", pl.from, pl.to, pl.step);
+    fprintf(out, "_env._awal = _a;\n_env._langkah = _s;\n");
+    for (char *c = captures + 1; *c; ) {
+        char *sp = strchr(c, ' ');
+        *sp = 0;
+        fprintf(out, "_env.%s = %s;\n", c, c);
+        *sp = ' ';
+        c = sp + 1;
+    }
+    fprintf(out, "JawaNilai _hasil[%d] = {", pl.red_count + 1);
+    for (int r = 0; r < pl.red_count; r++) fprintf(out, "%s{ .%c = %s }", r ? ", " : " ", jenis[r], pl.red_name[r]);
+    fputs(pl.red_count ? " };\n" : " { .i = 0 } };\n", out);
+    
+    const char *count_expr;
+    if (strcmp(pl.cmp, "<") == 0) count_expr = "(_s > 0 && _b > _a) ? (_b - _a + _s - 1) / _s : 0";
+    else if (strcmp(pl.cmp, "<=") == 0) count_expr = "(_s > 0 && _b >= _a) ? (_b - _a) / _s + 1 : 0";
+    else if (strcmp(pl.cmp, ">") == 0) count_expr = "(_s < 0 && _a > _b) ? (_a - _b - _s - 1) / -_s : 0";
+    else count_expr = "(_s < 0 && _a >= _b) ? (_a - _b) / -_s + 1 : 0";
+    // The call site spans several C lines; keep them on the loop's line
+    emit_line_no(out, ctx, header_line);
+    fprintf(out, "paralel_kanggo(%s, %d, %d, %lldLL, %s, &_env, _hasil, \"%s\", \"%s\");\n",
+            count_expr, pl.threads, pl.dynamic, pl.chunk, fn_name, pl.red_ops, jenis);
+    for (int r = 0; r < pl.red_count; r++) {
+        emit_line_no(out, ctx, header_line);
+        fprintf(out, "%s = _hasil[%d].%c;\n", pl.red_name[r], r, jenis[r]);
+    }
+    emit_line_no(out, ctx, header_line);
+    fputs("}\n", out);
+    return true;
+}
+
+static void parse_main_program(FILE *in, FILE *out, BuildPlan *plan, ParserContext *ctx) {
+    char line[512];
+    int depth = 0;          // brace depth of the emitted main body
+    LiveIf live = { .count = 0 };   // "yen" blocks whose condition is always true
+    int loop_depth[64];     // depths of loop bodies with hoisted temporaries
+    int loop_base[64];
+    int loop_count = 0;
+    int parallel_serial = 0;
+    FILE *scratch = tmpfile();
     
     rewind(in);
     fputs("int main(){\n", out);
@@ -520,204 +1384,478 @@ static void parse_main_program(FILE *in, FILE *out, ParserContext *ctx) {
         if (!*p) continue;
 
         // Skip class declarations and their content
-        if (strncmp(p, "bolo ", 5) == 0 && isspace((unsigned char)p[5])) {
+        if (strncmp(p, "bolo", 4) == 0 && isspace((unsigned char)p[4])) {
             skip_class_block(in, line, sizeof(line));
             continue;
         }
 
+        // Imports are resolved before the program is translated
+        char spec[256];
+        if (import_spec(p, spec, sizeof(spec))) continue;
+
         // Skip function definitions (already handled in parse_function_definitions)
+        MemoSpec memo;
+        const char *rest = memo_annotation(p, &memo, false);
+        if (rest && !*rest) continue;
+        if (rest) p = rest;
         if (strncmp(p, "gawe ", 5) == 0) {
-            in_function = true;
+            skip_dead_block(in, p, line, sizeof(line));
             continue;
         }
-        
-        // Skip function body content (already handled)
-        if (in_function) {
-            if (strcmp(p, "}") == 0) {
-                in_function = false;
-            }
+        emit_line(in, out, ctx);
+
+        if (fold_constant_if(in, p, line, sizeof(line), out, ctx, &depth, &live)) continue;
+
+        // Parallel loops become a call into the thread pool
+        if (is_parallel_for_statement(p) && parse_parallel_loop(in, p, out, plan, ctx, &parallel_serial)) {
+            continue;
+        }
+
+        // Hoist loop-invariant calls in front of the loop. "ngulang" may
+        // open its body on the next line; "menawa" is a loop only with "{"
+        if ((is_for_statement(p) || (is_while_statement(p) && strchr(p, '{'))) &&
+            loop_count < (int)(sizeof(loop_depth) / sizeof(loop_depth[0]))) {
+            loop_base[loop_count] = hoist_loop_invariants(in, p, scratch, out, ctx);
+            emit_line(in, out, ctx);
+            parse_statement(p, out, ctx);
+            // The body is one level deeper, whichever line opens it
+            loop_depth[loop_count++] = depth + 1;
+            depth += brace_delta(p);
             continue;
         }
 
         // Parse main program statements only
-        if (is_variable_declaration(p)) {
-            parse_variable_declaration(p, out, ctx);
-        } else if (is_print_statement(p)) {
-            parse_print_statement(p, out, ctx);
-        } else if (is_if_statement(p)) {
-            parse_if_statement(p, out, ctx);
-        } else if (is_else_statement(p)) {
-            parse_else_statement(p, out);
-        } else if (is_while_statement(p)) {
-            parse_while_statement(p, out, ctx);
-        } else if (is_for_statement(p)) {
-            parse_for_statement(p, out, ctx);
-        } else if (strcmp(p, "{") == 0) {
-            fputs("{\n", out);
-        } else if (strcmp(p, "}") == 0) {
-            fputs("}\n", out);
-        } else if (is_assignment(p)) {
-            parse_assignment(p, out, ctx);
-        } else if (is_standalone_function_call(p)) {
-            parse_standalone_function_call(p, out, ctx);
+        parse_statement(p, out, ctx);
+        depth += brace_delta(p);
+        
+        // Hoisted temporaries go out of scope with their loop
+        while (loop_count > 0 && depth < loop_depth[loop_count - 1]) {
+            ctx->hoist_count = loop_base[--loop_count];
         }
-        // Other statements can be added here
     }
 
+    if (scratch) fclose(scratch);
+
     fputs("return 0;\n}\n", out);
 }
 
-int build_native(const char *srcPath, const char *outPath) {
-    FILE *in = fopen(srcPath, "r");
-    if (!in) { 
-        perror("open src"); 
-        return 1; 
-    }
-    
-    char tmpc[FILENAME_MAX];
-    snprintf(tmpc, sizeof(tmpc), "%s.c", outPath);
-    FILE *c = fopen(tmpc, "w");
-    if (!c) { 
-        perror("open c out"); 
-        fclose(in); 
-        return 2; 
-    }
+// Counter hooks of "jawa build --stats" (statistik.h); calls only when
+// bytes is NULL. The default runtime is emitted without them.
+static void write_stat(FILE *c, bool stats, int jenis, const char *bytes) {
+    if (!stats) return;
+    fprintf(c, "    statistik_panggil(%d);\n", jenis);
+    if (bytes) fprintf(c, "    statistik_bait(%d, %s);\n", jenis, bytes);
+}
 
-    write_preamble(c);
-    
-    // Parse classes first
-    parse_classes(in, c);
-    
-    // Parse function definitions
-    ParserContext ctx;
-    parser_init(&ctx);
-    parse_function_definitions(in, c, &ctx);
-    
-    // Parse main program
-    parse_main_program(in, c, &ctx);
+// Runtime unit: helpers every generated program links against
+static void write_runtime(FILE *c, bool stats) {
+    if (stats) {
+        // The runtime modules count only once this constructor ran
+        fputs("// Operation counters (jawa build --stats)\n", c);
+        fputs("void statistik_mulai(void);\n", c);
+        fputs("void statistik_panggil(int jenis);\n", c);
+        fputs("void statistik_bait(int jenis, size_t bait);\n", c);
+        fputs("__attribute__((constructor)) static void jawa_statistik(void) {\n", c);
+        fputs("    statistik_mulai();\n", c);
+        fputs("}\n\n", c);
+    }
+    fputs("#include <limits.h>\n\n", c);
+    fputs("// String helper functions\n", c);
+    fputs("char* str_dup(const char* s) {\n", c);
+    fputs("    if (!s) return NULL;\n", c);
+    fputs("    int len = strlen(s);\n", c);
+    write_stat(c, stats, STAT_STR_DUP, "len + 1");
+    fputs("    char* result = malloc(len + 1);\n", c);
+    fputs("    strcpy(result, s);\n", c);
+    fputs("    return result;\n", c);
+    fputs("}\n\n", c);
     
     // Add string function implementations
-    fputs("\n// String function implementations\n", c);
+    fputs("// String function implementations\n", c);
     fputs("char* string_toUpperCase(const char* str) {\n", c);
     fputs("    if (!str) return NULL;\n", c);
-    fputs("    int len = strlen(str);\n", c);
+    fputs("    size_t len = strlen(str);\n", c);
+    write_stat(c, stats, STAT_STRING_UPPER, "len + 1");
     fputs("    char* result = malloc(len + 1);\n", c);
-    fputs("    for (int i = 0; i < len; i++) {\n", c);
-    fputs("        result[i] = toupper(str[i]);\n", c);
-    fputs("    }\n", c);
-    fputs("    result[len] = 0;\n", c);
+    fputs("    if (!result) return NULL;\n", c);
+    fputs("    result[string_huruf_gedhe(result, str, len)] = 0;\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
+    // Temporaries nobody else references are converted in place
+    fputs("char* string_toUpperCase_inplace(char* str) {\n", c);
+    write_stat(c, stats, STAT_STRING_UPPER, NULL);
+    fputs("    if (str) str[string_huruf_gedhe(str, str, strlen(str))] = 0;\n", c);
+    fputs("    return str;\n", c);
+    fputs("}\n\n", c);
+    
     // Add print function implementations
     fputs("// Print function implementations\n", c);
     fputs("void tulis(const char* text) {\n", c);
-    fputs("    if (text) printf(\"%s\\n\", text);\n", c);
+    fputs("    if (text) cithak_format(\"%s\\n\", text);\n", c);
     fputs("}\n\n", c);
     fputs("void cithak(const char* text) {\n", c);
-    fputs("    if (text) printf(\"%s\\n\", text);\n", c);
+    fputs("    if (text) cithak_format(\"%s\\n\", text);\n", c);
     fputs("}\n\n", c);
     
     fputs("char* string_toLowerCase(const char* str) {\n", c);
     fputs("    if (!str) return NULL;\n", c);
-    fputs("    int len = strlen(str);\n", c);
-    fputs("    char* result = malloc(len + 1);\n", c);
-    fputs("    for (int i = 0; i < len; i++) {\n", c);
-    fputs("        result[i] = tolower(str[i]);\n", c);
-    fputs("    }\n", c);
-    fputs("    result[len] = 0;\n", c);
+    fputs("    size_t len = strlen(str);\n", c);
+    fputs("    size_t n = string_huruf_cilik_dawane(str, len);\n", c);
+    write_stat(c, stats, STAT_STRING_LOWER, "n + 1");
+    fputs("    char* result = malloc(n + 1);\n", c);
+    fputs("    if (!result) return NULL;\n", c);
+    fputs("    result[string_huruf_cilik(result, str, len)] = 0;\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
+    // Temporaries nobody else references are converted in place, unless
+    // an İ makes the result longer
+    fputs("char* string_toLowerCase_inplace(char* str) {\n", c);
+    fputs("    if (!str) return str;\n", c);
+    fputs("    size_t len = strlen(str);\n", c);
+    fputs("    if (string_huruf_cilik_dawane(str, len) != len) return string_toLowerCase(str);\n", c);
+    write_stat(c, stats, STAT_STRING_LOWER, NULL);
+    fputs("    str[string_huruf_cilik(str, str, len)] = 0;\n", c);
+    fputs("    return str;\n", c);
+    fputs("}\n\n", c);
+    
+    // Lengths and indices count UTF-8 characters (bytes for invalid text)
     fputs("int string_length(const char* str) {\n", c);
-    fputs("    return str ? strlen(str) : 0;\n", c);
+    write_stat(c, stats, STAT_STRING_LENGTH, NULL);
+    fputs("    return str ? (int)string_utf8_chars(str, strlen(str)) : 0;\n", c);
     fputs("}\n\n", c);
     
     fputs("char* string_substring(const char* str, int start, int end) {\n", c);
     fputs("    if (!str) return NULL;\n", c);
-    fputs("    int len = strlen(str);\n", c);
+    fputs("    size_t len = strlen(str);\n", c);
     fputs("    if (start < 0) start = 0;\n", c);
-    fputs("    if (end > len) end = len;\n", c);
     fputs("    if (start >= end) return str_dup(\"\");\n", c);
-    fputs("    int result_len = end - start;\n", c);
+    fputs("    size_t from = string_utf8_offset(str, len, (size_t)start);\n", c);
+    fputs("    size_t to = string_utf8_offset(str, len, (size_t)end);\n", c);
+    fputs("    if (from >= to) return str_dup(\"\");\n", c);
+    fputs("    size_t result_len = to - from;\n", c);
+    write_stat(c, stats, STAT_STRING_SUBSTRING, "result_len + 1");
     fputs("    char* result = malloc(result_len + 1);\n", c);
-    fputs("    strncpy(result, str + start, result_len);\n", c);
+    fputs("    memcpy(result, str + from, result_len);\n", c);
     fputs("    result[result_len] = 0;\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
+    // Replace every occurrence: find matches once, allocate once, memcpy.
+    // Literal arguments call string_replace_n with their lengths directly.
     fputs("char* string_replace(const char* str, const char* old_str, const char* new_str) {\n", c);
     fputs("    if (!str || !old_str || !new_str) return str_dup(str ? str : \"\");\n", c);
-    fputs("    char* pos = strstr(str, old_str);\n", c);
-    fputs("    if (!pos) return str_dup(str);\n", c);
-    fputs("    int old_len = strlen(old_str);\n", c);
-    fputs("    int new_len = strlen(new_str);\n", c);
-    fputs("    int str_len = strlen(str);\n", c);
-    fputs("    char* result = malloc(str_len - old_len + new_len + 1);\n", c);
-    fputs("    int prefix_len = pos - str;\n", c);
-    fputs("    strncpy(result, str, prefix_len);\n", c);
-    fputs("    strcpy(result + prefix_len, new_str);\n", c);
-    fputs("    strcpy(result + prefix_len + new_len, pos + old_len);\n", c);
+    fputs("    return string_replace_n(str, old_str, strlen(old_str), new_str, strlen(new_str));\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("char* string_replace_n(const char* str, const char* old_str, size_t old_len, const char* new_str, size_t new_len) {\n", c);
+    fputs("    if (!str) return str_dup(\"\");\n", c);
+    fputs("    size_t str_len = strlen(str);\n", c);
+    fputs("    if (old_len == 0) return str_dup(str);\n", c);
+    fputs("    size_t pos_stack[64];\n", c);
+    fputs("    size_t* pos = pos_stack;\n", c);
+    fputs("    size_t cap = 64, count = 0;\n", c);
+    fputs("    const char* p = str;\n", c);
+    fputs("    while ((p = string_golek(p, str_len - (p - str), old_str, old_len)) != NULL) {\n", c);
+    fputs("        if (count == cap) {\n", c);
+    fputs("            size_t* grown = malloc(cap * 2 * sizeof(size_t));\n", c);
+    fputs("            if (!grown) { if (pos != pos_stack) free(pos); return NULL; }\n", c);
+    fputs("            memcpy(grown, pos, count * sizeof(size_t));\n", c);
+    fputs("            if (pos != pos_stack) free(pos);\n", c);
+    fputs("            pos = grown;\n", c);
+    fputs("            cap *= 2;\n", c);
+    fputs("        }\n", c);
+    fputs("        pos[count++] = p - str;\n", c);
+    fputs("        p += old_len;\n", c);
+    fputs("    }\n", c);
+    write_stat(c, stats, STAT_STRING_REPLACE, "str_len - count * old_len + count * new_len + 1");
+    fputs("    if (count == 0) return str_dup(str);\n", c);
+    fputs("    char* result = malloc(str_len - count * old_len + count * new_len + 1);\n", c);
+    fputs("    if (!result) { if (pos != pos_stack) free(pos); return NULL; }\n", c);
+    fputs("    char* dst = result;\n", c);
+    fputs("    size_t from = 0;\n", c);
+    fputs("    for (size_t i = 0; i < count; i++) {\n", c);
+    fputs("        memcpy(dst, str + from, pos[i] - from);\n", c);
+    fputs("        dst += pos[i] - from;\n", c);
+    fputs("        memcpy(dst, new_str, new_len);\n", c);
+    fputs("        dst += new_len;\n", c);
+    fputs("        from = pos[i] + old_len;\n", c);
+    fputs("    }\n", c);
+    fputs("    memcpy(dst, str + from, str_len - from + 1);\n", c);
+    fputs("    if (pos != pos_stack) free(pos);\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
+    // Many patterns in one scan (Aho-Corasick) with the matching rules of
+    // string_ganti_banyak in string_enhanced.c: the leftmost match wins, then
+    // the longest. Children are sibling lists and only the root has a full
+    // table, so building costs about the total pattern length per call.
+    fputs("typedef struct {\n", c);
+    fputs("    int anak, sedulur;   // first child, next sibling\n", c);
+    fputs("    unsigned char c;\n", c);
+    fputs("    int fail, pola, kamus, dalam;\n", c);
+    fputs("} JawaSimpulAC;\n\n", c);
+    fputs("typedef struct { size_t awal, panjang; int pola; } JawaCocokAC;\n\n", c);
+    fputs("static int jawa_ac_anak(const JawaSimpulAC* ac, int s, unsigned char c) {\n", c);
+    fputs("    for (int t = ac[s].anak; t; t = ac[t].sedulur) if (ac[t].c == c) return t;\n", c);
+    fputs("    return 0;\n", c);
+    fputs("}\n\n", c);
+    fputs("static int jawa_ac_maju(const JawaSimpulAC* ac, const int* akar, int s, unsigned char c) {\n", c);
+    fputs("    for (;;) {\n", c);
+    fputs("        if (!s) return akar[c];\n", c);
+    fputs("        int t = jawa_ac_anak(ac, s, c);\n", c);
+    fputs("        if (t) return t;\n", c);
+    fputs("        s = ac[s].fail;\n", c);
+    fputs("    }\n", c);
+    fputs("}\n\n", c);
+    fputs("static JawaSimpulAC* jawa_bangun_ac(const char* const* finds, int count, int* akar, int* jumlah) {\n", c);
+    fputs("    size_t total = 1;\n", c);
+    fputs("    for (int i = 0; i < count; i++) if (finds[i]) total += strlen(finds[i]);\n", c);
+    fputs("    JawaSimpulAC* ac = calloc(total, sizeof(JawaSimpulAC));\n", c);
+    fputs("    int* antrian = malloc(total * sizeof(int));\n", c);
+    fputs("    if (!ac || !antrian) { free(ac); free(antrian); return NULL; }\n", c);
+    fputs("    memset(akar, 0, 256 * sizeof(int));\n", c);
+    fputs("    int n = 1;\n", c);
+    fputs("    ac[0].pola = -1; ac[0].kamus = -1;\n", c);
+    fputs("    for (int i = 0; i < count; i++) {\n", c);
+    fputs("        if (!finds[i] || !finds[i][0]) continue;\n", c);
+    fputs("        int s = 0;\n", c);
+    fputs("        for (const unsigned char* c = (const unsigned char*)finds[i]; *c; c++) {\n", c);
+    fputs("            int t = s ? jawa_ac_anak(ac, s, *c) : akar[*c];\n", c);
+    fputs("            if (!t) {\n", c);
+    fputs("                t = n++;\n", c);
+    fputs("                ac[t].c = *c; ac[t].pola = -1; ac[t].kamus = -1; ac[t].dalam = ac[s].dalam + 1;\n", c);
+    fputs("                ac[t].sedulur = ac[s].anak; ac[s].anak = t;\n", c);
+    fputs("                if (!s) akar[*c] = t;\n", c);
+    fputs("            }\n", c);
+    fputs("            s = t;\n", c);
+    fputs("        }\n", c);
+    fputs("        if (ac[s].pola < 0) ac[s].pola = i;\n", c);
+    fputs("    }\n", c);
+    fputs("    // Breadth first: failure and dictionary links\n", c);
+    fputs("    int kepala = 0, ekor = 0;\n", c);
+    fputs("    for (int t = ac[0].anak; t; t = ac[t].sedulur) antrian[ekor++] = t;\n", c);
+    fputs("    while (kepala < ekor) {\n", c);
+    fputs("        int s = antrian[kepala++];\n", c);
+    fputs("        int f = ac[s].fail;\n", c);
+    fputs("        ac[s].kamus = ac[f].pola >= 0 ? f : ac[f].kamus;\n", c);
+    fputs("        for (int t = ac[s].anak; t; t = ac[t].sedulur) {\n", c);
+    fputs("            ac[t].fail = jawa_ac_maju(ac, akar, f, ac[t].c);\n", c);
+    fputs("            antrian[ekor++] = t;\n", c);
+    fputs("        }\n", c);
+    fputs("    }\n", c);
+    fputs("    free(antrian);\n", c);
+    fputs("    *jumlah = n;\n", c);
+    fputs("    return ac;\n", c);
+    fputs("}\n\n", c);
+    fputs("char* string_ganti_banyak(const char* str, const char* const* finds, const char* const* replaces, int count) {\n", c);
+    fputs("    if (!str) return str_dup(\"\");\n", c);
+    fputs("    if (!finds || !replaces || count <= 0) return str_dup(str);\n", c);
+    fputs("    int jumlah = 0, akar[256];\n", c);
+    fputs("    JawaSimpulAC* ac = jawa_bangun_ac(finds, count, akar, &jumlah);\n", c);
+    fputs("    if (!ac) return NULL;\n", c);
+    fputs("    size_t str_len = strlen(str);\n", c);
+    fputs("    // The longest match per start position waits in a ring until no other\n", c);
+    fputs("    // match can start further left\n", c);
+    fputs("    size_t lebar = 1, kap = 64, n = 0;\n", c);
+    fputs("    for (int k = 0; k < jumlah; k++) if ((size_t)ac[k].dalam + 1 > lebar) lebar = ac[k].dalam + 1;\n", c);
+    fputs("    JawaCocokAC* cocok = malloc(kap * sizeof(JawaCocokAC));\n", c);
+    fputs("    JawaCocokAC* jendela = malloc(lebar * sizeof(JawaCocokAC));\n", c);
+    fputs("    if (!cocok || !jendela) { free(cocok); free(jendela); free(ac); return NULL; }\n", c);
+    fputs("    for (size_t k = 0; k < lebar; k++) jendela[k].pola = -1;\n", c);
+    fputs("    size_t periksa = 0;\n", c);
+    fputs("    int s = 0;\n", c);
+    fputs("    for (size_t i = 0; i <= str_len; i++) {\n", c);
+    fputs("        size_t awal_min = i + 1;\n", c);
+    fputs("        if (i < str_len) {\n", c);
+    fputs("            s = jawa_ac_maju(ac, akar, s, (unsigned char)str[i]);\n", c);
+    fputs("            awal_min = i + 1 - ac[s].dalam;\n", c);
+    fputs("            for (int t = ac[s].pola >= 0 ? s : ac[s].kamus; t >= 0; t = ac[t].kamus) {\n", c);
+    fputs("                size_t awal = i + 1 - ac[t].dalam;\n", c);
+    fputs("                if (awal < periksa) continue;\n", c);
+    fputs("                JawaCocokAC* slot = &jendela[awal % lebar];\n", c);
+    fputs("                if (slot->pola < 0 || slot->awal != awal || slot->panjang < (size_t)ac[t].dalam) {\n", c);
+    fputs("                    slot->awal = awal;\n", c);
+    fputs("                    slot->panjang = ac[t].dalam;\n", c);
+    fputs("                    slot->pola = ac[t].pola;\n", c);
+    fputs("                }\n", c);
+    fputs("            }\n", c);
+    fputs("        }\n", c);
+    fputs("        while (periksa < awal_min && periksa < str_len) {\n", c);
+    fputs("            JawaCocokAC* slot = &jendela[periksa % lebar];\n", c);
+    fputs("            if (slot->pola < 0 || slot->awal != periksa) { periksa++; continue; }\n", c);
+    fputs("            if (n == kap) {\n", c);
+    fputs("                JawaCocokAC* grown = realloc(cocok, kap * 2 * sizeof(JawaCocokAC));\n", c);
+    fputs("                if (!grown) { free(jendela); free(cocok); free(ac); return NULL; }\n", c);
+    fputs("                cocok = grown;\n", c);
+    fputs("                kap *= 2;\n", c);
+    fputs("            }\n", c);
+    fputs("            cocok[n++] = *slot;\n", c);
+    fputs("            slot->pola = -1;\n", c);
+    fputs("            periksa += cocok[n - 1].panjang;\n", c);
+    fputs("        }\n", c);
+    fputs("    }\n", c);
+    fputs("    free(jendela);\n", c);
+    fputs("    free(ac);\n", c);
+    fputs("    // Measure, allocate once, memcpy\n", c);
+    fputs("    size_t total = str_len;\n", c);
+    fputs("    for (size_t k = 0; k < n; k++) {\n", c);
+    fputs("        const char* r = replaces[cocok[k].pola];\n", c);
+    fputs("        total = total - cocok[k].panjang + (r ? strlen(r) : 0);\n", c);
+    fputs("    }\n", c);
+    fputs("    char* result = malloc(total + 1);\n", c);
+    fputs("    if (result) {\n", c);
+    fputs("        char* dst = result;\n", c);
+    fputs("        size_t from = 0;\n", c);
+    fputs("        for (size_t k = 0; k < n; k++) {\n", c);
+    fputs("            const char* r = replaces[cocok[k].pola];\n", c);
+    fputs("            size_t r_len = r ? strlen(r) : 0;\n", c);
+    fputs("            memcpy(dst, str + from, cocok[k].awal - from);\n", c);
+    fputs("            dst += cocok[k].awal - from;\n", c);
+    fputs("            if (r_len) memcpy(dst, r, r_len);\n", c);
+    fputs("            dst += r_len;\n", c);
+    fputs("            from = cocok[k].awal + cocok[k].panjang;\n", c);
+    fputs("        }\n", c);
+    fputs("        memcpy(dst, str + from, str_len - from + 1);\n", c);
+    fputs("    }\n", c);
+    fputs("    free(cocok);\n", c);
+    fputs("    return result;\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("bool string_ngandhut(const char* str, const char* needle) {\n", c);
+    fputs("    return str && needle && string_golek(str, strlen(str), needle, strlen(needle)) != NULL;\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("bool string_miwiti(const char* str, const char* prefix) {\n", c);
+    fputs("    return str && prefix && strncmp(str, prefix, strlen(prefix)) == 0;\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("bool string_mungkasi(const char* str, const char* suffix) {\n", c);
+    fputs("    return str && suffix && string_mungkasi_n(str, suffix, strlen(suffix));\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("int string_indexOf(const char* str, const char* search) {\n", c);
+    write_stat(c, stats, STAT_STRING_INDEXOF, NULL);
+    fputs("    if (!str || !search) return -1;\n", c);
+    fputs("    const char* pos = string_golek(str, strlen(str), search, strlen(search));\n", c);
+    fputs("    return pos ? (int)string_utf8_chars(str, pos - str) : -1;\n", c);
+    fputs("}\n\n", c);
+    
     fputs("char* string_concat(const char* a, const char* b) {\n", c);
     fputs("    if (!a) a = \"\";\n", c);
     fputs("    if (!b) b = \"\";\n", c);
     fputs("    int len_a = strlen(a);\n", c);
     fputs("    int len_b = strlen(b);\n", c);
+    write_stat(c, stats, STAT_STRING_CONCAT, "len_a + len_b + 1");
     fputs("    char* result = malloc(len_a + len_b + 1);\n", c);
     fputs("    strcpy(result, a);\n", c);
     fputs("    strcat(result, b);\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
-    // Add int_to_string implementation - Enhanced for large numbers
+    // Number conversions format into a stack buffer and copy the digits
+    // into the runtime's string arena; no sprintf, no malloc per call
     fputs("char* int_to_string(int value) {\n", c);
-    fputs("    char* result = malloc(32);\n", c);
-    fputs("    sprintf(result, \"%d\", value);\n", c);
-    fputs("    return result;\n", c);
+    write_stat(c, stats, STAT_INT_TO_STRING, NULL);
+    fputs("    char buf[24];\n", c);
+    fputs("    return string_arena_dup(buf, string_tulis_int(buf, value));\n", c);
     fputs("}\n\n", c);
     
-    // Add long_to_string implementation for large integers
     fputs("char* long_to_string(long long value) {\n", c);
-    fputs("    char* result = malloc(32);\n", c);
-    fputs("    sprintf(result, \"%lld\", value);\n", c);
-    fputs("    return result;\n", c);
+    write_stat(c, stats, STAT_INT_TO_STRING, NULL);
+    fputs("    char buf[24];\n", c);
+    fputs("    return string_arena_dup(buf, string_tulis_int(buf, value));\n", c);
     fputs("}\n\n", c);
     
-    // Add double_to_string implementation - Enhanced  
+    // Shortest digits that read back as the same double; whole numbers
+    // still print without a decimal point
     fputs("char* double_to_string(double value) {\n", c);
-    fputs("    char* result = malloc(32);\n", c);
-    fputs("    // Check if it's a whole number larger than int range\n", c);
-    fputs("    if (value == (long long)value && (value > 2147483647.0 || value < -2147483648.0)) {\n", c);
-    fputs("        sprintf(result, \"%.0f\", value);  // Print as integer without decimal\n", c);
-    fputs("    } else if (value == (long long)value) {\n", c);
-    fputs("        sprintf(result, \"%.0f\", value);  // Print small integers without decimal\n", c); 
-    fputs("    } else {\n", c);
-    fputs("        sprintf(result, \"%.2f\", value);  // Print decimals normally\n", c);
+    write_stat(c, stats, STAT_DOUBLE_TO_STRING, NULL);
+    fputs("    char buf[32];\n", c);
+    fputs("    return string_arena_dup(buf, string_tulis_double(buf, value));\n", c);
+    fputs("}\n\n", c);
+    
+    // String to number; text that is not a number (or NaN) gives 0 and
+    // values outside int saturate instead of overflowing the cast
+    fputs("int string_toInt(const char* str) {\n", c);
+    write_stat(c, stats, STAT_STRING_TO_NUMBER, NULL);
+    fputs("    long long v;\n", c);
+    fputs("    double d;\n", c);
+    fputs("    if (str && string_maca_int(str, strlen(str), &v)) {\n", c);
+    fputs("        return v > INT_MAX ? INT_MAX : v < INT_MIN ? INT_MIN : (int)v;\n", c);
     fputs("    }\n", c);
-    fputs("    return result;\n", c);
+    fputs("    if (!str || !string_maca_double(str, strlen(str), &d) || d != d) return 0;\n", c);
+    fputs("    return d >= INT_MAX ? INT_MAX : d <= INT_MIN ? INT_MIN : (int)d;\n", c);
     fputs("}\n\n", c);
     
-    // Add string_split implementation
+    fputs("double string_toDouble(const char* str) {\n", c);
+    write_stat(c, stats, STAT_STRING_TO_NUMBER, NULL);
+    fputs("    double d;\n", c);
+    fputs("    if (str && string_maca_double(str, strlen(str), &d)) return d;\n", c);
+    fputs("    return 0.0;\n", c);
+    fputs("}\n\n", c);
+    
+    // Add string_split implementation; strspn/strcspn instead of strtok so
+    // tasks and parallel loops can split at the same time
     fputs("char** string_split(const char* str, const char* delimiter, int* count) {\n", c);
     fputs("    if (!str || !delimiter) { *count = 0; return NULL; }\n", c);
-    fputs("    char* str_copy = str_dup(str);\n", c);
-    fputs("    char** result = malloc(100 * sizeof(char*));\n", c);
+    write_stat(c, stats, STAT_STRING_SPLIT, NULL);
+    fputs("    int cap = 16;\n", c);
+    fputs("    char** result = malloc(cap * sizeof(char*));\n", c);
     fputs("    *count = 0;\n", c);
-    fputs("    char* token = strtok(str_copy, delimiter);\n", c);
-    fputs("    while (token != NULL && *count < 100) {\n", c);
-    fputs("        result[*count] = str_dup(token);\n", c);
-    fputs("        (*count)++;\n", c);
-    fputs("        token = strtok(NULL, delimiter);\n", c);
+    fputs("    const char* p = str + strspn(str, delimiter);\n", c);
+    fputs("    while (*p && result) {\n", c);
+    fputs("        size_t len = strcspn(p, delimiter);\n", c);
+    fputs("        if (*count == cap) {\n", c);
+    fputs("            cap *= 2;\n", c);
+    fputs("            char** grown = realloc(result, cap * sizeof(char*));\n", c);
+    fputs("            if (!grown) break;\n", c);
+    fputs("            result = grown;\n", c);
+    fputs("        }\n", c);
+    if (stats) fprintf(c, "        statistik_bait(%d, len + 1);\n", STAT_STRING_SPLIT);
+    fputs("        char* token = malloc(len + 1);\n", c);
+    fputs("        memcpy(token, p, len);\n", c);
+    fputs("        token[len] = 0;\n", c);
+    fputs("        result[(*count)++] = token;\n", c);
+    fputs("        p += len;\n", c);
+    fputs("        p += strspn(p, delimiter);\n", c);
+    fputs("    }\n", c);
+    fputs("    return result;\n", c);
+    fputs("}\n\n", c);
+    
+    // One delimiter byte: strchr finds each token end, no per-call set
+    fputs("char** string_split_char(const char* str, char delimiter, int* count) {\n", c);
+    fputs("    if (!str) { *count = 0; return NULL; }\n", c);
+    write_stat(c, stats, STAT_STRING_SPLIT, NULL);
+    fputs("    int cap = 16;\n", c);
+    fputs("    char** result = malloc(cap * sizeof(char*));\n", c);
+    fputs("    *count = 0;\n", c);
+    fputs("    const char* p = str;\n", c);
+    fputs("    while (delimiter && *p == delimiter) p++;\n", c);
+    fputs("    while (*p && result) {\n", c);
+    fputs("        const char* end = delimiter ? strchr(p, delimiter) : NULL;\n", c);
+    fputs("        size_t len = end ? (size_t)(end - p) : strlen(p);\n", c);
+    fputs("        if (*count == cap) {\n", c);
+    fputs("            cap *= 2;\n", c);
+    fputs("            char** grown = realloc(result, cap * sizeof(char*));\n", c);
+    fputs("            if (!grown) break;\n", c);
+    fputs("            result = grown;\n", c);
+    fputs("        }\n", c);
+    if (stats) fprintf(c, "        statistik_bait(%d, len + 1);\n", STAT_STRING_SPLIT);
+    fputs("        char* token = malloc(len + 1);\n", c);
+    fputs("        memcpy(token, p, len);\n", c);
+    fputs("        token[len] = 0;\n", c);
+    fputs("        result[(*count)++] = token;\n", c);
+    fputs("        p += len;\n", c);
+    fputs("        while (delimiter && *p == delimiter) p++;\n", c);
     fputs("    }\n", c);
-    fputs("    free(str_copy);\n", c);
     fputs("    return result;\n", c);
     fputs("}\n\n", c);
     
     // Add array functions
     fputs("JawaArray* create_array_literal_from_split(char** elements, int count) {\n", c);
+    write_stat(c, stats, STAT_ARRAY_SPLIT, "sizeof(JawaArray)");
     fputs("    if (!elements || count <= 0) {\n", c);
     fputs("        JawaArray* empty = malloc(sizeof(JawaArray));\n", c);
     fputs("        empty->data = NULL;\n", c);
@@ -741,20 +1879,515 @@ int build_native(const char *srcPath, const char *outPath) {
     fputs("    return arr ? arr->size : 0;\n", c);
     fputs("}\n\n", c);
     
-    fclose(in); 
-    fclose(c);
+    // Same algorithm as string_enhanced.c on the runtime's array layout:
+    // every element is measured once, the result allocated once
+    fputs("char* string_gabung_daftar(JawaArray* arr, const char* delimiter) {\n", c);
+    fputs("    int n = arr ? arr->size : 0;\n", c);
+    fputs("    size_t delim_len = delimiter ? strlen(delimiter) : 0;\n", c);
+    fputs("    size_t total = n > 1 ? delim_len * (size_t)(n - 1) : 0;\n", c);
+    fputs("    for (int i = 0; i < n; i++) if (arr->data[i]) total += strlen(arr->data[i]);\n", c);
+    fputs("    char* result = malloc(total + 1);\n", c);
+    fputs("    if (!result) return NULL;\n", c);
+    fputs("    char* cursor = result;\n", c);
+    fputs("    for (int i = 0; i < n; i++) {\n", c);
+    fputs("        if (i && delim_len) { memcpy(cursor, delimiter, delim_len); cursor += delim_len; }\n", c);
+    fputs("        if (arr->data[i]) { size_t len = strlen(arr->data[i]); memcpy(cursor, arr->data[i], len); cursor += len; }\n", c);
+    fputs("    }\n", c);
+    fputs("    *cursor = 0;\n", c);
+    fputs("    return result;\n", c);
+    fputs("}\n\n", c);
+    
+    fputs("char* string_ulang(const char* str, int count) {\n", c);
+    fputs("    size_t len = str && count > 0 ? strlen(str) : 0;\n", c);
+    fputs("    if (len && (size_t)count > (SIZE_MAX - 1) / len) return NULL;\n", c);
+    fputs("    size_t total = len * (size_t)(count > 0 ? count : 0);\n", c);
+    fputs("    char* result = malloc(total + 1);\n", c);
+    fputs("    if (!result) return NULL;\n", c);
+    fputs("    // Copy once, then double the filled prefix\n", c);
+    fputs("    size_t filled = 0;\n", c);
+    fputs("    if (len) { memcpy(result, str, len); filled = len; }\n", c);
+    fputs("    while (filled < total) {\n", c);
+    fputs("        size_t chunk = filled <= total - filled ? filled : total - filled;\n", c);
+    fputs("        memcpy(result + filled, result, chunk);\n", c);
+    fputs("        filled += chunk;\n", c);
+    fputs("    }\n", c);
+    fputs("    result[total] = 0;\n", c);
+    fputs("    return result;\n", c);
+    fputs("}\n\n", c);
+}
+
+// ---- Imported modules ----
+// `impor "x"` brings the functions of another .jw file into scope. Each
+// module is transpiled on its own against an interface header (preamble
+// plus the prototypes of the module and everything it imports), so its
+// objects are cached independently of the programs importing it. The
+// transpiled module is cached as well, keyed by its source and by the
+// async functions of its imports, the only outside input to codegen.
+
+#define MODULE_MAX 64
+// Bump whenever the generated C changes, so modules transpiled by an
+// older jawa are not reused. Kept explicit rather than tied to the build
+// time so that rebuilding jawa keeps the cache and builds stay reproducible.
+#define MODULE_CODEGEN_VERSION "2"
+#define MODULE_CACHE_SALT "jwm" MODULE_CODEGEN_VERSION
+
+typedef struct {
+    char *path;                 // canonical path
+    int deps[MODULE_MAX];
+    int dep_count;
+    char *protos;               // interface: prototypes of its functions
+    size_t protos_len;
+    AsyncFn async_fns[64];      // its own "gawe async" functions
+    int async_count;
+    BuildUnit *units;
+    int unit_count;
+    int state;                  // 0 new, 1 transpiling, 2 done
+} Module;
+
+typedef struct {
+    char *key;                  // "<importing dir>\n<spec>"
+    int mod;                    // -1 if not found
+} ResolvedImport;
+
+// Import graph of one build: every (directory, spec) pair is resolved
+// once and every file is scanned and transpiled once
+typedef struct {
+    Module mods[MODULE_MAX];
+    int count;
+    ResolvedImport *resolved;
+    int resolved_count;
+    bool lines;                 // emit #line directives (part of the cache key)
+} ImportGraph;
+
+static void dir_of(const char *path, char *dir, size_t dirsz) {
+    snprintf(dir, dirsz, "%s", path);
+    char *sep = strrchr(dir, '/');
+#ifdef _WIN32
+    char *bsep = strrchr(dir, '\\');
+    if (bsep > sep) sep = bsep;
+#endif
+    if (sep) *sep = 0;
+    else snprintf(dir, dirsz, ".");
+}
+
+static char *canonical_path(const char *path) {
+#ifdef _WIN32
+    char buf[FILENAME_MAX];
+    return strdup(_fullpath(buf, path, sizeof(buf)) ? buf : path);
+#else
+    char *real = realpath(path, NULL);
+    return real ? real : strdup(path);
+#endif
+}
+
+static bool scan_imports(ImportGraph *g, const char *path, int *deps, int *dep_count);
+
+static int import_resolve(ImportGraph *g, const char *from, const char *spec) {
+    char dir[FILENAME_MAX];
+    dir_of(from, dir, sizeof(dir));
+    size_t klen = strlen(dir) + strlen(spec) + 2;
+    char *key = malloc(klen);
+    if (!key) return -1;
+    snprintf(key, klen, "%s\n%s", dir, spec);
+    for (int i = 0; i < g->resolved_count; i++) {
+        if (strcmp(g->resolved[i].key, key) == 0) {
+            free(key);
+            return g->resolved[i].mod;
+        }
+    }
+
+    int m = -1;
+    bool added = false;
+    char *found = resolve_import_path(dir, spec);
+    if (found) {
+        char *canon = canonical_path(found);
+        free(found);
+        for (int i = 0; i < g->count && m < 0; i++) {
+            if (strcmp(g->mods[i].path, canon) == 0) m = i;
+        }
+        if (m >= 0 || g->count == MODULE_MAX) {
+            if (m < 0) fprintf(stderr, "Too many imported modules (max %d)\n", MODULE_MAX);
+            free(canon);
+        } else {
+            m = g->count++;
+            g->mods[m].path = canon;
+            added = true;
+        }
+    }
+
+    ResolvedImport *r = realloc(g->resolved, (g->resolved_count + 1) * sizeof(ResolvedImport));
+    if (r) {
+        g->resolved = r;
+        r[g->resolved_count].key = key;
+        r[g->resolved_count++].mod = m;
+    } else {
+        free(key);
+    }
+    // Scanned after it is recorded, so import cycles terminate
+    if (added && !scan_imports(g, g->mods[m].path, g->mods[m].deps, &g->mods[m].dep_count)) return -1;
+    return m;
+}
+
+// Collect the modules imported by path; false if one cannot be found
+static bool scan_imports(ImportGraph *g, const char *path, int *deps, int *dep_count) {
+    FILE *in = fopen(path, "r");
+    if (!in) return false;
+    char line[512], spec[256];
+    bool ok = true;
+    while (fgets(line, sizeof(line), in)) {
+        if (!import_spec(skip_ws(line), spec, sizeof(spec))) continue;
+        int m = import_resolve(g, path, spec);
+        if (m < 0) {
+            fprintf(stderr, "%s: impor \"%s\" not found\n", path, spec);
+            ok = false;
+        } else if (*dep_count < MODULE_MAX) {
+            deps[(*dep_count)++] = m;
+        }
+    }
+    fclose(in);
+    return ok;
+}
+
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    rewind(f);
+    char *text = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (text) {
+        *len = fread(text, 1, (size_t)size, f);
+        text[*len] = 0;
+    }
+    fclose(f);
+    return text;
+}
+
+// Cached module: "JWM1", then "A <ret> <name>" per async function,
+// "P <len>" + prototypes and "U <len> <name>" + text per unit
+static bool module_cache_load(Module *mod, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    char line[256];
+    bool ok = fgets(line, sizeof(line), f) && strcmp(line, "JWM1\n") == 0;
+    while (ok && fgets(line, sizeof(line), f)) {
+        char name[128];
+        size_t len;
+        int ret;
+        if (sscanf(line, "A %d %63s", &ret, name) == 2 && mod->async_count < 64) {
+            snprintf(mod->async_fns[mod->async_count].name, sizeof(mod->async_fns[0].name), "%s", name);
+            mod->async_fns[mod->async_count++].ret = (Ty)ret;
+        } else if (sscanf(line, "P %zu", &len) == 1 && !mod->protos) {
+            mod->protos = malloc(len + 1);
+            ok = mod->protos && fread(mod->protos, 1, len, f) == len;
+            if (ok) mod->protos[len] = 0;
+            mod->protos_len = len;
+        } else if (sscanf(line, "U %zu %63s", &len, name) == 2) {
+            BuildUnit *units = realloc(mod->units, (mod->unit_count + 1) * sizeof(BuildUnit));
+            ok = units != NULL;
+            if (!ok) break;
+            mod->units = units;
+            BuildUnit *u = &units[mod->unit_count];
+            snprintf(u->name, sizeof(u->name), "%s", name);
+            u->len = len;
+            u->header = 0;
+            u->text = malloc(len + 1);
+            ok = u->text && fread(u->text, 1, len, f) == len;
+            if (!ok) {
+                free(u->text);
+                break;
+            }
+            u->text[len] = 0;
+            mod->unit_count++;
+        } else {
+            ok = false;
+        }
+    }
+    fclose(f);
+    ok = ok && mod->protos;
+    if (!ok) {
+        free(mod->protos);
+        mod->protos = NULL;
+        for (int i = 0; i < mod->unit_count; i++) free(mod->units[i].text);
+        free(mod->units);
+        mod->units = NULL;
+        mod->unit_count = mod->async_count = 0;
+    }
+    return ok;
+}
+
+static void module_cache_store(const Module *mod, const char *path) {
+    char tmp[FILENAME_MAX];
+    snprintf(tmp, sizeof(tmp), "%s.%ld", path, (long)getpid());
+    FILE *f = fopen(tmp, "wb");
+    if (!f) return;
+    fputs("JWM1\n", f);
+    for (int i = 0; i < mod->async_count; i++) {
+        fprintf(f, "A %d %s\n", (int)mod->async_fns[i].ret, mod->async_fns[i].name);
+    }
+    fprintf(f, "P %zu\n", mod->protos_len);
+    fwrite(mod->protos, 1, mod->protos_len, f);
+    for (int i = 0; i < mod->unit_count; i++) {
+        fprintf(f, "U %zu %s\n", mod->units[i].len, mod->units[i].name);
+        fwrite(mod->units[i].text, 1, mod->units[i].len, f);
+    }
+    if (fclose(f) != 0 || rename(tmp, path) != 0) unlink(tmp);
+}
+
+// Transpile a module after its imports (cache may be NULL)
+static bool module_transpile(ImportGraph *g, int m, const char *cache) {
+    Module *mod = &g->mods[m];
+    if (mod->state) return true;  // done, or part of an import cycle
+    mod->state = 1;
+    for (int i = 0; i < mod->dep_count; i++) {
+        if (!module_transpile(g, mod->deps[i], cache)) return false;
+    }
+
+    size_t src_len = 0;
+    char *src = read_file(mod->path, &src_len);
+    if (!src) {
+        perror(mod->path);
+        return false;
+    }
+    uint64_t key = build_hash(BUILD_HASH_INIT, MODULE_CACHE_SALT, strlen(MODULE_CACHE_SALT));
+    key = build_hash(key, src, src_len);
+    if (g->lines) key = build_hash(key, "#line", 5);
+    free(src);
+    for (int i = 0; i < mod->dep_count; i++) {
+        const Module *dep = &g->mods[mod->deps[i]];
+        for (int k = 0; k < dep->async_count; k++) {
+            key = build_hash(key, dep->async_fns[k].name, strlen(dep->async_fns[k].name) + 1);
+            key = build_hash(key, &dep->async_fns[k].ret, sizeof(dep->async_fns[k].ret));
+        }
+    }
+    char cache_path[FILENAME_MAX];
+    if (cache) {
+        snprintf(cache_path, sizeof(cache_path), "%s/m%016llx.jwm", cache, (unsigned long long)key);
+        if (module_cache_load(mod, cache_path)) {
+            mod->state = 2;
+            return true;
+        }
+    }
+
+    FILE *in = fopen(mod->path, "r");
+    FILE *protos = build_stream_open();
+    if (!in || !protos) {
+        if (in) fclose(in);
+        if (protos) fclose(protos);
+        return false;
+    }
+    ParserContext mctx;
+    parser_init(&mctx);
+    for (int i = 0; i < mod->dep_count; i++) {
+        const Module *dep = &g->mods[mod->deps[i]];
+        for (int k = 0; k < dep->async_count; k++) {
+            parser_add_async(&mctx, dep->async_fns[k].name, dep->async_fns[k].ret);
+        }
+    }
+    int own_async = mctx.async_count;
+    if (g->lines) source_lines_init(in, &mctx, mod->path);
+    BuildPlan mp;
+    build_plan_init(&mp);
+    parse_function_definitions(in, protos, &mp, &mctx, false);
+    source_lines_free(&mctx);
+    fclose(in);
+    build_plan_set_header(&mp, protos);
+
+    mod->protos = mp.header;
+    mod->protos_len = mp.header_len;
+    mod->units = mp.units;
+    mod->unit_count = mp.count;
+    for (int k = own_async; k < mctx.async_count; k++) mod->async_fns[mod->async_count++] = mctx.async_fns[k];
+    mod->state = 2;
+    if (!mod->protos) return false;
+    if (cache) module_cache_store(mod, cache_path);
+    return true;
+}
+
+static void module_interface(const ImportGraph *g, int m, bool *seen, FILE *out) {
+    if (seen[m]) return;
+    seen[m] = true;
+    const Module *mod = &g->mods[m];
+    if (mod->protos) fwrite(mod->protos, 1, mod->protos_len, out);
+    for (int i = 0; i < mod->dep_count; i++) module_interface(g, mod->deps[i], seen, out);
+}
+
+// Transpile every module of the graph into the plan; their prototypes go
+// to the program header and their async functions into ctx
+static bool add_modules(ImportGraph *g, BuildPlan *plan, FILE *hdr, ParserContext *ctx) {
+    char cache[FILENAME_MAX];
+    bool have_cache = build_cache_dir(cache, sizeof(cache));
+    for (int m = 0; m < g->count; m++) {
+        if (!module_transpile(g, m, have_cache ? cache : NULL)) return false;
+    }
+    for (int m = 0; m < g->count; m++) {
+        Module *mod = &g->mods[m];
+        bool seen[MODULE_MAX] = {false};
+        FILE *h = build_stream_open();
+        if (!h) return false;
+        write_preamble(h);
+        module_interface(g, m, seen, h);
+        int id = build_plan_add_module_header(plan, h);
+        if (!id) return false;
+        for (int i = 0; i < mod->unit_count; i++) {
+            build_plan_add_unit_text(plan, id, mod->units[i].name, mod->units[i].text, mod->units[i].len);
+        }
+        fputs("// Imported from ", hdr);
+        fputs(mod->path, hdr);
+        fputs("\n", hdr);
+        if (mod->protos) fwrite(mod->protos, 1, mod->protos_len, hdr);
+        for (int k = 0; k < mod->async_count; k++) {
+            parser_add_async(ctx, mod->async_fns[k].name, mod->async_fns[k].ret);
+        }
+    }
+    return true;
+}
+
+static void import_graph_free(ImportGraph *g) {
+    for (int m = 0; m < g->count; m++) {
+        Module *mod = &g->mods[m];
+        free(mod->path);
+        free(mod->protos);
+        for (int i = 0; i < mod->unit_count; i++) free(mod->units[i].text);
+        free(mod->units);
+    }
+    for (int i = 0; i < g->resolved_count; i++) free(g->resolved[i].key);
+    free(g->resolved);
+}
+
+// Translate srcPath into a header and units; 0 on success, 1/2 on I/O errors.
+// With lines, statements carry #line directives pointing at the .jw source;
+// with stats, the runtime unit counts its calls (statistik.h). With
+// inline_small, small functions are defined in the shared header; since the
+// header is part of every unit's cache key, only release builds do that.
+static int generate_plan(const char *srcPath, BuildPlan *plan, bool lines, bool stats,
+                         bool inline_small) {
+    FILE *in = fopen(srcPath, "r");
+    if (!in) { 
+        perror("open src"); 
+        return 1; 
+    }
+    
+    FILE *hdr = build_stream_open();
+    if (!hdr) { 
+        perror("open c out"); 
+        fclose(in); 
+        return 2; 
+    }
 
-    // Compile C code
-    char cmd[8192];
-    snprintf(cmd, sizeof(cmd), "cc -O2 -std=c11 -o '%s' '%s' obj/file_ops.o", outPath, tmpc);
-    int rc = system(cmd);
-    if (rc != 0) {
-        fprintf(stderr, "Failed to build native binary (rc=%d)\n", rc);
-        unlink(tmpc);
-        return 3;
+    write_preamble(hdr);
+    
+    // Imported modules: resolved once per build, transpiled once per source
+    ImportGraph *graph = calloc(1, sizeof(ImportGraph));
+    int main_deps[MODULE_MAX], main_dep_count = 0;
+    ParserContext ctx;
+    parser_init(&ctx);
+    if (graph) graph->lines = lines;
+    if (!graph || !scan_imports(graph, srcPath, main_deps, &main_dep_count) ||
+        !add_modules(graph, plan, hdr, &ctx)) {
+        if (graph) import_graph_free(graph);
+        free(graph);
+        fclose(hdr);
+        fclose(in);
+        return 1;
+    }
+    import_graph_free(graph);
+    free(graph);
+    
+    // Parse classes first; structs go to the header, methods to one unit per class
+    parse_classes(in);
+    for (JawaClass *cls = g_classes; cls; cls = cls->next) {
+        generate_class_struct_c_code(hdr, cls);
+        FILE *u = build_stream_open();
+        if (!u) continue;
+        generate_class_methods_c_code(u, cls);
+        char name[64];
+        snprintf(name, sizeof(name), "bolo_%s", cls->name);
+        build_plan_add_unit(plan, name, u);
     }
     
-    // Clean up temporary C file
-    unlink(tmpc);
+    // Parse function definitions
+    if (lines) source_lines_init(in, &ctx, srcPath);
+    parse_function_definitions(in, hdr, plan, &ctx, inline_small);
+    
+    // Parse main program
+    FILE *m = build_stream_open();
+    if (m) {
+        parse_main_program(in, m, plan, &ctx);
+        build_plan_add_unit(plan, "main", m);
+    }
+    source_lines_free(&ctx);
+    
+    FILE *rt = build_stream_open();
+    if (rt) {
+        write_runtime(rt, stats);
+        build_plan_add_unit(plan, "runtime", rt);
+    }
+    
+    build_plan_set_header(plan, hdr);
+    fclose(in);
     return 0;
 }
+
+int build_native(const char *srcPath, const char *outPath) {
+    return build_native_with(srcPath, outPath, NULL);
+}
+
+int build_native_with(const char *srcPath, const char *outPath, const BuildOptions *opts) {
+    BuildPlan plan;
+    build_plan_init(&plan);
+    bool release = opts && opts->release;
+    bool profile = opts && opts->profile;
+    bool debug = opts && (opts->debug || profile);
+    if (release || debug) {
+        // Profiles use DWARF 4: addr2line from binutils 2.40 reports the
+        // .c name instead of the #line file for DWARF 5 line tables
+        char cflags[128], ldflags[128];
+        snprintf(cflags, sizeof(cflags), "%s%s", release ? BUILD_RELEASE_CFLAGS : BUILD_CFLAGS,
+                 profile ? " -gdwarf-4 -fno-omit-frame-pointer" : debug ? " -g" : "");
+        snprintf(ldflags, sizeof(ldflags), "%s%s", release ? BUILD_RELEASE_LDFLAGS : BUILD_LDFLAGS,
+                 profile ? " -gdwarf-4 obj/profil.o" : debug ? " -g" : "");
+        build_plan_set_flags(&plan, cflags, ldflags);
+    }
+    int rc = generate_plan(srcPath, &plan, debug, opts && opts->stats, release);
+    
+    // Compile changed units and link
+    if (rc == 0 && opts && opts->pgo) rc = build_plan_pgo(&plan, outPath, opts->train, opts->train_input);
+    else if (rc == 0) rc = build_plan_link(&plan, outPath);
+    build_plan_free(&plan);
+    return rc;
+}
+
+int run_native(const char *srcPath, int argc, char **argv) {
+#ifdef JAWA_WITH_TCC
+    // Compile in memory and call main directly
+    BuildPlan plan;
+    build_plan_init(&plan);
+    int rc = generate_plan(srcPath, &plan, false, false, false);
+    if (rc == 0) rc = build_plan_run(&plan, argc, argv);
+    build_plan_free(&plan);
+    return rc;
+#else
+    (void)argc;
+    (void)argv;
+    char temp_out[FILENAME_MAX];
+    snprintf(temp_out, sizeof(temp_out), "%s.temp.bin", srcPath);
+    
+    int rc = build_native(srcPath, temp_out);
+    if (rc != 0) return rc;
+    
+    // Jalankan file yang sudah dibuild
+#ifdef _WIN32
+    rc = system(temp_out);
+#else
+    char run_cmd[FILENAME_MAX + 16];
+    snprintf(run_cmd, sizeof(run_cmd), strchr(temp_out, '/') ? "'%s'" : "./'%s'", temp_out);
+    rc = system(run_cmd);
+    if (rc != -1 && WIFEXITED(rc)) rc = WEXITSTATUS(rc);
+#endif
+    
+    // Hapus file sementara
+    remove(temp_out);
+    return rc;
+#endif
+}
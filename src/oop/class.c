@@ -3,7 +3,11 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Global class registry
+#ifdef _WIN32
+#define strtok_r strtok_s
+#endif
+
+// Class registry of the current compilation
 JawaClass *g_classes = NULL;
 
 JawaClass* class_create(const char *name) {
@@ -97,6 +101,11 @@ void object_destroy(JawaObject *obj) {
 }
 
 void generate_class_c_code(FILE *out, JawaClass *cls) {
+    generate_class_struct_c_code(out, cls);
+    generate_class_methods_c_code(out, cls);
+}
+
+void generate_class_struct_c_code(FILE *out, JawaClass *cls) {
     if (!out || !cls) return;
     
     // Generate struct definition
@@ -120,6 +129,22 @@ void generate_class_c_code(FILE *out, JawaClass *cls) {
     
     fprintf(out, "} %s;\n\n", cls->name);
     
+    // Method prototypes, so other units can call them
+    JawaMethod *method = cls->methods;
+    while (method) {
+        fprintf(out, "%s %s_%s(%s* this", method->return_type, cls->name, method->name, cls->name);
+        if (strlen(method->params) > 0) {
+            fprintf(out, ", %s", method->params);
+        }
+        fprintf(out, ");\n");
+        method = method->next;
+    }
+    if (cls->methods) fprintf(out, "\n");
+}
+
+void generate_class_methods_c_code(FILE *out, JawaClass *cls) {
+    if (!out || !cls) return;
+    
     // Generate methods
     JawaMethod *method = cls->methods;
     while (method) {
@@ -133,11 +158,12 @@ void generate_class_c_code(FILE *out, JawaClass *cls) {
         char body_copy[2048];
         strcpy(body_copy, method->body);
         
-        char *line = strtok(body_copy, "\n");
+        char *save = NULL;
+        char *line = strtok_r(body_copy, "\n", &save);
         while (line) {
             // Skip closing braces that are part of method boundary  
             if (strcmp(line, "}") == 0 || strcmp(line, "    }") == 0) {
-                line = strtok(NULL, "\n");
+                line = strtok_r(NULL, "\n", &save);
                 continue;
             }
             
@@ -170,7 +196,7 @@ void generate_class_c_code(FILE *out, JawaClass *cls) {
             }
             fprintf(out, "\n");
             
-            line = strtok(NULL, "\n");
+            line = strtok_r(NULL, "\n", &save);
         }
         
         fprintf(out, "}\n\n");
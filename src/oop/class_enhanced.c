@@ -6,19 +6,89 @@
 #include <stdarg.h>
 #include <ctype.h>
 
-// Registry untuk instance tracking
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+#endif
+
+// Registry kelas hanya bertambah: kelas yang sudah lengkap dipasang di
+// depan lewat CAS (release) dan pembaca mengikuti next tanpa kunci
+// (acquire). Registry instance juga bisa dihapus, jadi dijaga mutex.
 static JawaObjectEx *g_instance_registry_ex = NULL;
+#ifndef _WIN32
+static _Atomic(JawaClass *) g_class_registry_ex = NULL;
+static pthread_mutex_t g_instance_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t g_default_once = PTHREAD_ONCE_INIT;
+#else
 static JawaClass *g_class_registry_ex = NULL;  // Registry untuk kelas
+#endif
 
 // Forward declaration untuk fungsi pendaftaran kelas
 static void register_default_classes_ex();
 
+static JawaClass *registry_head(void) {
+#ifndef _WIN32
+    return atomic_load_explicit(&g_class_registry_ex, memory_order_acquire);
+#else
+    return g_class_registry_ex;
+#endif
+}
+
+static void registry_push(JawaClass *cls) {
+#ifndef _WIN32
+    JawaClass *head = atomic_load_explicit(&g_class_registry_ex, memory_order_relaxed);
+    do {
+        cls->next = head;
+    } while (!atomic_compare_exchange_weak_explicit(&g_class_registry_ex, &head, cls,
+                                                    memory_order_release, memory_order_relaxed));
+#else
+    cls->next = g_class_registry_ex;
+    g_class_registry_ex = cls;
+#endif
+}
+
+static void instance_lock(void) {
+#ifndef _WIN32
+    pthread_mutex_lock(&g_instance_lock);
+#endif
+}
+
+static void instance_unlock(void) {
+#ifndef _WIN32
+    pthread_mutex_unlock(&g_instance_lock);
+#endif
+}
+
+// Kelas default didaftarkan sekali, walau dipanggil dari beberapa thread
+static void ensure_default_classes(void) {
+#ifndef _WIN32
+    pthread_once(&g_default_once, register_default_classes_ex);
+#else
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        register_default_classes_ex();
+    }
+#endif
+}
+
+static JawaClass *find_class(const char *name) {
+    // Cari di registry lokal dahulu
+    for (JawaClass *cls = registry_head(); cls; cls = cls->next) {
+        if (strcmp(cls->name, name) == 0) return cls;
+    }
+    
+    // Fallback ke registry global
+    for (JawaClass *cls = g_classes; cls; cls = cls->next) {
+        if (strcmp(cls->name, name) == 0) return cls;
+    }
+    return NULL;
+}
+
 // Alokasi object baru
 JawaObjectEx* object_create_ex(const char *class_name) {
     // Pastikan kelas default sudah terdaftar
-    if (g_class_registry_ex == NULL) {
-        register_default_classes_ex();
-    }
+    ensure_default_classes();
     
     JawaClass *cls = class_find_ex(class_name);
     if (!cls) {
@@ -33,8 +103,10 @@ JawaObjectEx* object_create_ex(const char *class_name) {
     obj->properties = NULL;
     
     // Menambahkan ke registry untuk garbage collection
+    instance_lock();
     obj->next = g_instance_registry_ex;
     g_instance_registry_ex = obj;
+    instance_unlock();
     
     // Alokasi properties berdasarkan definisi kelas
     JawaProperty *prop_def = cls->properties;
@@ -391,29 +463,8 @@ void object_set_property_ex(JawaObjectEx *obj, const char *prop_name, JawaValueE
 // Mencari kelas berdasarkan nama
 JawaClass* class_find_ex(const char *name) {
     // Pastikan kelas default sudah terdaftar
-    if (g_class_registry_ex == NULL) {
-        register_default_classes_ex();
-    }
-    
-    // Cari di registry lokal dahulu
-    JawaClass *cls = g_class_registry_ex;
-    while (cls) {
-        if (strcmp(cls->name, name) == 0) {
-            return cls;
-        }
-        cls = cls->next;
-    }
-    
-    // Fallback ke registry global
-    cls = g_classes;
-    while (cls) {
-        if (strcmp(cls->name, name) == 0) {
-            return cls;
-        }
-        cls = cls->next;
-    }
-    
-    return NULL;
+    ensure_default_classes();
+    return find_class(name);
 }
 
 // Menghancurkan objek dan membebaskan memori
@@ -439,6 +490,7 @@ void object_destroy_ex(JawaObjectEx *obj) {
     }
     
     // Hapus dari registry
+    instance_lock();
     if (g_instance_registry_ex == obj) {
         g_instance_registry_ex = obj->next;
     } else {
@@ -450,6 +502,7 @@ void object_destroy_ex(JawaObjectEx *obj) {
             prev->next = obj->next;
         }
     }
+    instance_unlock();
     
     free(obj);
 }
@@ -472,27 +525,36 @@ void object_collect_garbage_ex() {
     // Dalam implementasi sebenarnya, ini akan menggunakan reference counting
     // atau mark-and-sweep. Untuk sekarang, kita bebaskan semua objek yang tak terpakai.
     
+    instance_lock();
     JawaObjectEx *obj = g_instance_registry_ex;
     while (obj) {
         JawaObjectEx *next = obj->next;
         // Di sini kita bisa melakukan cleanup untuk objek yang tidak lagi digunakan
         obj = next;
     }
+    instance_unlock();
 }
 
-// Mendaftarkan kelas baru
-JawaClass* class_register_ex(const char *name) {
+// Membuat kelas baru yang belum terlihat di registry
+JawaClass* class_new_ex(const char *name) {
     JawaClass *cls = malloc(sizeof(JawaClass));
     if (!cls) return NULL;
     
     memset(cls, 0, sizeof(JawaClass));
     strncpy(cls->name, name, sizeof(cls->name) - 1);
     cls->name[sizeof(cls->name) - 1] = 0;
-    
-    // Tambahkan ke registry
-    cls->next = g_class_registry_ex;
-    g_class_registry_ex = cls;
-    
+    return cls;
+}
+
+// Memasang kelas yang sudah lengkap ke registry
+void class_publish_ex(JawaClass *cls) {
+    if (cls) registry_push(cls);
+}
+
+// Mendaftarkan kelas baru
+JawaClass* class_register_ex(const char *name) {
+    JawaClass *cls = class_new_ex(name);
+    class_publish_ex(cls);
     return cls;
 }
 
@@ -531,27 +593,37 @@ void class_add_method_ex(JawaClass *cls, const char *name, const char *return_ty
 }
 
 // Mendaftarkan kelas default untuk demo
+// Inheritance antar kelas default; class_inherit_ex akan menunggu
+// pendaftaran default yang sedang berjalan ini
+static void inherit_default(JawaClass *child, const char *parent_name) {
+    if (child) child->parent = find_class(parent_name);
+}
+
+// Kelas default dipasang setelah properti, metode dan induknya lengkap
+
 static void register_default_classes_ex() {
     // Kelas Hewan
-    JawaClass *hewan = class_register_ex("Hewan");
+    JawaClass *hewan = class_new_ex("Hewan");
     class_add_property_ex(hewan, "umur", PROP_INT, true);
     class_add_property_ex(hewan, "jenis", PROP_STRING, false);
     class_add_method_ex(hewan, "constructor", "void");
     class_add_method_ex(hewan, "info", "string");
     class_add_method_ex(hewan, "suara", "string");
+    class_publish_ex(hewan);
     
     // Kelas Kucing
-    JawaClass *kucing = class_register_ex("Kucing");
+    JawaClass *kucing = class_new_ex("Kucing");
     class_add_property_ex(kucing, "warna", PROP_STRING, false);
     class_add_method_ex(kucing, "constructor", "void");
     class_add_method_ex(kucing, "suara", "string");
     class_add_method_ex(kucing, "info_lengkap", "string");
     
     // Set inheritance
-    class_inherit_ex(kucing, "Hewan");
+    inherit_default(kucing, "Hewan");
+    class_publish_ex(kucing);
     
     // Kelas untuk oop_demo.jw
-    JawaClass *kendaraan = class_register_ex("Kendaraan");
+    JawaClass *kendaraan = class_new_ex("Kendaraan");
     class_add_property_ex(kendaraan, "merek", PROP_STRING, true);
     class_add_property_ex(kendaraan, "tahun", PROP_INT, true);
     class_add_property_ex(kendaraan, "warna", PROP_STRING, false);
@@ -559,28 +631,32 @@ static void register_default_classes_ex() {
     class_add_method_ex(kendaraan, "infoLengkap", "string");
     class_add_method_ex(kendaraan, "getMerek", "string");
     class_add_method_ex(kendaraan, "setMerek", "void");
+    class_publish_ex(kendaraan);
     
-    JawaClass *mobil = class_register_ex("Mobil");
+    JawaClass *mobil = class_new_ex("Mobil");
     class_add_property_ex(mobil, "jumlahPintu", PROP_INT, true);
     class_add_property_ex(mobil, "bahanBakar", PROP_STRING, true);
     class_add_method_ex(mobil, "constructor", "void");
     class_add_method_ex(mobil, "infoLengkap", "string");
     class_add_method_ex(mobil, "getJumlahPintu", "int");
-    class_inherit_ex(mobil, "Kendaraan");
+    inherit_default(mobil, "Kendaraan");
+    class_publish_ex(mobil);
     
-    JawaClass *mobilSport = class_register_ex("MobilSport");
+    JawaClass *mobilSport = class_new_ex("MobilSport");
     class_add_property_ex(mobilSport, "kecepatanMaks", PROP_INT, true);
     class_add_property_ex(mobilSport, "waktuAkselerasi", PROP_DOUBLE, true);
     class_add_method_ex(mobilSport, "constructor", "void");
     class_add_method_ex(mobilSport, "infoLengkap", "string");
     class_add_method_ex(mobilSport, "hitungPerforma", "double");
-    class_inherit_ex(mobilSport, "Mobil");
+    inherit_default(mobilSport, "Mobil");
+    class_publish_ex(mobilSport);
     
-    JawaClass *perusahaan = class_register_ex("Perusahaan");
+    JawaClass *perusahaan = class_new_ex("Perusahaan");
     class_add_property_ex(perusahaan, "nama", PROP_STRING, false);
     class_add_property_ex(perusahaan, "produk", PROP_OBJECT, false);
     class_add_method_ex(perusahaan, "constructor", "void");
     class_add_method_ex(perusahaan, "infoPerusahaan", "string");
+    class_publish_ex(perusahaan);
 }
 
 // Untuk debugging
@@ -0,0 +1,492 @@
+#include "optimizer.h"
+#include "string_number.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+
+// Compile-time value of an emitted literal
+typedef enum { CV_INT, CV_DOUBLE, CV_BOOL, CV_STRING } ConstKind;
+
+typedef struct {
+    ConstKind kind;
+    long long i;      // CV_INT, CV_BOOL
+    double d;         // CV_DOUBLE
+    const char *s;    // CV_STRING: C literal text including quotes
+    int slen;
+} ConstVal;
+
+// Skip a C string literal starting at s[i] == '"'.
+// Returns the index just past the closing quote, or -1 if unterminated.
+static int skip_string_literal(const char *s, int len, int i) {
+    i++;
+    while (i < len) {
+        if (s[i] == '\\' && i + 1 < len) { i += 2; continue; }
+        if (s[i] == '"') return i + 1;
+        i++;
+    }
+    return -1;
+}
+
+// Index of the ')' matching the '(' at s[open], or -1
+static int match_paren(const char *s, int len, int open) {
+    int depth = 0;
+    for (int i = open; i < len; i++) {
+        if (s[i] == '"') {
+            i = skip_string_literal(s, len, i);
+            if (i < 0) return -1;
+            i--;
+            continue;
+        }
+        if (s[i] == '(') depth++;
+        else if (s[i] == ')' && --depth == 0) return i;
+    }
+    return -1;
+}
+
+static bool const_truth(const ConstVal *v, bool *truth) {
+    switch (v->kind) {
+        case CV_INT:
+        case CV_BOOL: *truth = v->i != 0; return true;
+        case CV_DOUBLE: *truth = v->d != 0.0; return true;
+        default: return false;
+    }
+}
+
+static double const_num(const ConstVal *v) {
+    return v->kind == CV_DOUBLE ? v->d : (double)v->i;
+}
+
+// Recognize a literal in emitted C text. Only forms the expression parser
+// itself produces are accepted: numbers, true/false, string literals,
+// and "(...)", "(-...)", "(!...)" wrappers around them.
+static bool const_parse(const char *s, int len, ConstVal *v) {
+    while (len > 0 && isspace((unsigned char)*s)) { s++; len--; }
+    while (len > 0 && isspace((unsigned char)s[len - 1])) len--;
+    if (len <= 0) return false;
+
+    if (s[0] == '(') {
+        if (match_paren(s, len, 0) != len - 1) return false;
+        return const_parse(s + 1, len - 2, v);
+    }
+
+    if (s[0] == '!') {
+        ConstVal inner;
+        bool truth;
+        if (!const_parse(s + 1, len - 1, &inner) || !const_truth(&inner, &truth)) return false;
+        v->kind = CV_BOOL;
+        v->i = !truth;
+        return true;
+    }
+
+    if (s[0] == '-') {
+        ConstVal inner;
+        if (!const_parse(s + 1, len - 1, &inner)) return false;
+        if (inner.kind == CV_INT && -inner.i <= INT_MAX) {
+            v->kind = CV_INT;
+            v->i = -inner.i;
+            return true;
+        }
+        if (inner.kind == CV_DOUBLE) {
+            v->kind = CV_DOUBLE;
+            v->d = -inner.d;
+            return true;
+        }
+        return false;
+    }
+
+    if (len == 4 && strncmp(s, "true", 4) == 0) { v->kind = CV_BOOL; v->i = 1; return true; }
+    if (len == 5 && strncmp(s, "false", 5) == 0) { v->kind = CV_BOOL; v->i = 0; return true; }
+
+    if (s[0] == '"') {
+        // One literal or several adjacent ones ("a" "b"), which C joins itself
+        int i = 0;
+        while (i < len) {
+            if (s[i] != '"') return false;
+            i = skip_string_literal(s, len, i);
+            if (i < 0) return false;
+            while (i < len && isspace((unsigned char)s[i])) i++;
+        }
+        v->kind = CV_STRING;
+        v->s = s;
+        v->slen = len;
+        return true;
+    }
+
+    if (isdigit((unsigned char)s[0]) || s[0] == '.') {
+        char num[64];
+        int dots = 0;
+        if (len >= (int)sizeof(num)) return false;
+        for (int i = 0; i < len; i++) {
+            if (s[i] == '.') dots++;
+            else if (!isdigit((unsigned char)s[i])) return false;
+        }
+        if (dots > 1) return false;
+        memcpy(num, s, len);
+        num[len] = 0;
+
+        if (dots) {
+            v->kind = CV_DOUBLE;
+            v->d = strtod(num, NULL);
+            return true;
+        }
+
+        // Leading zero means octal in C, and wide literals are not int
+        if (len > 1 && s[0] == '0') return false;
+        long long n = strtoll(num, NULL, 10);
+        if (n > INT_MAX) return false;
+        v->kind = CV_INT;
+        v->i = n;
+        return true;
+    }
+
+    return false;
+}
+
+// Shortest "%g" form that reads back as the same double
+static void format_double(char *buf, size_t bufsz, double d) {
+    snprintf(buf, bufsz, "%.15g", d);
+    if (strtod(buf, NULL) != d) snprintf(buf, bufsz, "%.17g", d);
+    if (!strpbrk(buf, ".e")) strncat(buf, ".0", bufsz - strlen(buf) - 1);
+}
+
+// Replace out[start .. *oi) with the literal for v
+static bool const_emit(char *out, size_t outsz, int *oi, int start, const ConstVal *v) {
+    char buf[4096];
+
+    switch (v->kind) {
+        case CV_INT:
+            snprintf(buf, sizeof(buf), v->i < 0 ? "(%lld)" : "%lld", v->i);
+            break;
+        case CV_BOOL:
+            strcpy(buf, v->i ? "true" : "false");
+            break;
+        case CV_DOUBLE: {
+            if (!isfinite(v->d)) return false;
+            char num[64];
+            format_double(num, sizeof(num), v->d);
+            snprintf(buf, sizeof(buf), signbit(v->d) ? "(%s)" : "%s", num);
+            break;
+        }
+        case CV_STRING:
+            // v->s may point into out, so copy before rewriting
+            if (v->slen >= (int)sizeof(buf)) return false;
+            memcpy(buf, v->s, v->slen);
+            buf[v->slen] = 0;
+            break;
+    }
+
+    if (start >= (int)outsz) return false;
+    *oi = start;
+    out[start] = 0;
+    sb_add(out, outsz, oi, "%s", buf);
+    return true;
+}
+
+bool fold_binary(char *out, size_t outsz, int *oi, int start, int lend, int rstart, TokKind op) {
+    ConstVal a, b, r;
+    if (!const_parse(out + start, lend - start, &a)) return false;
+    if (!const_parse(out + rstart, *oi - rstart, &b)) return false;
+    if (a.kind == CV_STRING || b.kind == CV_STRING) return false;
+
+    switch (op) {
+        case T_PLUS: case T_MINUS: case T_STAR: case T_SLASH: case T_PERCENT:
+            if (a.kind == CV_BOOL || b.kind == CV_BOOL) return false;
+            if (a.kind == CV_INT && b.kind == CV_INT) {
+                // Same semantics as the C int arithmetic we would have emitted
+                long long x = a.i, y = b.i, z;
+                if ((op == T_SLASH || op == T_PERCENT) && y == 0) return false;
+                switch (op) {
+                    case T_PLUS:  z = x + y; break;
+                    case T_MINUS: z = x - y; break;
+                    case T_STAR:  z = x * y; break;
+                    case T_SLASH: z = x / y; break;
+                    default:      z = x % y; break;
+                }
+                if (z > INT_MAX || z < INT_MIN) return false;
+                r.kind = CV_INT;
+                r.i = z;
+            } else {
+                if (op == T_PERCENT) return false;
+                double x = const_num(&a), y = const_num(&b);
+                r.kind = CV_DOUBLE;
+                switch (op) {
+                    case T_PLUS:  r.d = x + y; break;
+                    case T_MINUS: r.d = x - y; break;
+                    case T_STAR:  r.d = x * y; break;
+                    default:      r.d = x / y; break;
+                }
+            }
+            break;
+
+        case T_LT: case T_GT: case T_LE: case T_GE: case T_EQ: case T_NE: {
+            double x = const_num(&a), y = const_num(&b);
+            r.kind = CV_BOOL;
+            switch (op) {
+                case T_LT: r.i = x < y; break;
+                case T_GT: r.i = x > y; break;
+                case T_LE: r.i = x <= y; break;
+                case T_GE: r.i = x >= y; break;
+                case T_EQ: r.i = x == y; break;
+                default:   r.i = x != y; break;
+            }
+            break;
+        }
+
+        case T_AND: case T_OR: {
+            bool x, y;
+            if (!const_truth(&a, &x) || !const_truth(&b, &y)) return false;
+            r.kind = CV_BOOL;
+            r.i = op == T_AND ? (x && y) : (x || y);
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    return const_emit(out, outsz, oi, start, &r);
+}
+
+bool fold_constant(char *out, size_t outsz, int *oi, int start) {
+    ConstVal v;
+    if (!const_parse(out + start, *oi - start, &v)) return false;
+    return const_emit(out, outsz, oi, start, &v);
+}
+
+// Render a literal right operand the way the runtime conversion would
+static bool concat_piece(const ConstVal *v, Ty ty, char *buf, size_t bufsz) {
+    if (v->kind == CV_STRING) {
+        if (v->slen >= (int)bufsz) return false;
+        memcpy(buf, v->s, v->slen);
+        buf[v->slen] = 0;
+        return true;
+    }
+
+    if (ty == TY_INT && v->kind == CV_INT) {
+        snprintf(buf, bufsz, "\"%lld\"", v->i);
+        return true;
+    }
+
+    if (ty == TY_DOUBLE && (v->kind == CV_INT || v->kind == CV_DOUBLE)) {
+        // Mirrors double_to_string in the generated runtime
+        double d = const_num(v);
+        if (!isfinite(d)) return false;
+        char num[STRING_DOUBLE_MAX];
+        string_tulis_double(num, d);
+        snprintf(buf, bufsz, "\"%s\"", num);
+        return true;
+    }
+
+    if (ty == TY_BOOL) {
+        bool truth;
+        if (!const_truth(v, &truth)) return false;
+        snprintf(buf, bufsz, "\"%s\"", truth ? "true" : "false");
+        return true;
+    }
+
+    return false;
+}
+
+bool fold_string_concat(char *out, size_t outsz, int *oi, int start, const char *right, Ty right_ty) {
+    ConstVal a, b;
+    char piece[4096];
+    char folded[8192];
+    const char *left = out + start;
+    int left_len = *oi - start;
+
+    if (!const_parse(right, (int)strlen(right), &b)) return false;
+    if (!concat_piece(&b, right_ty, piece, sizeof(piece))) return false;
+
+    if (const_parse(left, left_len, &a)) {
+        if (a.kind != CV_STRING) return false;
+        snprintf(folded, sizeof(folded), "%.*s %s", a.slen, a.s, piece);
+    } else {
+        // string_concat(x, "a") + "b"  ->  string_concat(x, "a" "b")
+        static const char prefix[] = "string_concat(";
+        int plen = (int)sizeof(prefix) - 1;
+        if (left_len <= plen || strncmp(left, prefix, plen) != 0) return false;
+        if (match_paren(left, left_len, plen - 1) != left_len - 1) return false;
+
+        int depth = 0, comma = -1;
+        for (int i = plen; i < left_len - 1; i++) {
+            if (left[i] == '"') {
+                i = skip_string_literal(left, left_len, i);
+                if (i < 0) return false;
+                i--;
+            } else if (left[i] == '(') depth++;
+            else if (left[i] == ')') depth--;
+            else if (left[i] == ',' && depth == 0) comma = i;
+        }
+        if (comma < 0) return false;
+
+        ConstVal tail;
+        int tail_len = left_len - 1 - (comma + 1);
+        if (!const_parse(left + comma + 1, tail_len, &tail) || tail.kind != CV_STRING) return false;
+        snprintf(folded, sizeof(folded), "%.*s, %.*s %s)",
+                 comma, left, tail.slen, tail.s, piece);
+    }
+
+    if (start >= (int)outsz) return false;
+    *oi = start;
+    out[start] = 0;
+    sb_add(out, outsz, oi, "%s", folded);
+    return true;
+}
+
+int fold_condition(const char *expr) {
+    ConstVal v;
+    bool truth;
+    if (!const_parse(expr, (int)strlen(expr), &v) || !const_truth(&v, &truth)) return -1;
+    return truth ? 1 : 0;
+}
+
+// Runtime calls that return a newly allocated string nobody else holds
+static const char *const fresh_string_calls[] = {
+    "string_concat(", "string_replace(", "string_replace_n(", "string_substring(",
+    "string_toUpperCase(", "string_toLowerCase(",
+    "string_toUpperCase_inplace(", "string_toLowerCase_inplace(",
+    "int_to_string(", "long_to_string(", "double_to_string(",
+    "string_gabung_daftar(", "string_ulang(", "string_ganti_banyak(",
+};
+
+bool is_fresh_string(const char *expr, int len) {
+    for (size_t i = 0; i < sizeof(fresh_string_calls) / sizeof(fresh_string_calls[0]); i++) {
+        int n = (int)strlen(fresh_string_calls[i]);
+        if (len > n && strncmp(expr, fresh_string_calls[i], n) == 0) {
+            // The call must span the whole expression
+            return match_paren(expr, len, n - 1) == len - 1;
+        }
+    }
+    return false;
+}
+
+static HoistEntry *hoist_find_temp(ParserContext *ctx, const char *name) {
+    for (int i = 0; i < ctx->hoist_count; i++) {
+        if (strcmp(ctx->hoists[i].temp, name) == 0) return &ctx->hoists[i];
+    }
+    return NULL;
+}
+
+static bool is_identifier(const char *s) {
+    if (!*s || isdigit((unsigned char)*s)) return false;
+    for (; *s; s++) {
+        if (!is_ident_char((unsigned char)*s)) return false;
+    }
+    return true;
+}
+
+void hoist_call(ParserContext *ctx, char *buf, size_t bufsz, const char *const operands[], int n, Ty ty) {
+    // Same call already hoisted (or a candidate, while discovering)
+    for (int i = ctx->hoist_count - 1; i >= 0; i--) {
+        HoistEntry *h = &ctx->hoists[i];
+        if ((h->active || ctx->hoist_discover) && strcmp(h->call, buf) == 0) {
+            snprintf(buf, bufsz, "%s", h->temp);
+            return;
+        }
+    }
+
+    int max = (int)(sizeof(ctx->hoists) / sizeof(ctx->hoists[0]));
+    if (!ctx->hoist_discover || ctx->hoist_count >= max) return;
+    if (strlen(buf) >= sizeof(ctx->hoists[0].call)) return;
+
+    // Every operand must be a literal, a variable or another hoisted call
+    char deps[128] = "";
+    for (int i = 0; i < n; i++) {
+        const char *op = operands[i];
+        const char *dep = NULL;
+        if (op[0] == '"') continue;
+
+        HoistEntry *inner = hoist_find_temp(ctx, op);
+        if (inner) dep = inner->deps;
+        else if (is_identifier(op) && parser_get_var_type(ctx, op) != TY_UNK) dep = op;
+        else return;
+
+        if (strlen(deps) + strlen(dep) + 2 >= sizeof(deps)) return;
+        if (deps[0]) strcat(deps, " ");
+        strcat(deps, dep);
+    }
+
+    HoistEntry *h = &ctx->hoists[ctx->hoist_count++];
+    strcpy(h->call, buf);
+    strcpy(h->deps, deps);
+    snprintf(h->temp, sizeof(h->temp), "jw_inv_%d", ctx->hoist_serial++);
+    h->ty = ty;
+    h->active = false;
+    snprintf(buf, bufsz, "%s", h->temp);
+}
+
+static void add_name(char *names, size_t namesz, const char *name, int len) {
+    char key[132];
+    if (len <= 0 || len > 127) return;
+    snprintf(key, sizeof(key), " %.*s ", len, name);
+    if (strstr(names, key)) return;
+    if (strlen(names) + len + 2 >= namesz) return;
+    if (!names[0]) strcat(names, " ");
+    strncat(names, name, len);
+    strcat(names, " ");
+}
+
+void hoist_collect_mutations(const char *line, char *names, size_t namesz) {
+    int len = (int)strlen(line);
+    bool declares = false;
+
+    for (int i = 0; i < len; ) {
+        if (line[i] == '"') {
+            i = skip_string_literal(line, len, i);
+            if (i < 0) return;
+            continue;
+        }
+        if (!isalpha((unsigned char)line[i]) && line[i] != '_') { i++; continue; }
+
+        int start = i;
+        while (i < len && is_ident_char((unsigned char)line[i])) i++;
+        int word_len = i - start;
+
+        if ((word_len == 5 && strncmp(line + start, "owahi", 5) == 0) ||
+            (word_len == 7 && strncmp(line + start, "cendhak", 7) == 0) ||
+            (word_len == 4 && strncmp(line + start, "ajek", 4) == 0)) {
+            declares = true;
+            continue;
+        }
+
+        int j = i;
+        while (j < len && isspace((unsigned char)line[j])) j++;
+        bool assigned = (line[j] == '=' && line[j + 1] != '=') ||
+                        (line[j] == '+' && line[j + 1] == '+') ||
+                        (line[j] == '-' && line[j + 1] == '-');
+        if (declares || assigned) add_name(names, namesz, line + start, word_len);
+        declares = false;
+    }
+}
+
+static bool deps_mutated(const char *deps, const char *mutated) {
+    const char *p = deps;
+    while (*p) {
+        while (*p == ' ') p++;
+        const char *end = p;
+        while (*end && *end != ' ') end++;
+        if (end > p) {
+            char key[132];
+            snprintf(key, sizeof(key), " %.*s ", (int)(end - p), p);
+            if (strstr(mutated, key)) return true;
+        }
+        p = end;
+    }
+    return false;
+}
+
+void hoist_emit(ParserContext *ctx, int base, const char *mutated, FILE *out) {
+    int keep = base;
+    for (int i = base; i < ctx->hoist_count; i++) {
+        HoistEntry h = ctx->hoists[i];
+        if (deps_mutated(h.deps, mutated)) continue;
+
+        fprintf(out, "%s %s = %s;\n", h.ty == TY_INT ? "int" : "const char*", h.temp, h.call);
+        h.active = true;
+        ctx->hoists[keep++] = h;
+    }
+    ctx->hoist_count = keep;
+}
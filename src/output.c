@@ -0,0 +1,193 @@
+#include "output.h"
+#include "statistik.h"
+#include "string_number.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define isatty _isatty
+#define fileno _fileno
+#else
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+#define OUTPUT_SIZE (64 * 1024)
+
+static char out_buf[OUTPUT_SIZE];
+static size_t out_len;
+static bool out_ready;
+static bool out_baris;   // flush tiap akhir baris
+static _Thread_local CithakTangkapan* tangkapan;
+#ifndef _WIN32
+static pthread_mutex_t out_kunci = PTHREAD_MUTEX_INITIALIZER;
+static atomic_bool out_bareng;   // buffer dipakai bersama thread tugas
+#endif
+
+// Kunci buffer bila ada thread tugas; mengembalikan apakah dikunci
+static bool kunci(void) {
+#ifndef _WIN32
+    if (atomic_load_explicit(&out_bareng, memory_order_relaxed)) {
+        pthread_mutex_lock(&out_kunci);
+        return true;
+    }
+#endif
+    return false;
+}
+
+static void buka(bool dikunci) {
+#ifndef _WIN32
+    if (dikunci) pthread_mutex_unlock(&out_kunci);
+#else
+    (void)dikunci;
+#endif
+}
+
+static void flush_buf(void) {
+    if (out_len > 0) {
+        fwrite(out_buf, 1, out_len, stdout);
+        out_len = 0;
+    }
+    fflush(stdout);
+}
+
+static void siapkan(void) {
+    if (out_ready) return;
+    out_ready = true;
+    const char* mode = getenv("JAWA_STDOUT");
+    if (mode && strcmp(mode, "line") == 0) out_baris = true;
+    else if (mode && strcmp(mode, "full") == 0) out_baris = false;
+    else out_baris = isatty(fileno(stdout));
+    atexit(cithak_flush);
+}
+
+void cithak_flush(void) {
+    if (tangkapan) return;   // ditulis urut setelah loop paralel selesai
+    bool k = kunci();
+    flush_buf();
+    buka(k);
+}
+
+void cithak_tangkap(CithakTangkapan* t) {
+    tangkapan = t;
+}
+
+void cithak_bareng(void) {
+#ifndef _WIN32
+    atomic_store(&out_bareng, true);
+#endif
+}
+
+// Tempat untuk n byte di ujung tangkapan; NULL bila memori habis
+static char* ruang_tangkapan(size_t n) {
+    CithakTangkapan* t = tangkapan;
+    if (t->len + n > t->cap) {
+        size_t cap = t->cap ? t->cap * 2 : 256;
+        while (cap < t->len + n) cap *= 2;
+        char* data = realloc(t->data, cap);
+        if (!data) return NULL;
+        t->data = data;
+        t->cap = cap;
+    }
+    return t->data + t->len;
+}
+
+static void tulis(const char* s, size_t len) {
+    if (tangkapan) {
+        char* dst = ruang_tangkapan(len);
+        if (dst) {
+            memcpy(dst, s, len);
+            tangkapan->len += len;
+        }
+        return;
+    }
+    if (!out_ready) siapkan();
+    if (out_len + len > OUTPUT_SIZE) {
+        flush_buf();
+        if (len > OUTPUT_SIZE / 2) {
+            // Potongan besar langsung ke stdout tanpa disalin
+            fwrite(s, 1, len, stdout);
+            return;
+        }
+    }
+    memcpy(out_buf + out_len, s, len);
+    out_len += len;
+}
+
+void cithak_tulis(const char* s, size_t len) {
+    STATISTIK_PANGGIL(STAT_CITHAK);
+    STATISTIK_BAIT(STAT_CITHAK, len);
+    bool k = !tangkapan && kunci();
+    tulis(s, len);
+    buka(k);
+}
+
+// Menulis angka langsung ke ujung buffer aktif
+static void tulis_int(long long v) {
+    if (tangkapan) {
+        char* dst = ruang_tangkapan(STRING_INT_MAX);
+        if (dst) tangkapan->len += string_tulis_int(dst, v);
+        return;
+    }
+    if (out_len + STRING_INT_MAX > OUTPUT_SIZE) flush_buf();
+    out_len += string_tulis_int(out_buf + out_len, v);
+}
+
+static void tulis_double(double v) {
+    if (tangkapan) {
+        char* dst = ruang_tangkapan(STRING_DOUBLE_MAX);
+        if (dst) tangkapan->len += string_tulis_double(dst, v);
+        return;
+    }
+    if (out_len + STRING_DOUBLE_MAX > OUTPUT_SIZE) flush_buf();
+    out_len += string_tulis_double(out_buf + out_len, v);
+}
+
+void cithak_format(const char* pola, ...) {
+    // Satu statement cithak ditulis utuh walau beberapa tugas mencetak
+    STATISTIK_PANGGIL(STAT_CITHAK);
+    bool k = !tangkapan && kunci();
+    if (!tangkapan && !out_ready) siapkan();
+    va_list ap;
+    va_start(ap, pola);
+    const char* p = pola;
+    while (*p) {
+        const char* q = strchr(p, '%');
+        if (!q) {
+            tulis(p, strlen(p));
+            break;
+        }
+        if (q > p) tulis(p, (size_t)(q - p));
+        switch (q[1]) {
+            case 's': {
+                // NULL dicetak kosong, sama seperti string_concat
+                const char* s = va_arg(ap, const char*);
+                if (s) tulis(s, strlen(s));
+                break;
+            }
+            case 'i':
+                tulis_int(va_arg(ap, long long));
+                break;
+            case 'f':
+                tulis_double(va_arg(ap, double));
+                break;
+            case 'b':
+                if (va_arg(ap, int)) tulis("true", 4);
+                else tulis("false", 5);
+                break;
+            default:
+                tulis(q + 1, q[1] ? 1 : 0);
+                break;
+        }
+        if (!q[1]) break;
+        p = q + 2;
+    }
+    va_end(ap);
+    if (out_baris && !tangkapan && out_len > 0 && out_buf[out_len - 1] == '\n') flush_buf();
+    buka(k);
+}
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
 #include <dirent.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -12,29 +13,27 @@
 #include "lexer.h"
 #include "native.h"
 #include "statements.h"
+#include "package_manager.h"
+#include "paket_zip.h"
+#include "paralel.h"
 
 #ifdef _WIN32
 #include <windows.h>
 #define JAWA_HOME_ENV "JAWA_HOME"
+#define JAWA_REGISTRI_ENV "JAWA_REGISTRI"
+#define JAWA_SIMPEN_ENV "JAWA_SIMPEN"
 #define PATH_SEPARATOR "\\"
 #define mkdir(path, mode) mkdir(path)
+#define lstat stat
 #elif defined(__APPLE__) || defined(__linux__)
 #define JAWA_HOME_ENV "JAWA_HOME"
+#define JAWA_REGISTRI_ENV "JAWA_REGISTRI"
+#define JAWA_SIMPEN_ENV "JAWA_SIMPEN"
 #define PATH_SEPARATOR "/"
 #endif
 
-// Struktur untuk menyimpan informasi paket
-typedef struct {
-    char *nama;
-    char *versi;
-    char *deskripsi;
-    char *penulis;
-    char **file_daftar;
-    int file_count;
-    char *entry_point;
-    char **dependencies;
-    int dep_count;
-} JawaPaket;
+// Direktori paket lokal proyek, diisi "jawa paket pasang"
+#define PAKET_PROYEK_DIR "paket_jawa"
 
 // Fungsi untuk mengunduh file dari URL
 size_t write_callback(void *ptr, size_t size, size_t nmemb, FILE *stream) {
@@ -126,37 +125,24 @@ char *get_jawa_packages_dir() {
     return packages_dir;
 }
 
-// Parse file konfigurasi paket
-JawaPaket *parse_paket_json(const char *json_path) {
-    FILE *fp;
-    struct json_object *parsed_json;
-    struct json_object *nama, *versi, *deskripsi, *penulis, *berkas, *titik_masuk, *ketergantungan;
-    
-    fp = fopen(json_path, "r");
-    if (!fp) {
-        fprintf(stderr, "Gagal membuka file paket.json: %s\n", json_path);
-        return NULL;
-    }
-    
-    fseek(fp, 0, SEEK_END);
-    long file_size = ftell(fp);
-    fseek(fp, 0, SEEK_SET);
-    
-    char *json_str = malloc(file_size + 1);
-    if (!json_str) {
-        fprintf(stderr, "Gagal mengalokasikan memori\n");
-        fclose(fp);
-        return NULL;
+// Ambil string properti; properti yang tidak ada menjadi ""
+static char *teks_json(struct json_object *obj, const char *kunci) {
+    struct json_object *nilai;
+    const char *s = NULL;
+    if (json_object_object_get_ex(obj, kunci, &nilai)) {
+        s = json_object_get_string(nilai);
     }
-    
-    fread(json_str, 1, file_size, fp);
-    fclose(fp);
-    json_str[file_size] = '\0';
+    return strdup(s ? s : "");
+}
+
+// Parse isi paket.json yang sudah ada di memori
+JawaPaket *parse_paket_json_teks(const char *json_str) {
+    struct json_object *parsed_json;
+    struct json_object *berkas, *ketergantungan;
     
     parsed_json = json_tokener_parse(json_str);
     if (!parsed_json) {
         fprintf(stderr, "Gagal mengurai JSON\n");
-        free(json_str);
         return NULL;
     }
     
@@ -164,28 +150,23 @@ JawaPaket *parse_paket_json(const char *json_path) {
     if (!paket) {
         fprintf(stderr, "Gagal mengalokasikan memori untuk paket\n");
         json_object_put(parsed_json);
-        free(json_str);
         return NULL;
     }
     
     // Mengambil properti dasar
-    json_object_object_get_ex(parsed_json, "nama", &nama);
-    json_object_object_get_ex(parsed_json, "versi", &versi);
-    json_object_object_get_ex(parsed_json, "deskripsi", &deskripsi);
-    json_object_object_get_ex(parsed_json, "penulis", &penulis);
-    json_object_object_get_ex(parsed_json, "berkas", &berkas);
-    json_object_object_get_ex(parsed_json, "titik_masuk", &titik_masuk);
-    
-    paket->nama = strdup(json_object_get_string(nama));
-    paket->versi = strdup(json_object_get_string(versi));
-    paket->deskripsi = strdup(json_object_get_string(deskripsi));
-    paket->penulis = strdup(json_object_get_string(penulis));
-    paket->entry_point = strdup(json_object_get_string(titik_masuk));
+    paket->nama = teks_json(parsed_json, "nama");
+    paket->versi = teks_json(parsed_json, "versi");
+    paket->deskripsi = teks_json(parsed_json, "deskripsi");
+    paket->penulis = teks_json(parsed_json, "penulis");
+    paket->entry_point = teks_json(parsed_json, "titik_masuk");
     
     // Mengambil daftar berkas
-    int berkas_count = json_object_array_length(berkas);
+    int berkas_count = 0;
+    if (json_object_object_get_ex(parsed_json, "berkas", &berkas)) {
+        berkas_count = json_object_array_length(berkas);
+    }
     paket->file_count = berkas_count;
-    paket->file_daftar = malloc(sizeof(char*) * berkas_count);
+    paket->file_daftar = malloc(sizeof(char*) * (berkas_count + 1));
     
     for (int i = 0; i < berkas_count; i++) {
         struct json_object *file_obj = json_object_array_get_idx(berkas, i);
@@ -205,7 +186,7 @@ JawaPaket *parse_paket_json(const char *json_path) {
         }
         
         paket->dep_count = dep_count;
-        paket->dependencies = malloc(sizeof(char*) * dep_count);
+        paket->dependencies = malloc(sizeof(char*) * (dep_count + 1));
         
         // Now iterate again to get the values
         int idx = 0;
@@ -213,10 +194,11 @@ JawaPaket *parse_paket_json(const char *json_path) {
         
         while (!json_object_iter_equal(&it, &it_end)) {
             const char *key = json_object_iter_peek_name(&it);
-            struct json_object *val = json_object_iter_peek_value(&it);
+            const char *spes = json_object_get_string(json_object_iter_peek_value(&it));
+            if (!spes) spes = "";
             
-            char *dep_str = malloc(strlen(key) + strlen(json_object_get_string(val)) + 2);
-            sprintf(dep_str, "%s@%s", key, json_object_get_string(val));
+            char *dep_str = malloc(strlen(key) + strlen(spes) + 2);
+            sprintf(dep_str, "%s@%s", key, spes);
             paket->dependencies[idx++] = dep_str;
             
             json_object_iter_next(&it);
@@ -227,65 +209,708 @@ JawaPaket *parse_paket_json(const char *json_path) {
     }
     
     json_object_put(parsed_json);
+    return paket;
+}
+
+// Parse file konfigurasi paket
+JawaPaket *parse_paket_json(const char *json_path) {
+    FILE *fp;
+    
+    fp = fopen(json_path, "r");
+    if (!fp) {
+        fprintf(stderr, "Gagal membuka file paket.json: %s\n", json_path);
+        return NULL;
+    }
+    
+    fseek(fp, 0, SEEK_END);
+    long file_size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    
+    char *json_str = malloc(file_size + 1);
+    if (!json_str) {
+        fprintf(stderr, "Gagal mengalokasikan memori\n");
+        fclose(fp);
+        return NULL;
+    }
+    
+    size_t n = fread(json_str, 1, file_size, fp);
+    fclose(fp);
+    json_str[n] = '\0';
+    
+    JawaPaket *paket = parse_paket_json_teks(json_str);
     free(json_str);
     return paket;
 }
 
-// Pasang paket
-int pasang_paket(const char *nama_paket, const char *versi) {
-    char *packages_dir = get_jawa_packages_dir();
-    if (!packages_dir) {
-        return 0;
+// ---- Resolusi ketergantungan ----
+// Registri lokal berupa direktori <registri>/<nama>/<versi>.zip. Tiap
+// arsip boleh berisi paket.json dengan "ketergantungan"-nya sendiri.
+
+typedef struct {
+    long mayor, minor, patch;
+} Versi;
+
+// "1.2.3", "1.2" atau "1"; sisa seperti "-beta" diabaikan
+static int versi_urai(const char *s, Versi *v) {
+    char *akhir;
+    v->mayor = v->minor = v->patch = 0;
+    if (*s < '0' || *s > '9') return 0;
+    v->mayor = strtol(s, &akhir, 10);
+    if (*akhir == '.') v->minor = strtol(akhir + 1, &akhir, 10);
+    if (*akhir == '.') v->patch = strtol(akhir + 1, &akhir, 10);
+    return 1;
+}
+
+static int versi_banding(const Versi *a, const Versi *b) {
+    if (a->mayor != b->mayor) return a->mayor < b->mayor ? -1 : 1;
+    if (a->minor != b->minor) return a->minor < b->minor ? -1 : 1;
+    if (a->patch != b->patch) return a->patch < b->patch ? -1 : 1;
+    return 0;
+}
+
+// Spesifikasi versi: kosong/"*"/"latest" (apa saja), "^1.2.0" (mayor sama,
+// untuk 0.x minor sama), "~1.2.0" (minor sama), ">=1.2.0", atau versi persis
+static int versi_cocok(const char *spes, const char *versi) {
+    Versi v, b;
+    if (!spes || !*spes || strcmp(spes, "*") == 0 || strcmp(spes, "latest") == 0) return 1;
+    if (!versi_urai(versi, &v)) return strcmp(spes, versi) == 0;
+    
+    char op = spes[0];
+    const char *dasar = spes;
+    if (op == '^' || op == '~') dasar++;
+    else if (op == '>' && spes[1] == '=') dasar += 2;
+    if (!versi_urai(dasar, &b)) return strcmp(spes, versi) == 0;
+    
+    if (versi_banding(&v, &b) < 0) return 0;
+    if (op == '^') return v.mayor == b.mayor && (b.mayor > 0 || v.minor == b.minor);
+    if (op == '~') return v.mayor == b.mayor && v.minor == b.minor;
+    if (op == '>') return 1;
+    return versi_banding(&v, &b) == 0;
+}
+
+typedef struct {
+    char nama[128];
+    char versi[64];
+    char spes[64];      // permintaan pertama, untuk pesan konflik
+    char oleh[128];     // paket yang memintanya
+    char arsip[512];
+    char sidik[65];     // SHA-256 arsip, dari paket.lock atau saat dipasang
+} Pilihan;
+
+typedef struct {
+    Pilihan *isi;
+    int n, cap;
+} Resolusi;
+
+static Pilihan *resolusi_cari(Resolusi *r, const char *nama) {
+    for (int i = 0; i < r->n; i++) {
+        if (strcmp(r->isi[i].nama, nama) == 0) return &r->isi[i];
     }
+    return NULL;
+}
+
+static Pilihan *resolusi_tambah(Resolusi *r) {
+    if (r->n == r->cap) {
+        r->cap = r->cap ? r->cap * 2 : 16;
+        r->isi = realloc(r->isi, sizeof(Pilihan) * r->cap);
+    }
+    Pilihan *p = &r->isi[r->n++];
+    memset(p, 0, sizeof(*p));
+    return p;
+}
+
+// Nama paket dipakai sebagai nama direktori: tidak boleh kosong atau
+// keluar dari direktori induknya
+static int nama_paket_sah(const char *nama) {
+    return nama[0] != '\0' && !strchr(nama, '/') && !strchr(nama, '\\') &&
+           !strstr(nama, "..");
+}
+
+// Versi di registri yang cocok dengan spes. Versi dari lockfile dipakai
+// bila masih cocok, selain itu versi tertinggi.
+static int registri_pilih(const char *registri, const char *nama, const char *spes,
+                          const char *terkunci, char *versi, size_t ukuran) {
+    if (!nama_paket_sah(nama)) return 0;
+    char dir_path[512];
+    snprintf(dir_path, sizeof(dir_path), "%s%s%s", registri, PATH_SEPARATOR, nama);
+    DIR *dir = opendir(dir_path);
+    if (!dir) return 0;
     
-    // Buat URL untuk mengunduh paket (contoh implementasi)
-    char url[512];
-    sprintf(url, "https://jawa-packages.example.com/%s/%s.zip", nama_paket, versi ? versi : "latest");
+    int ketemu = 0;
+    Versi terbaik = {0, 0, 0};
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        size_t n = strlen(ent->d_name);
+        if (n < 5 || n - 4 >= ukuran || strcmp(ent->d_name + n - 4, ".zip") != 0) continue;
+        
+        char calon[64];
+        memcpy(calon, ent->d_name, n - 4);
+        calon[n - 4] = '\0';
+        if (!versi_cocok(spes, calon)) continue;
+        if (terkunci && strcmp(calon, terkunci) == 0) {
+            snprintf(versi, ukuran, "%s", calon);
+            ketemu = 2;
+            break;
+        }
+        
+        Versi v;
+        if (!versi_urai(calon, &v)) continue;
+        if (!ketemu || versi_banding(&v, &terbaik) > 0) {
+            terbaik = v;
+            snprintf(versi, ukuran, "%s", calon);
+            ketemu = 1;
+        }
+    }
+    closedir(dir);
+    return ketemu;
+}
+
+// Mencatat satu ketergantungan "nama@spes". Satu paket hanya boleh punya
+// satu versi; permintaan yang tidak cocok dengan versi terpilih = konflik.
+static int minta_paket(Resolusi *r, const Resolusi *kunci, const char *registri,
+                       const char *dep, const char *oleh) {
+    char nama[128];
+    const char *at = strrchr(dep, '@');
+    const char *spes = "";
+    size_t nama_len = strlen(dep);
+    if (at && at != dep) {
+        nama_len = at - dep;
+        spes = at + 1;
+    }
+    if (nama_len >= sizeof(nama)) {
+        fprintf(stderr, "Nama paket terlalu panjang: %s\n", dep);
+        return 0;
+    }
+    memcpy(nama, dep, nama_len);
+    nama[nama_len] = '\0';
+    if (!nama_paket_sah(nama)) {
+        fprintf(stderr, "Nama paket tidak sah: \"%s\" (diminta %s)\n", nama, oleh);
+        return 0;
+    }
     
-    // Buat path output
-    char output_path[512];
-    sprintf(output_path, "%s%s%s-%s.zip", packages_dir, PATH_SEPARATOR, nama_paket, versi ? versi : "latest");
+    Pilihan *ada = resolusi_cari(r, nama);
+    if (ada) {
+        if (versi_cocok(spes, ada->versi)) return 1;
+        fprintf(stderr, "Konflik versi %s: %s meminta %s, %s meminta %s (terpilih %s)\n",
+                nama, ada->oleh, ada->spes[0] ? ada->spes : "*", oleh,
+                spes[0] ? spes : "*", ada->versi);
+        return 0;
+    }
     
-    printf("Memasang paket %s (versi %s)...\n", nama_paket, versi ? versi : "latest");
+    const Pilihan *terkunci = NULL;
+    for (int i = 0; kunci && i < kunci->n; i++) {
+        if (strcmp(kunci->isi[i].nama, nama) == 0) terkunci = &kunci->isi[i];
+    }
     
-    // Unduh paket
-    if (!unduh_file(url, output_path)) {
-        fprintf(stderr, "Gagal mengunduh paket\n");
-        free(packages_dir);
+    char versi[64];
+    int pilih = registri_pilih(registri, nama, spes, terkunci ? terkunci->versi : NULL,
+                               versi, sizeof(versi));
+    if (!pilih) {
+        fprintf(stderr, "Paket %s@%s tidak ditemukan di registri %s (diminta %s)\n",
+                nama, spes[0] ? spes : "*", registri, oleh);
         return 0;
     }
     
-    // Ekstrak paket (implementasi sederhana)
-    char extract_cmd[1024];
+    Pilihan *p = resolusi_tambah(r);
+    snprintf(p->nama, sizeof(p->nama), "%s", nama);
+    snprintf(p->versi, sizeof(p->versi), "%s", versi);
+    snprintf(p->spes, sizeof(p->spes), "%s", spes);
+    snprintf(p->oleh, sizeof(p->oleh), "%s", oleh);
+    snprintf(p->arsip, sizeof(p->arsip), "%s%s%s%s%s.zip",
+             registri, PATH_SEPARATOR, nama, PATH_SEPARATOR, versi);
+    // Versi dari paket.lock: arsipnya harus sama persis dengan yang tercatat
+    if (pilih == 2) snprintf(p->sidik, sizeof(p->sidik), "%s", terkunci->sidik);
+    return 1;
+}
+
+// Resolusi melebar: paket langsung dulu, lalu ketergantungan tiap paket
+// terpilih dibaca dari paket.json di dalam arsipnya
+static int resolusi_hitung(Resolusi *r, const Resolusi *kunci, const char *registri,
+                           const char **deps, int dep_count, const char *akar) {
+    for (int i = 0; i < dep_count; i++) {
+        if (!minta_paket(r, kunci, registri, deps[i], akar)) return 0;
+    }
+    for (int i = 0; i < r->n; i++) {
+        char *json = zip_waca_berkas(r->isi[i].arsip, "paket.json", NULL);
+        if (!json) continue;
+        JawaPaket *paket = parse_paket_json_teks(json);
+        free(json);
+        if (!paket) continue;
+        
+        char oleh[128];
+        snprintf(oleh, sizeof(oleh), "%s", r->isi[i].nama);
+        int ok = 1;
+        for (int d = 0; ok && d < paket->dep_count; d++) {
+            ok = minta_paket(r, kunci, registri, paket->dependencies[d], oleh);
+        }
+        free_paket(paket);
+        if (!ok) return 0;
+    }
+    return 1;
+}
+
+static int banding_pilihan(const void *a, const void *b) {
+    return strcmp(((const Pilihan *)a)->nama, ((const Pilihan *)b)->nama);
+}
+
+// paket.lock: { "paket": { "<nama>": { "versi", "arsip", "sha256" } } }
+static void kunci_waca(const char *path, Resolusi *kunci) {
+    struct json_object *akar = json_object_from_file(path);
+    struct json_object *paket;
+    if (!akar) return;
+    if (json_object_object_get_ex(akar, "paket", &paket)) {
+        struct json_object_iterator it_end = json_object_iter_end(paket);
+        struct json_object_iterator it = json_object_iter_begin(paket);
+        for (; !json_object_iter_equal(&it, &it_end); json_object_iter_next(&it)) {
+            struct json_object *isi = json_object_iter_peek_value(&it);
+            struct json_object *versi, *sidik;
+            if (!json_object_object_get_ex(isi, "versi", &versi)) continue;
+            Pilihan *p = resolusi_tambah(kunci);
+            snprintf(p->nama, sizeof(p->nama), "%s", json_object_iter_peek_name(&it));
+            snprintf(p->versi, sizeof(p->versi), "%s", json_object_get_string(versi));
+            if (json_object_object_get_ex(isi, "sha256", &sidik)) {
+                snprintf(p->sidik, sizeof(p->sidik), "%s", json_object_get_string(sidik));
+            }
+        }
+    }
+    json_object_put(akar);
+}
+
+static int kunci_tulis(const char *path, const Resolusi *r, const char *registri) {
+    struct json_object *akar = json_object_new_object();
+    struct json_object *daftar = json_object_new_object();
+    size_t reg_len = strlen(registri);
+    for (int i = 0; i < r->n; i++) {
+        const Pilihan *p = &r->isi[i];
+        struct json_object *isi = json_object_new_object();
+        json_object_object_add(isi, "versi", json_object_new_string(p->versi));
+        json_object_object_add(isi, "arsip", json_object_new_string(p->arsip + reg_len + 1));
+        json_object_object_add(isi, "sha256", json_object_new_string(p->sidik));
+        json_object_object_add(daftar, p->nama, isi);
+    }
+    json_object_object_add(akar, "paket", daftar);
+    int ok = json_object_to_file_ext(path, akar, JSON_C_TO_STRING_PRETTY) == 0;
+    json_object_put(akar);
+    return ok;
+}
+
+// ---- Pemasangan ----
+// Arsip diekstrak sekali ke penyimpanan bersama <simpen>/<sha256>, lalu
+// pohon paket (global atau paket_jawa/ proyek) diisi hardlink ke sana.
+// Pemeriksaan isi (CRC tiap entri, sidik di paket.lock) hanya saat masuk.
+
 #ifdef _WIN32
-    sprintf(extract_cmd, "powershell -command \"Expand-Archive -Path '%s' -DestinationPath '%s%s%s'\"", 
-            output_path, packages_dir, PATH_SEPARATOR, nama_paket);
+#define tautan_keras(lama, anyar) (CreateHardLinkA(anyar, lama, NULL) ? 0 : -1)
 #else
-    sprintf(extract_cmd, "unzip -o '%s' -d '%s%s%s'", 
-            output_path, packages_dir, PATH_SEPARATOR, nama_paket);
+#define tautan_keras(lama, anyar) link(lama, anyar)
 #endif
+
+static int direktori_ada(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+// Penyimpanan paket bersama: $JAWA_SIMPEN atau ~/.jawa/simpen
+static char *get_jawa_store_dir(void) {
+    const char *env = getenv(JAWA_SIMPEN_ENV);
+    char *store_dir;
+    if (env && *env) {
+        store_dir = strdup(env);
+    } else {
+        char *packages_dir = get_jawa_packages_dir();
+        if (!packages_dir) return NULL;
+        // <home>/.jawa/paket -> <home>/.jawa/simpen
+        store_dir = malloc(strlen(packages_dir) + 2);
+        strcpy(store_dir, packages_dir);
+        strcpy(strrchr(store_dir, PATH_SEPARATOR[0]) + 1, "simpen");
+        free(packages_dir);
+    }
     
-    int result = system(extract_cmd);
-    if (result != 0) {
-        fprintf(stderr, "Gagal mengekstrak paket\n");
+    char indeks[512];
+    snprintf(indeks, sizeof(indeks), "%s%sindeks", store_dir, PATH_SEPARATOR);
+    if (!direktori_ada(store_dir)) mkdir(store_dir, 0755);
+    if (!direktori_ada(indeks)) mkdir(indeks, 0755);
+    return store_dir;
+}
+
+// Hapus direktori beserta isinya (tanpa rm -rf). Symlink dihapus
+// tautannya saja, isi tujuannya tidak disentuh.
+static int hapus_rekursif(const char *path) {
+    struct stat st;
+    if (lstat(path, &st) != 0) return errno == ENOENT;
+    if (!S_ISDIR(st.st_mode)) return unlink(path) == 0;
+    
+    DIR *dir = opendir(path);
+    if (!dir) return 0;
+    struct dirent *ent;
+    int ok = 1;
+    while ((ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        char anak[1024];
+        snprintf(anak, sizeof(anak), "%s%s%s", path, PATH_SEPARATOR, ent->d_name);
+        if (!hapus_rekursif(anak)) ok = 0;
+    }
+    closedir(dir);
+    return rmdir(path) == 0 && ok;
+}
+
+// Berkas di penyimpanan dibuat read-only: pohon paket berbagi inode yang sama
+static void kunci_berkas(const char *path) {
+#ifndef _WIN32
+    struct stat st;
+    if (stat(path, &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        chmod(path, st.st_mode & 0555);
+        return;
+    }
+    DIR *dir = opendir(path);
+    if (!dir) return;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        char anak[1024];
+        snprintf(anak, sizeof(anak), "%s%s%s", path, PATH_SEPARATOR, ent->d_name);
+        kunci_berkas(anak);
+    }
+    closedir(dir);
+#else
+    (void)path;
+#endif
+}
+
+static int salin_berkas(const char *lama, const char *anyar) {
+    FILE *in = fopen(lama, "rb");
+    if (!in) return 0;
+    FILE *out = fopen(anyar, "wb");
+    if (!out) {
+        fclose(in);
+        return 0;
+    }
+    char buf[65536];
+    size_t n;
+    int ok = 1;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        if (fwrite(buf, 1, n, out) != n) ok = 0;
+    }
+    fclose(in);
+    if (fclose(out) != 0) ok = 0;
+    return ok;
+}
+
+// Salin struktur direktori sumber ke tujuan; berkas dibuat sebagai hardlink,
+// atau disalin bila hardlink tidak bisa (beda filesystem)
+static int pasang_tautan(const char *sumber, const char *tujuan) {
+    if (mkdir(tujuan, 0755) != 0 && !direktori_ada(tujuan)) return 0;
+    DIR *dir = opendir(sumber);
+    if (!dir) return 0;
+    struct dirent *ent;
+    int ok = 1;
+    while (ok && (ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        char lama[1024], anyar[1024];
+        snprintf(lama, sizeof(lama), "%s%s%s", sumber, PATH_SEPARATOR, ent->d_name);
+        snprintf(anyar, sizeof(anyar), "%s%s%s", tujuan, PATH_SEPARATOR, ent->d_name);
+        if (direktori_ada(lama)) {
+            ok = pasang_tautan(lama, anyar);
+        } else if (tautan_keras(lama, anyar) != 0) {
+            ok = salin_berkas(lama, anyar);
+        }
+    }
+    closedir(dir);
+    return ok;
+}
+
+// Masukkan arsip ke <store_dir>/<sidik>. Bila sidik harapan (dari
+// paket.lock) sudah ada di penyimpanan, arsip tidak dibaca sama sekali.
+static int simpen_lebokake(const char *arsip, const char *store_dir, const char *nama,
+                           const char *harapan, char sidik[65]) {
+    char path[600], sementara[800];
+    if (harapan && harapan[0]) {
+        snprintf(path, sizeof(path), "%s%s%s", store_dir, PATH_SEPARATOR, harapan);
+        if (direktori_ada(path)) {
+            snprintf(sidik, 65, "%s", harapan);
+            return 1;
+        }
+    }
+    if (!arsip || !zip_sidik(arsip, sidik)) {
+        fprintf(stderr, "Gagal membaca arsip %s\n", nama);
+        return 0;
+    }
+    if (harapan && harapan[0] && strcmp(harapan, sidik) != 0) {
+        fprintf(stderr, "Sidik arsip %s tidak cocok dengan paket.lock\n  diharapkan %s\n  didapat    %s\n",
+                nama, harapan, sidik);
+        return 0;
+    }
+    
+    snprintf(path, sizeof(path), "%s%s%s", store_dir, PATH_SEPARATOR, sidik);
+    if (direktori_ada(path)) return 1;
+    
+    // Ekstrak di samping lalu rename: proses lain hanya melihat entri utuh
+    snprintf(sementara, sizeof(sementara), "%s.%s.%ld", path, nama, (long)getpid());
+    hapus_rekursif(sementara);
+    if (!zip_ekstrak(arsip, sementara)) {
+        hapus_rekursif(sementara);
+        return 0;
+    }
+    kunci_berkas(sementara);
+    if (rename(sementara, path) != 0) {
+        hapus_rekursif(sementara);
+        return direktori_ada(path);
+    }
+    return 1;
+}
+
+// Versi dan sidik yang terpasang dicatat di <paket>/.versi
+static int sudah_terpasang(const char *packages_dir, const char *nama, const char *versi,
+                           char sidik[65]) {
+    char path[512];
+    char isi[64] = "", sidik_isi[80] = "";
+    snprintf(path, sizeof(path), "%s%s%s%s.versi", packages_dir, PATH_SEPARATOR, nama, PATH_SEPARATOR);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 0;
+    if (!fgets(isi, sizeof(isi), fp)) isi[0] = '\0';
+    if (!fgets(sidik_isi, sizeof(sidik_isi), fp)) sidik_isi[0] = '\0';
+    fclose(fp);
+    isi[strcspn(isi, "\r\n")] = '\0';
+    sidik_isi[strcspn(sidik_isi, "\r\n")] = '\0';
+    if (strcmp(isi, versi) != 0) return 0;
+    if (sidik[0]) return strcmp(sidik, sidik_isi) == 0;
+    snprintf(sidik, 65, "%s", sidik_isi);
+    return 1;
+}
+
+// Isi <packages_dir>/<nama> dari penyimpanan. Pohon dibangun di direktori
+// sementara lalu di-rename, jadi kegagalan tidak meninggalkan setengah jadi.
+// sidik berisi sidik harapan (boleh kosong) dan diisi sidik sebenarnya.
+static int pasang_arsip(const char *arsip, const char *store_dir, const char *packages_dir,
+                        const char *nama, const char *versi, char sidik[65]) {
+    char harapan[65], simpanan[600];
+    snprintf(harapan, sizeof(harapan), "%s", sidik);
+    if (!simpen_lebokake(arsip, store_dir, nama, harapan, sidik)) return 0;
+    snprintf(simpanan, sizeof(simpanan), "%s%s%s", store_dir, PATH_SEPARATOR, sidik);
+    
+    char tujuan[512], sementara[560], path[600];
+    snprintf(tujuan, sizeof(tujuan), "%s%s%s", packages_dir, PATH_SEPARATOR, nama);
+    snprintf(sementara, sizeof(sementara), "%s.pasang-%ld", tujuan, (long)getpid());
+    
+    hapus_rekursif(sementara);
+    if (!pasang_tautan(simpanan, sementara)) {
+        fprintf(stderr, "Gagal menautkan %s dari %s\n", nama, simpanan);
+        hapus_rekursif(sementara);
+        return 0;
+    }
+    snprintf(path, sizeof(path), "%s%s.versi", sementara, PATH_SEPARATOR);
+    FILE *fp = fopen(path, "w");
+    if (fp) {
+        fprintf(fp, "%s\n%s\n", versi, sidik);
+        fclose(fp);
+    }
+    if (!hapus_rekursif(tujuan) || rename(sementara, tujuan) != 0) {
+        fprintf(stderr, "Gagal memasang %s ke %s\n", nama, tujuan);
+        hapus_rekursif(sementara);
+        return 0;
+    }
+    return 1;
+}
+
+typedef struct {
+    Pilihan *isi;
+    const int *kurang;
+    const char *store_dir;
+    const char *packages_dir;
+    int *hasil;
+} PasangEnv;
+
+static void pasang_chunk(long long awal, long long akhir, void *env, JawaNilai *red) {
+    PasangEnv *e = env;
+    for (long long i = awal; i < akhir; i++) {
+        Pilihan *p = &e->isi[e->kurang[i]];
+        e->hasil[i] = pasang_arsip(p->arsip, e->store_dir, e->packages_dir, p->nama, p->versi, p->sidik);
+        if (!e->hasil[i]) red[0].i++;
+    }
+}
+
+// Pasang semua paket terpilih yang belum terpasang ke packages_dir, satu
+// paket per chunk di pool thread loop paralel. Sidik tiap paket diisi.
+static int pasang_resolusi(Resolusi *r, const char *packages_dir) {
+    char *store_dir = get_jawa_store_dir();
+    if (!store_dir) return 0;
+    if (!direktori_ada(packages_dir)) mkdir(packages_dir, 0755);
+    
+    int *kurang = malloc(sizeof(int) * (r->n + 1));
+    int n = 0;
+    for (int i = 0; i < r->n; i++) {
+        if (sudah_terpasang(packages_dir, r->isi[i].nama, r->isi[i].versi, r->isi[i].sidik)) {
+            printf("  = %s@%s (sudah terpasang)\n", r->isi[i].nama, r->isi[i].versi);
+        } else {
+            kurang[n++] = i;
+        }
+    }
+    
+    int *hasil = calloc(n + 1, sizeof(int));
+    PasangEnv env = {r->isi, kurang, store_dir, packages_dir, hasil};
+    JawaNilai gagal = { .i = 0 };
+    if (n > 0) paralel_kanggo(n, 0, 1, 1, pasang_chunk, &env, &gagal, "+", "i");
+    
+    for (int i = 0; i < n; i++) {
+        const Pilihan *p = &r->isi[kurang[i]];
+        printf("  %c %s@%s\n", hasil[i] ? '+' : '!', p->nama, p->versi);
+    }
+    free(hasil);
+    free(kurang);
+    free(store_dir);
+    return gagal.i == 0;
+}
+
+// Pasang ketergantungan <proyek_dir>/paket.json dari registri lokal ke
+// <proyek_dir>/paket_jawa dan tulis <proyek_dir>/paket.lock
+int pasang_proyek(const char *proyek_dir, const char *registri) {
+    char json_path[512], lock_path[512], packages_dir[512];
+    snprintf(json_path, sizeof(json_path), "%s%spaket.json", proyek_dir, PATH_SEPARATOR);
+    snprintf(lock_path, sizeof(lock_path), "%s%spaket.lock", proyek_dir, PATH_SEPARATOR);
+    snprintf(packages_dir, sizeof(packages_dir), "%s%s%s", proyek_dir, PATH_SEPARATOR, PAKET_PROYEK_DIR);
+    
+    JawaPaket *proyek = parse_paket_json(json_path);
+    if (!proyek) return 0;
+    
+    Resolusi kunci = {0}, r = {0};
+    kunci_waca(lock_path, &kunci);
+    int ok = resolusi_hitung(&r, &kunci, registri, (const char **)proyek->dependencies,
+                             proyek->dep_count, proyek->nama[0] ? proyek->nama : "paket.json");
+    if (ok) {
+        qsort(r.isi, r.n, sizeof(Pilihan), banding_pilihan);
+        printf("Memasang %d paket dari %s...\n", r.n, registri);
+        ok = pasang_resolusi(&r, packages_dir);
+        if (ok && !kunci_tulis(lock_path, &r, registri)) {
+            fprintf(stderr, "Gagal menulis %s\n", lock_path);
+            ok = 0;
+        }
+    }
+    if (ok) printf("Ketergantungan terpasang di %s, dicatat di %s\n", packages_dir, lock_path);
+    
+    free(kunci.isi);
+    free(r.isi);
+    free_paket(proyek);
+    return ok;
+}
+
+// Satu paket dari registri lokal beserta ketergantungannya
+static int pasang_dari_registri(const char *registri, const char *nama_paket, const char *versi) {
+    char *packages_dir = get_jawa_packages_dir();
+    if (!packages_dir) return 0;
+    
+    char dep[256];
+    snprintf(dep, sizeof(dep), "%s@%s", nama_paket, versi ? versi : "");
+    const char *deps[1] = {dep};
+    Resolusi r = {0};
+    int ok = resolusi_hitung(&r, NULL, registri, deps, 1, "baris perintah");
+    if (ok) {
+        qsort(r.isi, r.n, sizeof(Pilihan), banding_pilihan);
+        printf("Memasang paket %s (versi %s)...\n", nama_paket, versi ? versi : "latest");
+        ok = pasang_resolusi(&r, packages_dir);
+    }
+    if (ok) printf("Paket %s berhasil dipasang!\n", nama_paket);
+    
+    free(r.isi);
+    free(packages_dir);
+    return ok;
+}
+
+// Indeks <store_dir>/indeks/<nama>@<versi> berisi sidik arsip yang pernah
+// diunduh, supaya versi yang sama tidak diunduh ulang
+static void simpen_indeks(const char *store_dir, const char *nama, const char *versi,
+                          char sidik[65], int tulis) {
+    char path[600];
+    snprintf(path, sizeof(path), "%s%sindeks%s%s@%s", store_dir, PATH_SEPARATOR,
+             PATH_SEPARATOR, nama, versi);
+    FILE *fp = fopen(path, tulis ? "w" : "r");
+    if (!fp) return;
+    if (tulis) {
+        fprintf(fp, "%s\n", sidik);
+    } else if (fgets(sidik, 65, fp)) {
+        sidik[strcspn(sidik, "\r\n")] = '\0';
+    }
+    fclose(fp);
+}
+
+static int pasang_paket_dari(const char *registri, const char *nama_paket, const char *versi) {
+    if (registri) {
+        return pasang_dari_registri(registri, nama_paket, versi);
+    }
+    
+    char *packages_dir = get_jawa_packages_dir();
+    if (!packages_dir) {
+        return 0;
+    }
+    char *store_dir = get_jawa_store_dir();
+    if (!store_dir) {
         free(packages_dir);
         return 0;
     }
     
-    // Hapus file zip
-    remove(output_path);
+    printf("Memasang paket %s (versi %s)...\n", nama_paket, versi ? versi : "latest");
+    
+    // Versi tertentu yang sudah ada di penyimpanan tidak perlu diunduh
+    char sidik[65] = "";
+    char simpanan[600];
+    if (versi) simpen_indeks(store_dir, nama_paket, versi, sidik, 0);
+    snprintf(simpanan, sizeof(simpanan), "%s%s%s", store_dir, PATH_SEPARATOR, sidik);
+    int ok = 0;
+    if (sidik[0] && direktori_ada(simpanan)) {
+        ok = pasang_arsip(NULL, store_dir, packages_dir, nama_paket, versi, sidik);
+    }
+    
+    if (!ok) {
+        // Buat URL untuk mengunduh paket (contoh implementasi)
+        char url[512];
+        sprintf(url, "https://jawa-packages.example.com/%s/%s.zip", nama_paket, versi ? versi : "latest");
+        
+        // Buat path output
+        char output_path[512];
+        sprintf(output_path, "%s%s%s-%s.zip", packages_dir, PATH_SEPARATOR, nama_paket, versi ? versi : "latest");
+        
+        // Unduh paket
+        if (!unduh_file(url, output_path)) {
+            fprintf(stderr, "Gagal mengunduh paket\n");
+            free(store_dir);
+            free(packages_dir);
+            return 0;
+        }
+        
+        // Ekstrak paket
+        sidik[0] = '\0';
+        ok = pasang_arsip(output_path, store_dir, packages_dir, nama_paket, versi ? versi : "latest", sidik);
+        if (ok && versi) simpen_indeks(store_dir, nama_paket, versi, sidik, 1);
+        
+        // Hapus file zip
+        remove(output_path);
+    }
+    
+    if (!ok) {
+        fprintf(stderr, "Gagal mengekstrak paket\n");
+        free(store_dir);
+        free(packages_dir);
+        return 0;
+    }
     
     printf("Paket %s berhasil dipasang!\n", nama_paket);
+    free(store_dir);
     free(packages_dir);
     return 1;
 }
 
+// Pasang paket; registri lokal dari $JAWA_REGISTRI bila diset
+int pasang_paket(const char *nama_paket, const char *versi) {
+    return pasang_paket_dari(getenv(JAWA_REGISTRI_ENV), nama_paket, versi);
+}
+
 // Fungsi untuk menangani perintah paket
 int handle_paket_command(int argc, char **argv) {
     if (argc < 3) {
         printf("Penggunaan: jawa paket <perintah> [argumen...]\n");
         printf("Perintah yang tersedia:\n");
-        printf("  pasang <nama_paket[@versi]> - Pasang paket\n");
+        printf("  pasang [--registri <dir>] [nama_paket[@versi]] - Pasang paket,\n");
+        printf("         tanpa nama: ketergantungan paket.json + paket.lock\n");
         printf("  hapus <nama_paket> - Hapus paket\n");
         printf("  daftar - Tampilkan daftar paket terpasang\n");
         printf("  init - Inisialisasi paket baru\n");
@@ -295,27 +920,42 @@ int handle_paket_command(int argc, char **argv) {
     const char *command = argv[2];
     
     if (strcmp(command, "pasang") == 0) {
-        if (argc < 4) {
-            printf("Penggunaan: jawa paket pasang <nama_paket[@versi]>\n");
-            return 0;
+        const char *registri = getenv(JAWA_REGISTRI_ENV);
+        const char *target = NULL;
+        for (int i = 3; i < argc; i++) {
+            if (strcmp(argv[i], "--registri") == 0 && i + 1 < argc) {
+                registri = argv[++i];
+            } else if (!target) {
+                target = argv[i];
+            }
+        }
+        
+        if (!target) {
+            // Tanpa nama: pasang ketergantungan paket.json proyek ini
+            if (!registri) {
+                printf("Penggunaan: jawa paket pasang [--registri <dir>] [nama_paket[@versi]]\n");
+                printf("Tanpa nama paket, ketergantungan paket.json dipasang dari registri lokal\n");
+                printf("(--registri atau $%s)\n", JAWA_REGISTRI_ENV);
+                return 0;
+            }
+            return pasang_proyek(".", registri);
         }
         
         char nama_paket[256];
         char versi[64] = "latest";
-        char *at_pos = strchr(argv[3], '@');
+        const char *at_pos = strchr(target, '@');
         
         if (at_pos) {
             // Format: nama_paket@versi
-            int nama_len = at_pos - argv[3];
-            strncpy(nama_paket, argv[3], nama_len);
-            nama_paket[nama_len] = '\0';
-            strcpy(versi, at_pos + 1);
+            int nama_len = at_pos - target;
+            snprintf(nama_paket, sizeof(nama_paket), "%.*s", nama_len, target);
+            snprintf(versi, sizeof(versi), "%s", at_pos + 1);
         } else {
             // Hanya nama paket
-            strcpy(nama_paket, argv[3]);
+            snprintf(nama_paket, sizeof(nama_paket), "%s", target);
         }
         
-        return pasang_paket(nama_paket, strcmp(versi, "latest") == 0 ? NULL : versi);
+        return pasang_paket_dari(registri, nama_paket, strcmp(versi, "latest") == 0 ? NULL : versi);
     } 
     else if (strcmp(command, "daftar") == 0) {
         char *packages_dir = get_jawa_packages_dir();
@@ -462,27 +1102,29 @@ int handle_paket_command(int argc, char **argv) {
             return 0;
         }
         
+        if (!nama_paket_sah(argv[3])) {
+            fprintf(stderr, "Nama paket tidak sah: \"%s\"\n", argv[3]);
+            free(packages_dir);
+            return 0;
+        }
+        
         char package_dir[512];
-        sprintf(package_dir, "%s%s%s", packages_dir, PATH_SEPARATOR, argv[3]);
+        snprintf(package_dir, sizeof(package_dir), "%s%s%s", packages_dir, PATH_SEPARATOR, argv[3]);
         
         // Periksa apakah paket ada
         struct stat st = {0};
-        if (stat(package_dir, &st) == -1) {
+        if (lstat(package_dir, &st) == -1) {
             fprintf(stderr, "Paket %s tidak ditemukan\n", argv[3]);
             free(packages_dir);
             return 0;
         }
         
         // Hapus direktori paket
-#ifdef _WIN32
-        char rm_cmd[1024];
-        sprintf(rm_cmd, "rmdir /s /q \"%s\"", package_dir);
-        system(rm_cmd);
-#else
-        char rm_cmd[1024];
-        sprintf(rm_cmd, "rm -rf \"%s\"", package_dir);
-        system(rm_cmd);
-#endif
+        if (!hapus_rekursif(package_dir)) {
+            fprintf(stderr, "Gagal menghapus %s\n", package_dir);
+            free(packages_dir);
+            return 0;
+        }
         
         printf("Paket %s berhasil dihapus\n", argv[3]);
         free(packages_dir);
@@ -494,39 +1136,53 @@ int handle_paket_command(int argc, char **argv) {
     }
 }
 
-// Fungsi bantuan untuk resolusi impor
+static int berkas_ada(const char *path) {
+    struct stat st;
+    return stat(path, &st) == 0 && !S_ISDIR(st.st_mode);
+}
+
+// path, atau path + ".jw" bila path tidak ada
+static char *impor_berkas(const char *path) {
+    char buf[1024];
+    if (berkas_ada(path)) return strdup(path);
+    snprintf(buf, sizeof(buf), "%s.jw", path);
+    return berkas_ada(buf) ? strdup(buf) : NULL;
+}
+
+// Fungsi bantuan untuk resolusi impor. Hanya stat berkas kandidat;
+// direktori paket tidak dibuat di sini.
 char *resolve_import_path(const char *base_dir, const char *import_path) {
-    char *resolved_path;
+    char path[1024];
     
     if (import_path[0] == '.' && (import_path[1] == '/' || 
                                   (import_path[1] == '.' && import_path[2] == '/'))) {
         // Relatif impor
-        resolved_path = malloc(strlen(base_dir) + strlen(import_path) + 2);
-        if (!resolved_path) return NULL;
-        
-        if (base_dir[strlen(base_dir) - 1] == PATH_SEPARATOR[0]) {
-            sprintf(resolved_path, "%s%s", base_dir, import_path + 2);
-        } else {
-            sprintf(resolved_path, "%s%s%s", base_dir, PATH_SEPARATOR, import_path + 2);
-        }
-    } else {
-        // Impor paket
-        char *packages_dir = get_jawa_packages_dir();
-        if (!packages_dir) return NULL;
-        
-        resolved_path = malloc(strlen(packages_dir) + strlen(import_path) + 20);
-        if (!resolved_path) {
-            free(packages_dir);
-            return NULL;
-        }
-        
-        sprintf(resolved_path, "%s%s%s%sindex.jw", packages_dir, PATH_SEPARATOR, 
-                import_path, PATH_SEPARATOR);
-        
-        free(packages_dir);
+        const char *rel = import_path[1] == '/' ? import_path + 2 : import_path;
+        size_t n = strlen(base_dir);
+        snprintf(path, sizeof(path), "%s%s%s", base_dir,
+                 n && base_dir[n - 1] == PATH_SEPARATOR[0] ? "" : PATH_SEPARATOR, rel);
+        return impor_berkas(path);
+    }
+    
+    // Impor paket: paket_jawa/ proyek, dicari naik dari base_dir
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", base_dir);
+    for (;;) {
+        snprintf(path, sizeof(path), "%s%s%s%s%s%sindex.jw", dir, PATH_SEPARATOR,
+                 PAKET_PROYEK_DIR, PATH_SEPARATOR, import_path, PATH_SEPARATOR);
+        if (berkas_ada(path)) return strdup(path);
+        char *sep = strrchr(dir, PATH_SEPARATOR[0]);
+        if (!sep || sep == dir) break;
+        *sep = '\0';
     }
     
-    return resolved_path;
+    // Lalu paket global <home>/.jawa/paket/<nama>/index.jw
+    const char *home_dir = getenv(JAWA_HOME_ENV);
+    if (!home_dir) home_dir = getenv("HOME");
+    if (!home_dir) return NULL;
+    snprintf(path, sizeof(path), "%s%s.jawa%spaket%s%s%sindex.jw", home_dir, PATH_SEPARATOR,
+             PATH_SEPARATOR, PATH_SEPARATOR, import_path, PATH_SEPARATOR);
+    return berkas_ada(path) ? strdup(path) : NULL;
 }
 
 // Bebaskan memori paket
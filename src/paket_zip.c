@@ -0,0 +1,345 @@
+#include "paket_zip.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#define buat_dir(path) _mkdir(path)
+#else
+#define buat_dir(path) mkdir(path, 0755)
+#endif
+
+#define ZIP_EOCD 0x06054b50u
+#define ZIP_PUSAT 0x02014b50u
+#define ZIP_LOKAL 0x04034b50u
+
+typedef struct {
+    unsigned char *data;
+    size_t len;
+    size_t pusat;       // offset central directory
+    unsigned entri;     // jumlah entri
+} Arsip;
+
+static unsigned u16(const unsigned char *p) {
+    return p[0] | (p[1] << 8);
+}
+
+static unsigned long u32(const unsigned char *p) {
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+           ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+// Memuat seluruh arsip dan mencari end-of-central-directory dari belakang
+// (komentar zip paling panjang 65535 byte)
+static int buka_arsip(const char *path, Arsip *a) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) {
+        fprintf(stderr, "Gagal membuka arsip: %s\n", path);
+        return 0;
+    }
+    fseek(fp, 0, SEEK_END);
+    long n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (n < 22) {
+        fclose(fp);
+        fprintf(stderr, "Arsip tidak valid: %s\n", path);
+        return 0;
+    }
+    a->data = malloc(n);
+    a->len = (size_t)n;
+    if (!a->data || fread(a->data, 1, a->len, fp) != a->len) {
+        fclose(fp);
+        free(a->data);
+        fprintf(stderr, "Gagal membaca arsip: %s\n", path);
+        return 0;
+    }
+    fclose(fp);
+
+    size_t batas = a->len > 22 + 65535 ? a->len - 22 - 65535 : 0;
+    for (size_t i = a->len - 22 + 1; i-- > batas;) {
+        const unsigned char *p = a->data + i;
+        if (u32(p) != ZIP_EOCD) continue;
+        a->entri = u16(p + 10);
+        a->pusat = u32(p + 16);
+        if (a->pusat + (size_t)a->entri * 46 <= i) return 1;
+        break;
+    }
+    free(a->data);
+    fprintf(stderr, "Arsip tidak valid: %s\n", path);
+    return 0;
+}
+
+// Isi satu entri central directory
+typedef struct {
+    const char *nama;
+    size_t nama_len;
+    unsigned metode;
+    size_t ukuran_zip;
+    size_t ukuran;
+    unsigned long crc;
+    size_t lokal;
+    size_t lanjut;      // offset entri berikutnya
+} Entri;
+
+static int waca_entri(const Arsip *a, size_t off, Entri *e) {
+    if (off + 46 > a->len || u32(a->data + off) != ZIP_PUSAT) return 0;
+    const unsigned char *p = a->data + off;
+    e->metode = u16(p + 10);
+    e->crc = u32(p + 16);
+    e->ukuran_zip = u32(p + 20);
+    e->ukuran = u32(p + 24);
+    e->nama_len = u16(p + 28);
+    e->lokal = u32(p + 42);
+    e->nama = (const char *)p + 46;
+    e->lanjut = off + 46 + e->nama_len + u16(p + 30) + u16(p + 32);
+    return e->lanjut <= a->len;
+}
+
+// Mengembalikan isi entri yang sudah didekompresi (diakhiri '\0')
+static char *isi_entri(const Arsip *a, const Entri *e) {
+    if (e->lokal + 30 > a->len || u32(a->data + e->lokal) != ZIP_LOKAL) return NULL;
+    const unsigned char *lp = a->data + e->lokal;
+    size_t awal = e->lokal + 30 + u16(lp + 26) + u16(lp + 28);
+    if (awal + e->ukuran_zip > a->len) return NULL;
+
+    char *out = malloc(e->ukuran + 1);
+    if (!out) return NULL;
+    if (e->metode == 0) {
+        if (e->ukuran != e->ukuran_zip) {
+            free(out);
+            return NULL;
+        }
+        memcpy(out, a->data + awal, e->ukuran);
+    } else if (e->metode == 8) {
+        z_stream zs;
+        memset(&zs, 0, sizeof(zs));
+        if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+            free(out);
+            return NULL;
+        }
+        zs.next_in = a->data + awal;
+        zs.avail_in = (uInt)e->ukuran_zip;
+        zs.next_out = (Bytef *)out;
+        zs.avail_out = (uInt)e->ukuran;
+        int rc = inflate(&zs, Z_FINISH);
+        inflateEnd(&zs);
+        if (rc != Z_STREAM_END || zs.total_out != e->ukuran) {
+            free(out);
+            return NULL;
+        }
+    } else {
+        fprintf(stderr, "Metode kompresi zip %u tidak didukung\n", e->metode);
+        free(out);
+        return NULL;
+    }
+    if (crc32(0L, (const Bytef *)out, (uInt)e->ukuran) != e->crc) {
+        free(out);
+        return NULL;
+    }
+    out[e->ukuran] = '\0';
+    return out;
+}
+
+// Menolak path absolut, drive Windows, dan komponen ".."
+static int nama_aman(const char *nama) {
+    if (nama[0] == '/' || nama[0] == '\\' || strchr(nama, ':')) return 0;
+    const char *p = nama;
+    while (*p) {
+        size_t n = strcspn(p, "/\\");
+        if (n == 2 && p[0] == '.' && p[1] == '.') return 0;
+        p += n;
+        if (*p) p++;
+    }
+    return 1;
+}
+
+// mkdir -p untuk semua direktori induk path (dan path sendiri bila akhir_juga)
+static int buat_induk(char *path, int akhir_juga) {
+    for (char *p = path + 1; *p; p++) {
+        if (*p != '/' && *p != '\\') continue;
+        char c = *p;
+        *p = '\0';
+        int rc = buat_dir(path);
+        *p = c;
+        if (rc != 0 && errno != EEXIST) return 0;
+    }
+    if (akhir_juga && buat_dir(path) != 0 && errno != EEXIST) return 0;
+    return 1;
+}
+
+int zip_ekstrak(const char *zip_path, const char *tujuan) {
+    Arsip a;
+    if (!buka_arsip(zip_path, &a)) return 0;
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s", tujuan);
+    int ok = buat_induk(path, 1);
+    size_t off = a.pusat;
+    for (unsigned i = 0; ok && i < a.entri; i++) {
+        Entri e;
+        if (!waca_entri(&a, off, &e)) {
+            ok = 0;
+            break;
+        }
+        off = e.lanjut;
+
+        char nama[512];
+        if (e.nama_len == 0 || e.nama_len >= sizeof(nama)) {
+            ok = 0;
+            break;
+        }
+        memcpy(nama, e.nama, e.nama_len);
+        nama[e.nama_len] = '\0';
+        if (!nama_aman(nama)) {
+            fprintf(stderr, "Entri arsip ditolak: %s\n", nama);
+            ok = 0;
+            break;
+        }
+        if (snprintf(path, sizeof(path), "%s/%s", tujuan, nama) >= (int)sizeof(path)) {
+            ok = 0;
+            break;
+        }
+        int direktori = nama[e.nama_len - 1] == '/';
+        if (direktori) {
+            path[strlen(path) - 1] = '\0';
+            ok = buat_induk(path, 1);
+            continue;
+        }
+        if (!buat_induk(path, 0)) {
+            ok = 0;
+            break;
+        }
+
+        char *isi = isi_entri(&a, &e);
+        if (!isi) {
+            fprintf(stderr, "Entri arsip rusak: %s\n", nama);
+            ok = 0;
+            break;
+        }
+        FILE *fp = fopen(path, "wb");
+        if (!fp || fwrite(isi, 1, e.ukuran, fp) != e.ukuran) {
+            fprintf(stderr, "Gagal menulis %s\n", path);
+            ok = 0;
+        }
+        if (fp && fclose(fp) != 0) ok = 0;
+        free(isi);
+    }
+    free(a.data);
+    return ok;
+}
+
+char *zip_waca_berkas(const char *zip_path, const char *nama, size_t *len) {
+    Arsip a;
+    if (!buka_arsip(zip_path, &a)) return NULL;
+
+    char *isi = NULL;
+    size_t n = strlen(nama);
+    size_t off = a.pusat;
+    for (unsigned i = 0; i < a.entri; i++) {
+        Entri e;
+        if (!waca_entri(&a, off, &e)) break;
+        off = e.lanjut;
+        if (e.nama_len == n && memcmp(e.nama, nama, n) == 0) {
+            isi = isi_entri(&a, &e);
+            if (isi && len) *len = e.ukuran;
+            break;
+        }
+    }
+    free(a.data);
+    return isi;
+}
+
+// ---- SHA-256 ----
+
+static const uint32_t sha_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+typedef struct {
+    uint32_t h[8];
+    uint64_t len;
+    unsigned char buf[64];
+    size_t n;
+} Sha256;
+
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void sha_blok(Sha256 *s, const unsigned char *p) {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)p[4 * i] << 24) | ((uint32_t)p[4 * i + 1] << 16) |
+               ((uint32_t)p[4 * i + 2] << 8) | p[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR(w[i - 15], 7) ^ ROTR(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR(w[i - 2], 17) ^ ROTR(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    uint32_t a = s->h[0], b = s->h[1], c = s->h[2], d = s->h[3];
+    uint32_t e = s->h[4], f = s->h[5], g = s->h[6], h = s->h[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + ((e & f) ^ (~e & g)) + sha_k[i] + w[i];
+        uint32_t t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    s->h[0] += a; s->h[1] += b; s->h[2] += c; s->h[3] += d;
+    s->h[4] += e; s->h[5] += f; s->h[6] += g; s->h[7] += h;
+}
+
+static void sha_tambah(Sha256 *s, const unsigned char *p, size_t len) {
+    s->len += len;
+    while (len > 0) {
+        size_t n = 64 - s->n < len ? 64 - s->n : len;
+        memcpy(s->buf + s->n, p, n);
+        s->n += n;
+        p += n;
+        len -= n;
+        if (s->n == 64) {
+            sha_blok(s, s->buf);
+            s->n = 0;
+        }
+    }
+}
+
+int zip_sidik(const char *zip_path, char sidik[65]) {
+    Sha256 s = {{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}, 0, {0}, 0};
+    FILE *fp = fopen(zip_path, "rb");
+    if (!fp) return 0;
+    unsigned char blok[65536];
+    size_t n;
+    while ((n = fread(blok, 1, sizeof(blok), fp)) > 0) sha_tambah(&s, blok, n);
+    int ok = !ferror(fp);
+    fclose(fp);
+
+    uint64_t bit = s.len * 8;
+    unsigned char pad = 0x80;
+    sha_tambah(&s, &pad, 1);
+    pad = 0;
+    while (s.n != 56) sha_tambah(&s, &pad, 1);
+    unsigned char panjang[8];
+    for (int i = 0; i < 8; i++) panjang[i] = (unsigned char)(bit >> (56 - 8 * i));
+    sha_tambah(&s, panjang, 8);
+
+    static const char hex[] = "0123456789abcdef";
+    for (int i = 0; i < 32; i++) {
+        unsigned char b = (unsigned char)(s.h[i / 4] >> (24 - 8 * (i % 4)));
+        sidik[2 * i] = hex[b >> 4];
+        sidik[2 * i + 1] = hex[b & 15];
+    }
+    sidik[64] = '\0';
+    return ok;
+}
@@ -0,0 +1,264 @@
+#include "paralel.h"
+#include "output.h"
+#include "statistik.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+#define BENANG_MAX 256
+#define CHUNK_MAX 65536        // batas chunk, juga jumlah buffer output
+#define CHUNK_PER_BENANG 16    // chunk otomatis pada jadwal dinamis
+
+typedef struct {
+    long long n;
+    long long ukuran;          // iterasi per chunk
+    long long jumlah_chunk;
+    int peserta;               // thread yang ikut, termasuk pemanggil
+    bool dinamis;
+    ParalelFn fn;
+    void* env;
+    int nred;
+    JawaNilai* slot;           // jumlah_chunk * nred
+    CithakTangkapan* output;   // satu per chunk
+#ifndef _WIN32
+    // Antrian chunk per thread: (awal << 32) | akhir, diambil pemilik dari
+    // depan dan dicuri thread lain dari belakang, keduanya lewat CAS
+    _Atomic uint64_t* antrian;
+#endif
+} Tugas;
+
+static int jumlah_benang(int benang) {
+    if (benang <= 0) {
+        const char* env = getenv("JAWA_THREADS");
+        benang = env ? atoi(env) : 0;
+    }
+#ifndef _WIN32
+    if (benang <= 0) benang = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (benang < 1) benang = 1;
+    return benang > BENANG_MAX ? BENANG_MAX : benang;
+}
+
+#ifndef _WIN32
+static void jalankan_chunk(Tugas* t, long long c) {
+    long long awal = c * t->ukuran;
+    long long akhir = awal + t->ukuran < t->n ? awal + t->ukuran : t->n;
+    cithak_tangkap(&t->output[c]);
+    t->fn(awal, akhir, t->env, t->slot + c * t->nred);
+    cithak_tangkap(NULL);
+}
+
+static uint64_t rentang(uint64_t awal, uint64_t akhir) {
+    return (awal << 32) | akhir;
+}
+
+// Chunk berikutnya dari antrian sendiri, atau -1
+static long long ambil(Tugas* t, int id) {
+    uint64_t r = atomic_load(&t->antrian[id]);
+    for (;;) {
+        uint64_t a = r >> 32, b = r & 0xffffffffu;
+        if (a >= b) return -1;
+        if (atomic_compare_exchange_weak(&t->antrian[id], &r, rentang(a + 1, b))) return (long long)a;
+    }
+}
+
+// Mencuri separuh belakang antrian thread lain; chunk pertama hasil curian
+// dikembalikan, sisanya menjadi antrian sendiri
+static long long curi(Tugas* t, int id) {
+    for (int k = 1; k < t->peserta; k++) {
+        int korban = (id + k) % t->peserta;
+        uint64_t r = atomic_load(&t->antrian[korban]);
+        for (;;) {
+            uint64_t a = r >> 32, b = r & 0xffffffffu;
+            if (a >= b) break;
+            uint64_t tengah = b - (b - a + 1) / 2;
+            if (atomic_compare_exchange_weak(&t->antrian[korban], &r, rentang(a, tengah))) {
+                atomic_store(&t->antrian[id], rentang(tengah + 1, b));
+                return (long long)tengah;
+            }
+        }
+    }
+    return -1;
+}
+
+static void kerjakan(Tugas* t, int id) {
+    for (;;) {
+        long long c = ambil(t, id);
+        if (c < 0 && t->dinamis) c = curi(t, id);
+        if (c < 0) return;
+        jalankan_chunk(t, c);
+    }
+}
+
+// Pool thread yang hidup sepanjang program; pemanggil ikut bekerja
+// sebagai thread 0, jadi pool cukup berisi peserta - 1 worker
+static pthread_mutex_t pool_kunci = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_mulai = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_rampung = PTHREAD_COND_INITIALIZER;
+static pthread_mutex_t pool_dipakai = PTHREAD_MUTEX_INITIALIZER;
+static unsigned long pool_generasi;
+static Tugas* pool_tugas;
+static int pool_ukuran;
+static int pool_aktif;
+static _Thread_local bool di_worker;
+
+static void* worker(void* arg) {
+    int id = (int)(intptr_t)arg;
+    unsigned long dilihat = 0;
+    di_worker = true;
+    pthread_mutex_lock(&pool_kunci);
+    for (;;) {
+        while (pool_generasi == dilihat) pthread_cond_wait(&pool_mulai, &pool_kunci);
+        dilihat = pool_generasi;
+        Tugas* t = pool_tugas;
+        pthread_mutex_unlock(&pool_kunci);
+
+        if (id < t->peserta) kerjakan(t, id);
+
+        pthread_mutex_lock(&pool_kunci);
+        if (--pool_aktif == 0) pthread_cond_signal(&pool_rampung);
+    }
+    return NULL;
+}
+
+// Menjalankan t di pool; false bila harus dijalankan serial
+static bool jalankan_pool(Tugas* t) {
+    // Loop paralel di dalam loop paralel, atau dari dua thread sekaligus,
+    // dijalankan serial oleh pemanggilnya
+    if (di_worker || pthread_mutex_trylock(&pool_dipakai) != 0) return false;
+
+    t->antrian = malloc(sizeof(*t->antrian) * t->peserta);
+    if (!t->antrian) {
+        pthread_mutex_unlock(&pool_dipakai);
+        return false;
+    }
+    // Chunk dibagi rata berurutan; jadwal statis berarti satu chunk per thread
+    for (int i = 0; i < t->peserta; i++) {
+        uint64_t a = (uint64_t)(t->jumlah_chunk * i / t->peserta);
+        uint64_t b = (uint64_t)(t->jumlah_chunk * (i + 1) / t->peserta);
+        atomic_init(&t->antrian[i], rentang(a, b));
+    }
+
+    pthread_mutex_lock(&pool_kunci);
+    while (pool_ukuran < t->peserta - 1) {
+        pthread_t th;
+        if (pthread_create(&th, NULL, worker, (void*)(intptr_t)(pool_ukuran + 1)) != 0) break;
+        pthread_detach(th);
+        pool_ukuran++;
+    }
+    int semua = t->peserta;
+    if (t->peserta > pool_ukuran + 1) t->peserta = pool_ukuran + 1;
+    pool_tugas = t;
+    pool_aktif = pool_ukuran;
+    pool_generasi++;
+    pthread_cond_broadcast(&pool_mulai);
+    pthread_mutex_unlock(&pool_kunci);
+
+    // Antrian thread yang tidak jadi dibuat tetap habis lewat pencurian
+    di_worker = true;
+    kerjakan(t, 0);
+    for (int i = 0; i < semua; i++) {
+        long long c;
+        while ((c = ambil(t, i)) >= 0) jalankan_chunk(t, c);
+    }
+    di_worker = false;
+
+    pthread_mutex_lock(&pool_kunci);
+    while (pool_aktif > 0) pthread_cond_wait(&pool_rampung, &pool_kunci);
+    pthread_mutex_unlock(&pool_kunci);
+
+    free((void*)t->antrian);
+    pthread_mutex_unlock(&pool_dipakai);
+    return true;
+}
+#endif
+
+// Menggabung hasil satu chunk ke hasil akhir, sesuai operasi dan jenisnya
+static void gabung_red(JawaNilai* hasil, const JawaNilai* s, char op, char jenis) {
+    if (jenis == 'i') {
+        if (op == '+') hasil->i += s->i;
+        else if (op == '<' ? s->i < hasil->i : s->i > hasil->i) hasil->i = s->i;
+    } else {
+        if (op == '+') hasil->d += s->d;
+        else if (op == '<' ? s->d < hasil->d : s->d > hasil->d) hasil->d = s->d;
+    }
+}
+
+void paralel_kanggo(long long n, int benang, int dinamis, long long chunk,
+                    ParalelFn fn, void* env, JawaNilai* hasil, const char* ops, const char* jenis) {
+    if (n <= 0) return;
+    STATISTIK_PANGGIL(STAT_PARALEL);
+    int nred = (int)strlen(ops);
+    JawaNilai awal_red[64];
+    if (nred > 64) nred = 64;
+
+    Tugas t;
+    memset(&t, 0, sizeof(t));
+    t.n = n;
+    t.fn = fn;
+    t.env = env;
+    t.nred = nred;
+    t.dinamis = dinamis != 0;
+    t.peserta = jumlah_benang(benang);
+    if (t.peserta > n) t.peserta = (int)n;
+
+    if (t.dinamis) {
+        t.ukuran = chunk > 0 ? chunk : n / ((long long)t.peserta * CHUNK_PER_BENANG);
+    } else {
+        t.ukuran = (n + t.peserta - 1) / t.peserta;
+    }
+    if (t.ukuran < 1) t.ukuran = 1;
+    if ((n + t.ukuran - 1) / t.ukuran > CHUNK_MAX) t.ukuran = (n + CHUNK_MAX - 1) / CHUNK_MAX;
+    t.jumlah_chunk = (n + t.ukuran - 1) / t.ukuran;
+
+    // Slot reduksi tiap chunk: jumlah mulai dari 0, min/max dari nilai awal
+    for (int k = 0; k < nred; k++) {
+        if (ops[k] != '+') awal_red[k] = hasil[k];
+        else if (jenis[k] == 'i') awal_red[k].i = 0;
+        else awal_red[k].d = 0.0;
+    }
+
+    bool paralel = false;
+#ifndef _WIN32
+    if (t.peserta > 1) {
+        t.slot = malloc(sizeof(JawaNilai) * (t.jumlah_chunk * nred + 1));
+        t.output = calloc(t.jumlah_chunk, sizeof(CithakTangkapan));
+        if (t.slot && t.output) {
+            for (long long c = 0; c < t.jumlah_chunk; c++) {
+                memcpy(t.slot + c * nred, awal_red, sizeof(JawaNilai) * nred);
+            }
+            paralel = jalankan_pool(&t);
+        }
+        if (!paralel) {
+            free(t.slot);
+            free(t.output);
+        }
+    }
+#endif
+
+    if (!paralel) {
+        // Serial: satu chunk berisi semua iterasi, output langsung
+        fn(0, n, env, awal_red);
+        for (int k = 0; k < nred; k++) {
+            if (ops[k] == '+') gabung_red(&hasil[k], &awal_red[k], '+', jenis[k]);
+            else hasil[k] = awal_red[k];
+        }
+        return;
+    }
+
+    for (long long c = 0; c < t.jumlah_chunk; c++) {
+        const JawaNilai* s = t.slot + c * nred;
+        for (int k = 0; k < nred; k++) gabung_red(&hasil[k], &s[k], ops[k], jenis[k]);
+        if (t.output[c].len > 0) cithak_tulis(t.output[c].data, t.output[c].len);
+        free(t.output[c].data);
+    }
+    free(t.slot);
+    free(t.output);
+}
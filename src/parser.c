@@ -1,9 +1,24 @@
 #include "parser.h"
+#include "optimizer.h"
 #include <string.h>
+#include <ctype.h>
 #include <stdarg.h>
 
 void parser_init(ParserContext *ctx) {
     ctx->var_count = 0;
+    ctx->hoist_count = 0;
+    ctx->hoist_serial = 0;
+    ctx->hoist_discover = false;
+    ctx->async_count = 0;
+    ctx->task_ty = TY_UNK;
+    ctx->split_serial = 0;
+    ctx->line_file = NULL;
+    ctx->line_starts = NULL;
+    ctx->line_count = 0;
+    ctx->fn_name[0] = 0;
+    ctx->fn_param_count = 0;
+    ctx->fn_tail_loop = false;
+    memset(&ctx->fn_memo, 0, sizeof(ctx->fn_memo));
 }
 
 void parser_add_var(ParserContext *ctx, const char *name, Ty ty) {
@@ -20,6 +35,7 @@ void parser_add_var(ParserContext *ctx, const char *name, Ty ty) {
         strncpy(ctx->vars[ctx->var_count].name, name, sizeof(ctx->vars[ctx->var_count].name) - 1);
         ctx->vars[ctx->var_count].name[sizeof(ctx->vars[ctx->var_count].name) - 1] = 0;
         ctx->vars[ctx->var_count].ty = ty;
+        ctx->vars[ctx->var_count].elem = TY_UNK;
         ctx->var_count++;
     }
 }
@@ -33,6 +49,53 @@ Ty parser_get_var_type(ParserContext *ctx, const char *name) {
     return TY_UNK;
 }
 
+void parser_set_var_elem(ParserContext *ctx, const char *name, Ty elem) {
+    for (int i = 0; i < ctx->var_count; i++) {
+        if (strcmp(ctx->vars[i].name, name) == 0) {
+            ctx->vars[i].elem = elem;
+            return;
+        }
+    }
+}
+
+Ty parser_get_var_elem(ParserContext *ctx, const char *name) {
+    for (int i = 0; i < ctx->var_count; i++) {
+        if (strcmp(ctx->vars[i].name, name) == 0) {
+            return ctx->vars[i].elem;
+        }
+    }
+    return TY_UNK;
+}
+
+void parser_add_async(ParserContext *ctx, const char *name, Ty ret) {
+    if (ctx->async_count >= 64) return;
+    AsyncFn *f = &ctx->async_fns[ctx->async_count++];
+    strncpy(f->name, name, sizeof(f->name) - 1);
+    f->name[sizeof(f->name) - 1] = 0;
+    f->ret = ret;
+}
+
+bool parser_is_async(ParserContext *ctx, const char *name, Ty *ret) {
+    for (int i = 0; i < ctx->async_count; i++) {
+        if (strcmp(ctx->async_fns[i].name, name) == 0) {
+            if (ret) *ret = ctx->async_fns[i].ret;
+            return true;
+        }
+    }
+    return false;
+}
+
+Ty parser_kanal_elem(const char *s) {
+    while (*s == ' ') s++;
+    if (*s != '<') return TY_UNK;
+    s++;
+    while (*s == ' ') s++;
+    if (strncmp(s, "int", 3) == 0) return TY_INT;
+    if (strncmp(s, "string", 6) == 0) return TY_STRING;
+    if (strncmp(s, "bool", 4) == 0) return TY_BOOL;
+    return TY_DOUBLE;
+}
+
 void sb_add(char *out, size_t outsz, int *oi, const char *fmt, ...) {
     if (*oi >= (int)outsz) return;
     va_list ap; 
@@ -63,6 +126,123 @@ static Ty promote_num(Ty a, Ty b, int op_div) {
     return TY_INT;
 }
 
+const char *parser_nilai_field(Ty ty) {
+    if (ty == TY_INT || ty == TY_BOOL) return "i";
+    if (ty == TY_STRING) return "s";
+    return "d";
+}
+
+// kirim(ch, v) after the '(': the value is wrapped in a JawaNilai of the
+// channel's element type, which the first kirim fixes if none was declared
+static Ty parse_kirim(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    char chan[sizeof(L->cur.lex)] = {0};
+    if (L->cur.kind == T_IDENT) {
+        memcpy(chan, L->cur.lex, sizeof(chan));
+    }
+    sb_add(out, outsz, oi, "kanal_kirim(");
+    parse_expr(L, out, outsz, oi, ctx);
+    if (L->cur.kind == T_COMMA) lex_next(L);
+    
+    char vbuf[4096];
+    int vi = 0;
+    vbuf[0] = 0;
+    Ty vt = parse_expr(L, vbuf, sizeof(vbuf), &vi, ctx);
+    if (L->cur.kind == T_RPAREN) lex_next(L);
+    
+    Ty elem = chan[0] ? parser_get_var_elem(ctx, chan) : TY_UNK;
+    if (elem == TY_UNK) {
+        elem = vt == TY_UNK ? TY_DOUBLE : vt;
+        if (chan[0]) parser_set_var_elem(ctx, chan, elem);
+    }
+    sb_add(out, outsz, oi, ", (JawaNilai){.%s = %s})", parser_nilai_field(elem), vbuf);
+    return TY_UNK;
+}
+
+#define CALL_ARG_MAX 3
+
+// Arguments after a call's '(' through its ')', one buffer each; extra
+// arguments are appended to the last buffer
+static int parse_call_args(Lexer *L, ParserContext *ctx, char args[][1024], int first, int max) {
+    int argc = first;
+    while (L->cur.kind != T_RPAREN && L->cur.kind != T_EOF) {
+        int slot = argc < max ? argc : max - 1;
+        int ai = (int)strlen(args[slot]);
+        if (argc >= max) sb_add(args[slot], 1024, &ai, ", ");
+        parse_expr(L, args[slot], 1024, &ai, ctx);
+        argc++;
+        if (L->cur.kind == T_COMMA) lex_next(L);
+    }
+    if (L->cur.kind == T_RPAREN) lex_next(L);
+    return argc;
+}
+
+// Byte length of arg if it is exactly one string literal, else -1
+static long literal_length(const char *arg) {
+    size_t n = strlen(arg);
+    if (n < 2 || arg[0] != '"' || arg[n - 1] != '"') return -1;
+    const char *end = arg + n - 1;
+    long len = 0;
+    for (const char *p = arg + 1; p < end; p++, len++) {
+        if (*p == '"') return -1;
+        if (*p == '\\') {
+            // Simple escapes only; octal and hex ones have a variable width
+            if (++p >= end || !strchr("nrt\\\"'", *p)) return -1;
+        }
+    }
+    return len;
+}
+
+// ngandhut / miwiti / mungkasi / replace, receiver in args[0]. Literal
+// arguments have their length known here and go to the _n variants: the
+// tests are static inline in the program header, so the C compiler
+// expands the comparison in place, and replace skips strlen on both.
+static Ty emit_string_call(const char *c_name, char args[][1024], int argc, char *out, size_t outsz, int *oi) {
+    bool replace = strcmp(c_name, "replace") == 0;
+    long lens[CALL_ARG_MAX] = { 0 };
+    bool literal = argc == (replace ? 3 : 2);
+    for (int i = 1; literal && i < argc; i++) {
+        lens[i] = literal_length(args[i]);
+        if (lens[i] < 0) literal = false;
+    }
+    
+    sb_add(out, outsz, oi, "string_%s%s(", c_name, literal ? "_n" : "");
+    for (int i = 0; i < argc && i < CALL_ARG_MAX; i++) {
+        sb_add(out, outsz, oi, "%s%s", i ? ", " : "", args[i]);
+        if (literal && i > 0) sb_add(out, outsz, oi, ", %ld", lens[i]);
+    }
+    sb_add(out, outsz, oi, ")");
+    return replace ? TY_STRING : TY_BOOL;
+}
+
+// s.ganti_akeh(pola1, ganti1, pola2, ganti2, ...): every pattern is
+// replaced in one scan (string_ganti_banyak); a missing last replacement
+// is ""
+static Ty parse_replace_many(Lexer *L, ParserContext *ctx, const char *recv, char *out, size_t outsz, int *oi) {
+    char finds[2048] = "", replaces[2048] = "";
+    int fi = 0, ri = 0, argc = 0;
+    while (L->cur.kind != T_RPAREN && L->cur.kind != T_EOF) {
+        char arg[1024] = "";
+        int ai = 0;
+        parse_expr(L, arg, sizeof(arg), &ai, ctx);
+        if (argc % 2 == 0) sb_add(finds, sizeof(finds), &fi, "%s%s", argc ? ", " : "", arg);
+        else sb_add(replaces, sizeof(replaces), &ri, "%s%s", argc > 1 ? ", " : "", arg);
+        argc++;
+        if (L->cur.kind == T_COMMA) lex_next(L);
+    }
+    if (L->cur.kind == T_RPAREN) lex_next(L);
+    if (argc % 2) sb_add(replaces, sizeof(replaces), &ri, "%s\"\"", argc > 1 ? ", " : "");
+    int n = (argc + 1) / 2;
+    if (n == 0) sb_add(out, outsz, oi, "string_ganti_banyak(%s, NULL, NULL, 0)", recv);
+    else sb_add(out, outsz, oi, "string_ganti_banyak(%s, (const char*[]){ %s }, (const char*[]){ %s }, %d)",
+                recv, finds, replaces, n);
+    return TY_STRING;
+}
+
+static bool is_string_call(const char *c_name) {
+    return strcmp(c_name, "replace") == 0 || strcmp(c_name, "ngandhut") == 0 ||
+           strcmp(c_name, "miwiti") == 0 || strcmp(c_name, "mungkasi") == 0;
+}
+
 static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
     Token t = L->cur;
     
@@ -131,7 +311,10 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
             strcmp(t.lex, "concat") == 0 || strcmp(t.lex, "gabung") == 0 ||
             strcmp(t.lex, "replace") == 0 || strcmp(t.lex, "ganti") == 0 ||
             strcmp(t.lex, "substring") == 0 || strcmp(t.lex, "potong") == 0 ||
-            strcmp(t.lex, "length") == 0 || strcmp(t.lex, "dawane") == 0) {
+            strcmp(t.lex, "length") == 0 || strcmp(t.lex, "dawane") == 0 ||
+            strcmp(t.lex, "toInt") == 0 || strcmp(t.lex, "menyang_angka") == 0 ||
+            strcmp(t.lex, "toDouble") == 0 || strcmp(t.lex, "menyang_desimal") == 0 ||
+            strcmp(t.lex, "ngandhut") == 0 || strcmp(t.lex, "miwiti") == 0 || strcmp(t.lex, "mungkasi") == 0) {
             
             char func_name[64];
             strncpy(func_name, t.lex, sizeof(func_name) - 1);
@@ -141,13 +324,35 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
             if (L->cur.kind == T_LPAREN) {
                 lex_next(L); // consume '('
                 
+                // Javanese spellings share the English runtime functions
+                const char *c_name = func_name;
+                if (strcmp(func_name, "menyang_gedhe") == 0) c_name = "toUpperCase";
+                else if (strcmp(func_name, "menyang_cilik") == 0) c_name = "toLowerCase";
+                else if (strcmp(func_name, "pisah") == 0) c_name = "split";
+                else if (strcmp(func_name, "gabung") == 0) c_name = "concat";
+                else if (strcmp(func_name, "ganti") == 0) c_name = "replace";
+                else if (strcmp(func_name, "potong") == 0) c_name = "substring";
+                else if (strcmp(func_name, "dawane") == 0) c_name = "length";
+                else if (strcmp(func_name, "menyang_angka") == 0) c_name = "toInt";
+                else if (strcmp(func_name, "menyang_desimal") == 0) c_name = "toDouble";
+                if (is_string_call(c_name)) {
+                    char args[CALL_ARG_MAX][1024] = { { 0 } };
+                    int argc = parse_call_args(L, ctx, args, 0, CALL_ARG_MAX);
+                    return emit_string_call(c_name, args, argc, out, outsz, oi);
+                }
+                bool case_call = strcmp(c_name, "toUpperCase") == 0 || strcmp(c_name, "toLowerCase") == 0;
+                int name_end = 0;
+                
                 // Special handling for int_to_string (no prefix needed)
                 if (strcmp(func_name, "int_to_string") == 0) {
                     sb_add(out, outsz, oi, "int_to_string(");
                 } else {
                     // Map to corresponding C function with string_ prefix
-                    sb_add(out, outsz, oi, "string_%s(", func_name);
+                    sb_add(out, outsz, oi, "string_%s", c_name);
+                    name_end = *oi;
+                    sb_add(out, outsz, oi, "(");
                 }
+                int arg_start = *oi;
                 
                 // Parse arguments
                 int arg_count = 0;
@@ -167,7 +372,18 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
                     lex_next(L); // consume ')'
                 }
                 
+                // Converting a temporary: reuse its buffer instead of copying
+                if (case_call && arg_count == 1 && is_fresh_string(out + arg_start, *oi - arg_start) &&
+                    *oi + 8 < (int)outsz) {
+                    memmove(out + name_end + 8, out + name_end, *oi - name_end);
+                    memcpy(out + name_end, "_inplace", 8);
+                    *oi += 8;
+                    out[*oi] = 0;
+                }
+                
                 sb_add(out, outsz, oi, ")");
+                if (strcmp(c_name, "toInt") == 0) return TY_INT;
+                if (strcmp(c_name, "toDouble") == 0) return TY_DOUBLE;
                 return TY_STRING; // Most string functions return string
             }
         }
@@ -179,13 +395,32 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
         Ty ty = parser_get_var_type(ctx, t.lex);
         lex_next(L);
         
+        // A tugas handle remembers the type "tunggu" will produce
+        if (ty == TY_TASK) ctx->task_ty = parser_get_var_elem(ctx, var_name);
+        
         // Check if this is a function call
         if (L->cur.kind == T_LPAREN) {
             // This is a function call
             lex_next(L); // consume '('
             
+            // Tasks and channels go to the tugas runtime
+            Ty async_ret = TY_UNK;
+            bool async_call = parser_is_async(ctx, var_name, &async_ret);
+            Ty chan_elem = TY_UNK;
+            bool tampa = strcmp(var_name, "tampa") == 0;
+            if (strcmp(var_name, "kirim") == 0) {
+                return parse_kirim(L, out, outsz, oi, ctx);
+            }
+            if (tampa && L->cur.kind == T_IDENT) {
+                chan_elem = parser_get_var_elem(ctx, L->cur.lex);
+            }
+            
             // Add function name
-            sb_add(out, outsz, oi, "%s(", var_name);
+            if (async_call) sb_add(out, outsz, oi, "%s_async(", var_name);
+            else if (strcmp(var_name, "kanal") == 0) sb_add(out, outsz, oi, "kanal_anyar(");
+            else if (strcmp(var_name, "tutup_kanal") == 0) sb_add(out, outsz, oi, "kanal_tutup(");
+            else if (tampa) sb_add(out, outsz, oi, "%skanal_tampa(", chan_elem == TY_BOOL ? "(" : "");
+            else sb_add(out, outsz, oi, "%s(", var_name);
             
             // Parse arguments
             int arg_count = 0;
@@ -206,6 +441,16 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
             }
             
             sb_add(out, outsz, oi, ")");
+            if (async_call) {
+                ctx->task_ty = async_ret;
+                return TY_TASK;
+            }
+            if (strcmp(var_name, "kanal") == 0) return TY_CHAN;
+            if (tampa) {
+                if (chan_elem == TY_UNK) chan_elem = TY_DOUBLE;
+                sb_add(out, outsz, oi, chan_elem == TY_BOOL ? ".i != 0)" : ".%s", parser_nilai_field(chan_elem));
+                return chan_elem;
+            }
             return ty == TY_UNK ? TY_DOUBLE : ty; // Default to double if type unknown
         }
         
@@ -226,29 +471,44 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
                     // Special handling for split method
                     if (strcmp(method_name, "split") == 0 || strcmp(method_name, "pisah") == 0) {
                         // Generate unique variable for this split operation
-                        static int split_counter = 0;
                         char split_var[32];
-                        snprintf(split_var, sizeof(split_var), "split_count_%d", split_counter++);
+                        snprintf(split_var, sizeof(split_var), "split_count_%d", ctx->split_serial++);
                         
-                        sb_add(out, outsz, oi, "({ int %s = 0; char** split_result = string_split(%s", split_var, var_name);
-                        if (L->cur.kind != T_RPAREN) {
-                            sb_add(out, outsz, oi, ", ");
-                            parse_expr(L, out, outsz, oi, ctx);
-                            sb_add(out, outsz, oi, ", &%s); create_array_literal_from_split(split_result, %s); })", split_var, split_var);
+                        // A one-byte literal delimiter (the default is ",")
+                        // splits with strchr instead of a strcspn set
+                        char args[CALL_ARG_MAX][1024] = { { 0 } };
+                        if (parse_call_args(L, ctx, args, 0, CALL_ARG_MAX) == 0) strcpy(args[0], "\",\"");
+                        sb_add(out, outsz, oi, "({ int %s = 0; char** split_result = ", split_var);
+                        if (literal_length(args[0]) == 1) {
+                            const char *c = args[0] + 1;
+                            sb_add(out, outsz, oi, "string_split_char(%s, '%.*s'", var_name,
+                                   *c == '\\' || *c == '\'' ? 2 : 1, *c == '\'' ? "\\'" : c);
                         } else {
-                            sb_add(out, outsz, oi, ", \",\", &%s); create_array_literal_from_split(split_result, %s); })", split_var, split_var);
-                        }
-                        
-                        if (L->cur.kind == T_RPAREN) {
-                            lex_next(L);
+                            sb_add(out, outsz, oi, "string_split(%s, %s", var_name, args[0]);
                         }
+                        sb_add(out, outsz, oi, ", &%s); create_array_literal_from_split(split_result, %s); })", split_var, split_var);
                         return TY_ARRAY;
+                    } else if (ty == TY_ARRAY && (strcmp(method_name, "join") == 0 || strcmp(method_name, "gabung") == 0)) {
+                        // One pass over the elements, see string_gabung_daftar
+                        char args[CALL_ARG_MAX][1024] = { { 0 } };
+                        if (parse_call_args(L, ctx, args, 0, CALL_ARG_MAX) == 0) strcpy(args[0], "\",\"");
+                        sb_add(out, outsz, oi, "string_gabung_daftar(%s, %s)", var_name, args[0]);
+                        return TY_STRING;
+                    } else if (strcmp(method_name, "ganti_akeh") == 0 || strcmp(method_name, "replaceMany") == 0) {
+                        return parse_replace_many(L, ctx, var_name, out, outsz, oi);
                     } else if (strcmp(method_name, "length") == 0 || strcmp(method_name, "dawane") == 0) {
                         // Special handling for length() method call - return as string for concatenation
-                        if (ty == TY_STRING) {
-                            sb_add(out, outsz, oi, "int_to_string(string_length(%s))", var_name);
-                        } else if (ty == TY_ARRAY) {
-                            sb_add(out, outsz, oi, "int_to_string(array_get_length(%s))", var_name);
+                        if (ty == TY_STRING || ty == TY_ARRAY) {
+                            char len_call[256], conv_call[320];
+                            const char *len_args[] = { var_name };
+                            snprintf(len_call, sizeof(len_call), "%s(%s)",
+                                     ty == TY_STRING ? "string_length" : "array_get_length", var_name);
+                            hoist_call(ctx, len_call, sizeof(len_call), len_args, 1, TY_INT);
+                            
+                            const char *conv_args[] = { len_call };
+                            snprintf(conv_call, sizeof(conv_call), "int_to_string(%s)", len_call);
+                            hoist_call(ctx, conv_call, sizeof(conv_call), conv_args, 1, TY_STRING);
+                            sb_add(out, outsz, oi, "%s", conv_call);
                         }
                         
                         if (L->cur.kind == T_RPAREN) {
@@ -266,6 +526,17 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
                         else if (strcmp(method_name, "ganti") == 0) actual_method = "replace";
                         else if (strcmp(method_name, "potong") == 0) actual_method = "substring";
                         else if (strcmp(method_name, "dawane") == 0) actual_method = "length";
+                        else if (strcmp(method_name, "contains") == 0) actual_method = "ngandhut";
+                        else if (strcmp(method_name, "startsWith") == 0) actual_method = "miwiti";
+                        else if (strcmp(method_name, "endsWith") == 0) actual_method = "mungkasi";
+                        else if (strcmp(method_name, "repeat") == 0) actual_method = "ulang";
+                        
+                        if (is_string_call(actual_method)) {
+                            char args[CALL_ARG_MAX][1024] = { { 0 } };
+                            snprintf(args[0], sizeof(args[0]), "%s", var_name);
+                            int argc = parse_call_args(L, ctx, args, 1, CALL_ARG_MAX);
+                            return emit_string_call(actual_method, args, argc, out, outsz, oi);
+                        }
                         
                         sb_add(out, outsz, oi, "string_%s(%s", actual_method, var_name);
                         
@@ -286,16 +557,18 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
                         }
                         
                         sb_add(out, outsz, oi, ")");
-                        return TY_STRING;
+                        return strcmp(actual_method, "indexOf") == 0 ? TY_INT : TY_STRING;
                     }
                 } else {
                     // Property access (like .length or .dawane)
                     if (strcmp(method_name, "length") == 0 || strcmp(method_name, "dawane") == 0) {
-                        if (ty == TY_STRING) {
-                            sb_add(out, outsz, oi, "string_length(%s)", var_name);
-                            return TY_INT;
-                        } else if (ty == TY_ARRAY) {
-                            sb_add(out, outsz, oi, "array_get_length(%s)", var_name);
+                        if (ty == TY_STRING || ty == TY_ARRAY) {
+                            char len_call[256];
+                            const char *len_args[] = { var_name };
+                            snprintf(len_call, sizeof(len_call), "%s(%s)",
+                                     ty == TY_STRING ? "string_length" : "array_get_length", var_name);
+                            hoist_call(ctx, len_call, sizeof(len_call), len_args, 1, TY_INT);
+                            sb_add(out, outsz, oi, "%s", len_call);
                             return TY_INT;
                         }
                     }
@@ -335,9 +608,13 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
         return ty ? ty : TY_UNK;
     }
     if (t.kind == T_LPAREN) { 
+        int start = *oi;
         lex_next(L); 
+        sb_add(out, outsz, oi, "(");
         Ty inner = parse_expr(L, out, outsz, oi, ctx); 
+        sb_add(out, outsz, oi, ")");
         if (L->cur.kind == T_RPAREN) lex_next(L); 
+        fold_constant(out, outsz, oi, start);
         return inner; 
     }
     if (t.kind == T_LBRACKET) {
@@ -371,40 +648,80 @@ static Ty parse_primary(Lexer *L, char *out, size_t outsz, int *oi, ParserContex
 }
 
 static Ty parse_unary(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     if (L->cur.kind == T_NOT) { 
         lex_next(L); 
         sb_add(out, outsz, oi, "(!"); 
         (void)parse_unary(L, out, outsz, oi, ctx); 
         sb_add(out, outsz, oi, ")"); 
+        fold_constant(out, outsz, oi, start);
         return TY_BOOL; 
     }
     if (L->cur.kind == T_PLUS) { 
         lex_next(L); 
         return parse_unary(L, out, outsz, oi, ctx); 
     }
+    // "tunggu e" waits for the task e and yields its result
+    if (L->cur.kind == T_IDENT && strcmp(L->cur.lex, "tunggu") == 0) {
+        lex_next(L);
+        sb_add(out, outsz, oi, "(tugas_tunggu(");
+        Ty ty = parse_unary(L, out, outsz, oi, ctx);
+        if (ty != TY_TASK) {
+            // Not a task: the value is already there
+            memmove(out + start, out + start + 14, *oi - start - 14);
+            *oi -= 14;
+            out[*oi] = 0;
+            return ty;
+        }
+        // tugas_tunggu frees the task and clears the handle, so a variable
+        // is passed by address; any other task expression gets a temporary
+        bool ident = *oi > start + 14;
+        for (int k = start + 14; k < *oi; k++) {
+            if (!isalnum((unsigned char)out[k]) && out[k] != '_') ident = false;
+        }
+        const char *pre = ident ? "&" : "&(JawaTugas*){";
+        int pn = (int)strlen(pre);
+        if (*oi + pn + 1 < (int)outsz) {
+            memmove(out + start + 14 + pn, out + start + 14, *oi - start - 14);
+            memcpy(out + start + 14, pre, pn);
+            *oi += pn;
+            out[*oi] = 0;
+            if (!ident) sb_add(out, outsz, oi, "}");
+        }
+        Ty res = ctx->task_ty == TY_UNK ? TY_DOUBLE : ctx->task_ty;
+        if (res == TY_BOOL) sb_add(out, outsz, oi, ").i != 0)");
+        else sb_add(out, outsz, oi, ").%s)", parser_nilai_field(res));
+        return res;
+    }
     if (L->cur.kind == T_MINUS) { 
         lex_next(L); 
         sb_add(out, outsz, oi, "(-"); 
         Ty ty = parse_unary(L, out, outsz, oi, ctx); 
         sb_add(out, outsz, oi, ")"); 
+        fold_constant(out, outsz, oi, start);
         return (ty == TY_DOUBLE) ? TY_DOUBLE : TY_INT; 
     }
     return parse_primary(L, out, outsz, oi, ctx);
 }
 
 static Ty parse_mul(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_unary(L, out, outsz, oi, ctx);
     while (L->cur.kind == T_STAR || L->cur.kind == T_SLASH || L->cur.kind == T_PERCENT) {
         TokKind op = L->cur.kind; 
+        int lend = *oi;
         lex_next(L);
         sb_add(out, outsz, oi, " %s ", op == T_STAR ? "*" : (op == T_SLASH ? "/" : "%"));
+        int rstart = *oi;
         Ty right = parse_unary(L, out, outsz, oi, ctx);
+        fold_binary(out, outsz, oi, start, lend, rstart, op);
         left = promote_num(left, right, op == T_SLASH);
     }
     return left;
 }
 
 static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_mul(L, out, outsz, oi, ctx);
     
     while (L->cur.kind == T_PLUS || L->cur.kind == T_MINUS) {
@@ -413,8 +730,9 @@ static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *c
         if (op == T_PLUS && left == TY_STRING) {
             // String concatenation - capture left expression  
             char left_expr[4096];  // Increased buffer size
-            int left_len = *oi;
-            strncpy(left_expr, out, left_len);
+            int left_len = *oi - start;
+            if (left_len >= (int)sizeof(left_expr)) left_len = sizeof(left_expr) - 1;
+            strncpy(left_expr, out + start, left_len);
             left_expr[left_len] = 0;
             
             lex_next(L); // consume '+'
@@ -425,6 +743,12 @@ static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *c
             Ty right = parse_mul(L, right_expr, sizeof(right_expr), &right_oi, ctx);
             right_expr[right_oi] = 0;
             
+            // Literal operands are joined at compile time
+            if (fold_string_concat(out, outsz, oi, start, right_expr, right)) {
+                left = TY_STRING;
+                continue;
+            }
+            
             // Auto-convert types for string concatenation
             char final_right[4096];  // Increased buffer size
             
@@ -434,10 +758,11 @@ static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *c
                 fprintf(stderr, "Warning: Expression too long, truncating\n");
                 strncpy(final_right, right_expr, sizeof(final_right) - 1);
                 final_right[sizeof(final_right) - 1] = '\0';
-            } else if (right == TY_INT) {
-                snprintf(final_right, sizeof(final_right), "int_to_string(%s)", right_expr);
-            } else if (right == TY_DOUBLE) {
-                snprintf(final_right, sizeof(final_right), "double_to_string(%s)", right_expr);
+            } else if (right == TY_INT || right == TY_DOUBLE) {
+                const char *conv_args[] = { right_expr };
+                snprintf(final_right, sizeof(final_right), "%s(%s)",
+                         right == TY_INT ? "int_to_string" : "double_to_string", right_expr);
+                hoist_call(ctx, final_right, sizeof(final_right), conv_args, 1, TY_STRING);
             } else if (right == TY_BOOL) {
                 snprintf(final_right, sizeof(final_right), "(%s) ? \"true\" : \"false\"", right_expr);
             } else {
@@ -446,14 +771,21 @@ static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *c
             }
             
             // Generate string_concat call
-            *oi = 0;
-            sb_add(out, outsz, oi, "string_concat(%s, %s)", left_expr, final_right);
+            char concat_call[8448];
+            const char *concat_args[] = { left_expr, final_right };
+            snprintf(concat_call, sizeof(concat_call), "string_concat(%s, %s)", left_expr, final_right);
+            hoist_call(ctx, concat_call, sizeof(concat_call), concat_args, 2, TY_STRING);
+            *oi = start;
+            sb_add(out, outsz, oi, "%s", concat_call);
             left = TY_STRING;
         } else {
             // Numeric operations
+            int lend = *oi;
             lex_next(L);
             sb_add(out, outsz, oi, " %s ", op == T_PLUS ? "+" : "-");
+            int rstart = *oi;
             Ty right = parse_mul(L, out, outsz, oi, ctx);
+            fold_binary(out, outsz, oi, start, lend, rstart, op);
             left = promote_num(left, right, 0);
         }
     }
@@ -461,51 +793,67 @@ static Ty parse_add(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *c
 }
 
 static Ty parse_rel(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_add(L, out, outsz, oi, ctx);
     while (L->cur.kind == T_LT || L->cur.kind == T_GT || L->cur.kind == T_LE || L->cur.kind == T_GE) {
         TokKind op = L->cur.kind; 
+        int lend = *oi;
         lex_next(L);
         const char *sym = op == T_LT ? "<" : op == T_GT ? ">" : op == T_LE ? "<=" : ">=";
         sb_add(out, outsz, oi, " %s ", sym);
+        int rstart = *oi;
         Ty right = parse_add(L, out, outsz, oi, ctx);
         (void)right; 
+        fold_binary(out, outsz, oi, start, lend, rstart, op);
         left = TY_BOOL;
     }
     return left;
 }
 
 static Ty parse_eq(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_rel(L, out, outsz, oi, ctx);
     while (L->cur.kind == T_EQ || L->cur.kind == T_NE) {
         TokKind op = L->cur.kind; 
+        int lend = *oi;
         lex_next(L);
         sb_add(out, outsz, oi, " %s ", op == T_EQ ? "==" : "!=");
+        int rstart = *oi;
         Ty right = parse_rel(L, out, outsz, oi, ctx);
         (void)right; 
+        fold_binary(out, outsz, oi, start, lend, rstart, op);
         left = TY_BOOL;
     }
     return left;
 }
 
 static Ty parse_and(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_eq(L, out, outsz, oi, ctx);
     while (L->cur.kind == T_AND) { 
+        int lend = *oi;
         lex_next(L); 
         sb_add(out, outsz, oi, " && "); 
+        int rstart = *oi;
         Ty right = parse_eq(L, out, outsz, oi, ctx); 
         (void)right; 
+        fold_binary(out, outsz, oi, start, lend, rstart, T_AND);
         left = TY_BOOL; 
     }
     return left;
 }
 
 Ty parse_expr(Lexer *L, char *out, size_t outsz, int *oi, ParserContext *ctx) {
+    int start = *oi;
     Ty left = parse_and(L, out, outsz, oi, ctx);
     while (L->cur.kind == T_OR) { 
+        int lend = *oi;
         lex_next(L); 
         sb_add(out, outsz, oi, " || "); 
+        int rstart = *oi;
         Ty right = parse_and(L, out, outsz, oi, ctx); 
         (void)right; 
+        fold_binary(out, outsz, oi, start, lend, rstart, T_OR);
         left = TY_BOOL; 
     }
     return left;
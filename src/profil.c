@@ -0,0 +1,160 @@
+#define _GNU_SOURCE
+#include "profil.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <execinfo.h>
+#include <link.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+
+#define PIGURA_MAX 64          // kedalaman tumpukan paling dalam per sampel
+#define BUFFER_WORD (4u << 20) // 32 MB: kira-kira 4 menit sampel 1000 Hz sedalam 16
+
+// Sampel: [n, pigura_1 .. pigura_n]; n ditulis paling akhir, jadi n == 0
+// berarti sampel belum lengkap
+static uintptr_t* buffer;
+static size_t isi;             // word terpakai, ditambah atomik dari sinyal
+static size_t ilang;
+static const char* path_sampel;
+static int hz;
+
+static void sinyal(int sig) {
+    (void)sig;
+    void* pigura[PIGURA_MAX + 2];
+    int n = backtrace(pigura, PIGURA_MAX + 2);
+    // pigura[0] handler iki, pigura[1] trampolin sinyal
+    if (n <= 2) return;
+    n -= 2;
+    size_t i = __atomic_fetch_add(&isi, (size_t)n + 1, __ATOMIC_RELAXED);
+    if (i + n + 1 > BUFFER_WORD) {
+        __atomic_fetch_add(&ilang, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    for (int k = 0; k < n; k++) buffer[i + 1 + k] = (uintptr_t)pigura[k + 2];
+    __atomic_store_n(&buffer[i], (uintptr_t)n, __ATOMIC_RELEASE);
+}
+
+// Segmen PT_LOAD tiap objek yang dimuat; objek pertama program iku dhewe
+typedef struct {
+    uintptr_t awal, akhir;
+    uintptr_t basis;
+    const char* nama;
+    bool program;
+} Wilayah;
+
+typedef struct {
+    Wilayah isi[256];
+    int cacah;
+    int objek;
+} PetaWilayah;
+
+static int catat_wilayah(struct dl_phdr_info* info, size_t size, void* data) {
+    (void)size;
+    PetaWilayah* peta = data;
+    bool program = peta->objek++ == 0;
+    const char* nama = info->dlpi_name ? strrchr(info->dlpi_name, '/') : NULL;
+    nama = nama ? nama + 1 : (info->dlpi_name && *info->dlpi_name ? info->dlpi_name : "?");
+    for (int i = 0; i < info->dlpi_phnum && peta->cacah < 256; i++) {
+        const ElfW(Phdr)* ph = &info->dlpi_phdr[i];
+        if (ph->p_type != PT_LOAD) continue;
+        Wilayah* w = &peta->isi[peta->cacah++];
+        w->awal = info->dlpi_addr + ph->p_vaddr;
+        w->akhir = w->awal + ph->p_memsz;
+        w->basis = info->dlpi_addr;
+        w->nama = nama;
+        w->program = program;
+    }
+    return 0;
+}
+
+static void tulis_pigura(FILE* f, const PetaWilayah* peta, uintptr_t alamat) {
+    for (int i = 0; i < peta->cacah; i++) {
+        const Wilayah* w = &peta->isi[i];
+        if (alamat < w->awal || alamat >= w->akhir) continue;
+        if (w->program) fprintf(f, " 0x%llx", (unsigned long long)(alamat - w->basis));
+        else fprintf(f, " @%s", w->nama);
+        return;
+    }
+    fputs(" @?", f);
+}
+
+void profil_rampung(void) {
+    if (!buffer) return;
+    struct itimerval mati;
+    memset(&mati, 0, sizeof(mati));
+    setitimer(ITIMER_PROF, &mati, NULL);
+    signal(SIGPROF, SIG_IGN);
+
+    FILE* f = fopen(path_sampel, "w");
+    if (!f) {
+        perror(path_sampel);
+    } else {
+        PetaWilayah* peta = calloc(1, sizeof(PetaWilayah));
+        if (peta) dl_iterate_phdr(catat_wilayah, peta);
+        fprintf(f, "JAWAPROFIL 1 %d\n", hz);
+        size_t batas = isi < BUFFER_WORD ? isi : BUFFER_WORD;
+        for (size_t i = 0; peta && i < batas; ) {
+            size_t n = __atomic_load_n(&buffer[i], __ATOMIC_ACQUIRE);
+            if (n == 0 || i + 1 + n > batas) break;
+            fprintf(f, "%zu", n);
+            for (size_t k = 0; k < n; k++) tulis_pigura(f, peta, buffer[i + 1 + k]);
+            fputc('\n', f);
+            i += n + 1;
+        }
+        fprintf(f, "ilang %zu\n", ilang);
+        fprintf(f, "detik %.3f\n", (double)clock() / CLOCKS_PER_SEC);
+        fclose(f);
+        free(peta);
+    }
+    free(buffer);
+    buffer = NULL;
+}
+
+__attribute__((constructor)) static void profil_mulai(void) {
+    path_sampel = getenv("JAWA_PROFIL");
+    if (!path_sampel || !*path_sampel) return;
+    const char* h = getenv("JAWA_PROFIL_HZ");
+    hz = h ? atoi(h) : 0;
+    if (hz <= 0 || hz > 100000) hz = 1000;
+    buffer = calloc(BUFFER_WORD, sizeof(uintptr_t));
+    if (!buffer) return;
+
+    // Panggilan pertama backtrace memuat libgcc; jangan sampai di sinyal
+    void* pemanasan[4];
+    backtrace(pemanasan, 4);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = sinyal;
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGPROF, &sa, NULL);
+    atexit(profil_rampung);
+
+    struct itimerval t;
+    t.it_interval.tv_sec = 0;
+    t.it_interval.tv_usec = 1000000 / hz;
+    t.it_value = t.it_interval;
+    setitimer(ITIMER_PROF, &t, NULL);
+}
+
+#else
+
+// Belum ada SIGPROF/dl_iterate_phdr: program jalan tanpa sampling
+void profil_rampung(void) {
+}
+
+#if defined(__GNUC__)
+__attribute__((constructor)) static void profil_mulai(void) {
+    const char* p = getenv("JAWA_PROFIL");
+    if (p && *p) fprintf(stderr, "jawa profile: sampling belum didukung di platform iki\n");
+}
+#endif
+
+#endif
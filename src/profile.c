@@ -0,0 +1,426 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+#include "native.h"
+#include "build.h"
+
+// "jawa profile": the program is built with #line directives and -g and
+// linked with the sampler in profil.c, which writes the sampled stacks
+// when it exits. addr2line maps the program's frames back to functions
+// and .jw lines.
+
+#define REPORT_ROWS 20
+
+// Keys with counts: sites, lines, functions and folded stacks
+typedef struct {
+    char **keys;
+    long *self;
+    long *total;
+    long *seen;       // last sample counted in total, to count each once
+    size_t cap;
+    size_t count;
+    int *slots;       // open addressing; -1 = empty
+    size_t nslots;
+} Tally;
+
+static bool tally_grow(Tally *t) {
+    size_t cap = t->cap ? t->cap * 2 : 256;
+    char **keys = realloc(t->keys, cap * sizeof(char *));
+    if (keys) t->keys = keys;
+    long *self = realloc(t->self, cap * sizeof(long));
+    if (self) t->self = self;
+    long *total = realloc(t->total, cap * sizeof(long));
+    if (total) t->total = total;
+    long *seen = realloc(t->seen, cap * sizeof(long));
+    if (seen) t->seen = seen;
+    int *slots = malloc(cap * 2 * sizeof(int));
+    if (!keys || !self || !total || !seen || !slots) {
+        free(slots);
+        return false;
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->nslots = cap * 2;
+    t->cap = cap;
+    for (size_t i = 0; i < t->nslots; i++) t->slots[i] = -1;
+    for (size_t i = 0; i < t->count; i++) {
+        size_t s = build_hash(BUILD_HASH_INIT, t->keys[i], strlen(t->keys[i])) % t->nslots;
+        while (t->slots[s] >= 0) s = (s + 1) % t->nslots;
+        t->slots[s] = (int)i;
+    }
+    return true;
+}
+
+// Index of key, added with zero counts if new; -1 if out of memory
+static long tally_index(Tally *t, const char *key) {
+    if (t->count == t->cap && !tally_grow(t)) return -1;
+    size_t s = build_hash(BUILD_HASH_INIT, key, strlen(key)) % t->nslots;
+    while (t->slots[s] >= 0) {
+        if (strcmp(t->keys[t->slots[s]], key) == 0) return t->slots[s];
+        s = (s + 1) % t->nslots;
+    }
+    char *copy = strdup(key);
+    if (!copy) return -1;
+    size_t i = t->count++;
+    t->keys[i] = copy;
+    t->self[i] = t->total[i] = 0;
+    t->seen[i] = -1;
+    t->slots[s] = (int)i;
+    return (long)i;
+}
+
+static void tally_count(Tally *t, const char *key, long sample, bool self) {
+    long i = tally_index(t, key);
+    if (i < 0) return;
+    if (self) t->self[i]++;
+    if (t->seen[i] != sample) {
+        t->seen[i] = sample;
+        t->total[i]++;
+    }
+}
+
+static void tally_free(Tally *t) {
+    for (size_t i = 0; i < t->count; i++) free(t->keys[i]);
+    free(t->keys);
+    free(t->self);
+    free(t->total);
+    free(t->seen);
+    free(t->slots);
+    memset(t, 0, sizeof(*t));
+}
+
+// Rows of t ordered by self, then total time
+static const Tally *sort_tally;
+
+static int by_self(const void *a, const void *b) {
+    size_t i = *(const size_t *)a, j = *(const size_t *)b;
+    if (sort_tally->self[i] != sort_tally->self[j]) return sort_tally->self[i] < sort_tally->self[j] ? 1 : -1;
+    if (sort_tally->total[i] != sort_tally->total[j]) return sort_tally->total[i] < sort_tally->total[j] ? 1 : -1;
+    return strcmp(sort_tally->keys[i], sort_tally->keys[j]);
+}
+
+static size_t *tally_order(const Tally *t) {
+    size_t *order = malloc((t->count + 1) * sizeof(size_t));
+    if (!order) return NULL;
+    for (size_t i = 0; i < t->count; i++) order[i] = i;
+    sort_tally = t;
+    qsort(order, t->count, sizeof(size_t), by_self);
+    sort_tally = NULL;
+    return order;
+}
+
+// What a site of the sample file resolved to
+typedef struct {
+    char *func;
+    char *file;       // .jw source, NULL for anything else
+    int line;
+    bool program;     // in the program binary (not a shared library)
+} Site;
+
+// Resolve the program's sites with one addr2line run. Site keys are the
+// addresses to look up: "0x..." in the binary, "@lib" for libraries.
+static void resolve_sites(const Tally *sites, Site *out, const char *bin) {
+    char addr_path[FILENAME_MAX], sym_path[FILENAME_MAX];
+    snprintf(addr_path, sizeof(addr_path), "%s.addr", bin);
+    snprintf(sym_path, sizeof(sym_path), "%s.sym", bin);
+
+    FILE *f = fopen(addr_path, "w");
+    size_t program = 0;
+    for (size_t i = 0; i < sites->count; i++) {
+        const char *key = sites->keys[i];
+        out[i].program = key[0] == '0';
+        out[i].file = NULL;
+        out[i].line = 0;
+        if (!out[i].program) {
+            // "@libc.so.6" -> "[libc.so.6]"
+            size_t len = strlen(key);
+            out[i].func = malloc(len + 2);
+            if (out[i].func) snprintf(out[i].func, len + 2, "[%s]", key + 1);
+            continue;
+        }
+        out[i].func = NULL;
+        if (f) fprintf(f, "%s\n", key);
+        program++;
+    }
+    if (f) fclose(f);
+
+    char cmd[3 * FILENAME_MAX + 64];
+    snprintf(cmd, sizeof(cmd), "addr2line -f -e '%s' < '%s' > '%s'", bin, addr_path, sym_path);
+    FILE *sym = NULL;
+    if (program > 0 && f && system(cmd) == 0) sym = fopen(sym_path, "r");
+    if (program > 0 && !sym) fprintf(stderr, "addr2line failed; install binutils for function and line names\n");
+
+    char func[512], where[FILENAME_MAX + 64];
+    for (size_t i = 0; i < sites->count; i++) {
+        if (!out[i].program) continue;
+        if (sym && fgets(func, sizeof(func), sym) && fgets(where, sizeof(where), sym)) {
+            func[strcspn(func, "\r\n")] = 0;
+            where[strcspn(where, "\r\n")] = 0;
+            char *disc = strstr(where, " (discriminator");
+            if (disc) *disc = 0;
+            char *colon = strrchr(where, ':');
+            if (colon && colon - where > 3 && strncmp(colon - 3, ".jw", 3) == 0) {
+                *colon = 0;
+                out[i].file = strdup(where);
+                out[i].line = atoi(colon + 1);
+            }
+            out[i].func = strdup(strcmp(func, "??") == 0 ? sites->keys[i] : func);
+        } else {
+            out[i].func = strdup(sites->keys[i]);
+        }
+    }
+    if (sym) fclose(sym);
+    unlink(addr_path);
+    unlink(sym_path);
+}
+
+// Text of line n of path, trimmed, into buf
+static void source_text(const char *path, int n, char *buf, size_t bufsz) {
+    buf[0] = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    char line[512];
+    for (int i = 1; fgets(line, sizeof(line), f); i++) {
+        if (i < n) continue;
+        char *p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        p[strcspn(p, "\r\n")] = 0;
+        snprintf(buf, bufsz, "%s", p);
+        break;
+    }
+    fclose(f);
+}
+
+static void print_rows(const Tally *t, long samples, bool lines) {
+    size_t *order = tally_order(t);
+    if (!order) return;
+    printf("   self   total  %s\n", lines ? "line" : "function");
+    for (size_t r = 0; r < t->count && r < REPORT_ROWS; r++) {
+        size_t i = order[r];
+        printf(" %5.1f%%  %5.1f%%  %s", 100.0 * t->self[i] / samples, 100.0 * t->total[i] / samples, t->keys[i]);
+        if (lines) {
+            // key is "file:line"
+            char path[FILENAME_MAX], text[256];
+            snprintf(path, sizeof(path), "%s", t->keys[i]);
+            char *colon = strrchr(path, ':');
+            if (colon) {
+                *colon = 0;
+                source_text(path, atoi(colon + 1), text, sizeof(text));
+                if (text[0]) printf("  %s", text);
+            }
+        }
+        putchar('\n');
+    }
+    free(order);
+}
+
+// Aggregate the sample file into the report and the folded stacks
+static int report(const char *samples_path, const char *bin, const char *folded_path) {
+    FILE *in = fopen(samples_path, "r");
+    if (!in) {
+        fprintf(stderr, "No profile samples written (%s)\n", samples_path);
+        return 1;
+    }
+
+    char line[8192];
+    int hz = 0;
+    if (!fgets(line, sizeof(line), in) || sscanf(line, "JAWAPROFIL 1 %d", &hz) != 1) {
+        fprintf(stderr, "%s: not a profile sample file\n", samples_path);
+        fclose(in);
+        return 1;
+    }
+
+    // Samples as site indices, innermost frame first. Return addresses
+    // are looked up one byte back so they map to the calling line.
+    Tally sites = {0};
+    long *frames = NULL;
+    size_t nframes = 0, cap = 0;
+    long *starts = NULL;
+    long samples = 0, lost = 0;
+    double cpu = 0;
+    size_t starts_cap = 0;
+    while (fgets(line, sizeof(line), in)) {
+        if (sscanf(line, "ilang %ld", &lost) == 1 || sscanf(line, "detik %lf", &cpu) == 1) continue;
+        char *save = NULL;
+        char *tok = strtok_r(line, " \r\n", &save);
+        if (!tok) continue;
+        if ((size_t)samples + 1 >= starts_cap) {
+            starts_cap = starts_cap ? starts_cap * 2 : 1024;
+            long *grown = realloc(starts, starts_cap * sizeof(long));
+            if (!grown) break;
+            starts = grown;
+        }
+        starts[samples] = (long)nframes;
+        int k = 0;
+        while ((tok = strtok_r(NULL, " \r\n", &save))) {
+            char key[256];
+            if (tok[0] == '0' && k > 0) {
+                snprintf(key, sizeof(key), "0x%llx", strtoull(tok, NULL, 16) - 1);
+            } else {
+                snprintf(key, sizeof(key), "%s", tok);
+            }
+            long s = tally_index(&sites, key);
+            if (s < 0) continue;
+            if (nframes == cap) {
+                cap = cap ? cap * 2 : 4096;
+                long *grown = realloc(frames, cap * sizeof(long));
+                if (!grown) break;
+                frames = grown;
+            }
+            frames[nframes++] = s;
+            k++;
+        }
+        samples++;
+        starts[samples] = (long)nframes;
+    }
+    fclose(in);
+    if (samples == 0) {
+        printf("No samples: the program ran for less than one sampling interval\n");
+        tally_free(&sites);
+        free(frames);
+        free(starts);
+        return 0;
+    }
+
+    Site *site = calloc(sites.count, sizeof(Site));
+    if (!site) {
+        tally_free(&sites);
+        free(frames);
+        free(starts);
+        return 1;
+    }
+    resolve_sites(&sites, site, bin);
+
+    Tally lines = {0}, funcs = {0}, stacks = {0};
+    for (long n = 0; n < samples; n++) {
+        long *fr = frames + starts[n];
+        long depth = starts[n + 1] - starts[n];
+        // Drop the C startup below the program's outermost frame
+        long keep = depth;
+        for (long k = depth - 1; k >= 0; k--) {
+            const Site *s = &site[fr[k]];
+            if (s->program && s->func && strcmp(s->func, "_start") != 0) break;
+            keep = k;
+        }
+        if (keep == 0) keep = depth;
+
+        bool self_line = true;
+        char stack[4096];
+        size_t sl = 0;
+        stack[0] = 0;
+        for (long k = 0; k < keep; k++) {
+            const Site *s = &site[fr[k]];
+            const char *func = s->func ? s->func : "?";
+            tally_count(&funcs, func, n, k == 0);
+            if (s->file) {
+                char key[FILENAME_MAX + 16];
+                snprintf(key, sizeof(key), "%s:%d", s->file, s->line);
+                tally_count(&lines, key, n, self_line);
+                self_line = false;
+            }
+        }
+        // Folded stacks list frames from the outermost in
+        for (long k = keep - 1; k >= 0; k--) {
+            const char *func = site[fr[k]].func ? site[fr[k]].func : "?";
+            int w = snprintf(stack + sl, sizeof(stack) - sl, "%s%s", sl ? ";" : "", func);
+            if (w < 0 || (size_t)w >= sizeof(stack) - sl) break;
+            sl += w;
+        }
+        tally_count(&stacks, stack, n, true);
+    }
+
+    printf("\n=== jawa profile: %ld samples over %.2fs CPU (%d Hz requested)", samples, cpu, hz);
+    if (lost) printf(", %ld dropped", lost);
+    printf(" ===\n\nHot lines\n");
+    if (lines.count) print_rows(&lines, samples, true);
+    else printf("   (no samples in .jw code)\n");
+    printf("\nHot functions\n");
+    print_rows(&funcs, samples, false);
+
+    FILE *folded = fopen(folded_path, "w");
+    if (folded) {
+        for (size_t i = 0; i < stacks.count; i++) fprintf(folded, "%s %ld\n", stacks.keys[i], stacks.self[i]);
+        fclose(folded);
+        printf("\nFolded stacks: %s (flamegraph.pl %s > profile.svg)\n", folded_path, folded_path);
+    } else {
+        perror(folded_path);
+    }
+
+    for (size_t i = 0; i < sites.count; i++) {
+        free(site[i].func);
+        free(site[i].file);
+    }
+    free(site);
+    tally_free(&sites);
+    tally_free(&lines);
+    tally_free(&funcs);
+    tally_free(&stacks);
+    free(frames);
+    free(starts);
+    return 0;
+}
+
+int profile_native(const char *srcPath, const char *folded_path, int hz, int argc, char **argv) {
+#ifdef _WIN32
+    (void)srcPath; (void)folded_path; (void)hz; (void)argc; (void)argv;
+    fprintf(stderr, "jawa profile needs SIGPROF and is not available on Windows\n");
+    return 1;
+#else
+    char bin[FILENAME_MAX], samples[FILENAME_MAX + 16];
+    snprintf(bin, sizeof(bin), "%s.profile.bin", srcPath);
+    snprintf(samples, sizeof(samples), "%s.samples", bin);
+
+    BuildOptions opts = {0};
+    opts.profile = true;
+    int rc = build_native_with(srcPath, bin, &opts);
+    if (rc != 0) return rc;
+
+    // Program arguments, each single-quoted for the shell
+    size_t clen = strlen(bin) + 16;
+    for (int i = 1; i < argc; i++) clen += 4 * strlen(argv[i]) + 3;
+    char *cmd = malloc(clen);
+    if (!cmd) {
+        remove(bin);
+        return 2;
+    }
+    size_t k = snprintf(cmd, clen, strchr(bin, '/') ? "'%s'" : "./'%s'", bin);
+    for (int i = 1; i < argc; i++) {
+        cmd[k++] = ' ';
+        cmd[k++] = '\'';
+        for (const char *c = argv[i]; *c; c++) {
+            if (*c == '\'') {
+                memcpy(cmd + k, "'\\''", 4);
+                k += 4;
+            } else {
+                cmd[k++] = *c;
+            }
+        }
+        cmd[k++] = '\'';
+    }
+    cmd[k] = 0;
+
+    char rate[16];
+    snprintf(rate, sizeof(rate), "%d", hz > 0 ? hz : 1000);
+    remove(samples);
+    setenv("JAWA_PROFIL", samples, 1);
+    setenv("JAWA_PROFIL_HZ", rate, 1);
+    rc = system(cmd);
+    unsetenv("JAWA_PROFIL");
+    unsetenv("JAWA_PROFIL_HZ");
+    free(cmd);
+    if (rc != -1 && WIFEXITED(rc)) rc = WEXITSTATUS(rc);
+
+    fflush(stdout);
+    int rrc = report(samples, bin, folded_path);
+    remove(samples);
+    remove(bin);
+    return rc != 0 ? rc : rrc;
+#endif
+}
@@ -1,9 +1,15 @@
 #include "statements.h"
+#include "optimizer.h"
 #include <string.h>
 #include <ctype.h>
 #include <stdlib.h>  // Add for strtoll
 
-static int g_if_depth = 0;
+#ifdef _WIN32
+#define strtok_r strtok_s
+#endif
+
+#define PRINT_PATTERN_MAX 2048
+#define PRINT_ARGS_MAX 16384
 
 bool is_variable_declaration(const char *line) {
     return (strncmp(line, "owahi ", 6) == 0 || 
@@ -15,6 +21,14 @@ bool is_print_statement(const char *line) {
     return (strncmp(line, "cithak", 6) == 0 && (isspace((unsigned char)line[6]) || line[6] == '('));
 }
 
+bool is_flush_statement(const char *line) {
+    if (strncmp(line, "flush", 5) != 0) return false;
+    const char *q = line + 5;
+    if (strncmp(q, "()", 2) == 0) q += 2;
+    while (*q && isspace((unsigned char)*q)) q++;
+    return *q == 0;
+}
+
 bool is_if_statement(const char *line) {
     return strncmp(line, "yen", 3) == 0 && isspace((unsigned char)line[3]);
 }
@@ -28,7 +42,23 @@ bool is_while_statement(const char *line) {
 }
 
 bool is_for_statement(const char *line) {
-    return strncmp(line, "ngulang", 7) == 0 && (isspace((unsigned char)line[7]) || line[7] == '(');
+    return (strncmp(line, "ngulang", 7) == 0 && (isspace((unsigned char)line[7]) || line[7] == '(')) ||
+           is_parallel_for_statement(line);
+}
+
+// "ngulang paralel (...)" or "kanggo paralel (...)"
+bool is_parallel_for_statement(const char *line) {
+    const char *q;
+    if (strncmp(line, "ngulang", 7) == 0 && isspace((unsigned char)line[7])) q = line + 7;
+    else if (strncmp(line, "kanggo", 6) == 0 && isspace((unsigned char)line[6])) q = line + 6;
+    else return false;
+    while (*q && isspace((unsigned char)*q)) q++;
+    return strncmp(q, "paralel", 7) == 0 && (isspace((unsigned char)q[7]) || q[7] == '(');
+}
+
+// "tunggu t" on its own line only waits for the task
+bool is_await_statement(const char *line) {
+    return strncmp(line, "tunggu", 6) == 0 && isspace((unsigned char)line[6]);
 }
 
 bool is_function_definition(const char *line) {
@@ -116,6 +146,15 @@ void parse_variable_declaration(const char *line, FILE *out, ParserContext *ctx)
         while (*q == ' ') q++; 
     }
     
+    // "kanal<T>" names the element type
+    Ty elem = TY_UNK;
+    if (strcmp(ctype, "kanal") == 0 && *q == '<') {
+        elem = parser_kanal_elem(q);
+        while (*q && *q != '>') q++;
+        if (*q == '>') q++;
+        while (*q == ' ') q++;
+    }
+    
     if (*q == '=') q++;
     while (*q == ' ') q++;
     
@@ -129,6 +168,8 @@ void parse_variable_declaration(const char *line, FILE *out, ParserContext *ctx)
         else if (strcmp(ctype, "bool") == 0) { mapped = "bool"; vty = TY_BOOL; }
         else if (strcmp(ctype, "string") == 0) { mapped = "const char*"; vty = TY_STRING; }
         else if (strcmp(ctype, "array") == 0) { mapped = "JawaArray*"; vty = TY_ARRAY; }
+        else if (strcmp(ctype, "kanal") == 0) { mapped = "JawaKanal*"; vty = TY_CHAN; }
+        else if (strcmp(ctype, "tugas") == 0) { mapped = "JawaTugas*"; vty = TY_TASK; }
     } else {
         // Type inference when no explicit type - parse expression first
         char ebuf[4096]; 
@@ -146,6 +187,13 @@ void parse_variable_declaration(const char *line, FILE *out, ParserContext *ctx)
         } else if (expr_type == TY_BOOL) { 
             mapped = "bool"; 
             vty = TY_BOOL; 
+        } else if (expr_type == TY_TASK) { 
+            mapped = "JawaTugas*"; 
+            vty = TY_TASK; 
+            elem = ctx->task_ty;
+        } else if (expr_type == TY_CHAN) { 
+            mapped = "JawaKanal*"; 
+            vty = TY_CHAN; 
         } else if (expr_type == TY_INT) { 
             // Check if the integer literal is too large for int type
             long long num_value = strtoll(q, NULL, 10);
@@ -194,15 +242,130 @@ void parse_variable_declaration(const char *line, FILE *out, ParserContext *ctx)
     ebuf[0] = 0;
     Lexer L = { .p = q };
     lex_next(&L);
-    (void)parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
+    Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
+    if (vty == TY_TASK && et == TY_TASK && elem == TY_UNK) elem = ctx->task_ty;
+    if (vty == TY_TASK || vty == TY_CHAN) parser_set_var_elem(ctx, name, elem);
     fputs(ebuf, out);
     fputs(";\n", out);
 }
 
+// A C string literal whose text can be copied into a cithak_format pattern
+static bool is_fusable_literal(const char *e, int n) {
+    if (n < 2 || e[0] != '"' || e[n - 1] != '"') return false;
+    for (int i = 1; i + 1 < n; i++) {
+        if (e[i] == '"') return false;  // several literals or an expression
+        if (e[i] == '\\') {
+            i++;
+            // Numeric escapes could spell '%'
+            if (e[i] == 'x' || (e[i] >= '0' && e[i] <= '7')) return false;
+        }
+    }
+    return true;
+}
+
+// If e[0 .. n) is exactly fn(...), point *arg at the argument text
+static bool unwrap_call(const char *e, int n, const char *fn, const char **arg, int *arglen) {
+    int fl = (int)strlen(fn);
+    if (n < fl + 2 || strncmp(e, fn, fl) != 0 || e[fl] != '(' || e[n - 1] != ')') return false;
+    // The parenthesis after fn must be the one that closes at the end
+    int depth = 0;
+    bool in_str = false;
+    for (int i = fl; i < n; i++) {
+        char c = e[i];
+        if (in_str) {
+            if (c == '\\') i++;
+            else if (c == '"') in_str = false;
+        } else if (c == '"') {
+            in_str = true;
+        } else if (c == '(') {
+            depth++;
+        } else if (c == ')' && --depth == 0 && i != n - 1) {
+            return false;
+        }
+    }
+    *arg = e + fl + 1;
+    *arglen = n - fl - 2;
+    return true;
+}
+
+// Offset of the first comma outside parentheses and literals, or -1
+static int top_level_comma(const char *e, int n) {
+    int depth = 0;
+    bool in_str = false;
+    for (int i = 0; i < n; i++) {
+        char c = e[i];
+        if (in_str) {
+            if (c == '\\') i++;
+            else if (c == '"') in_str = false;
+        } else if (c == '"') {
+            in_str = true;
+        } else if (c == '(') {
+            depth++;
+        } else if (c == ')') {
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Add one printed value to the statement's pattern and argument list.
+// Concatenations and number-to-string conversions are taken apart so the
+// pieces are formatted straight into the output buffer.
+static void print_piece(char *pola, int *pi, char *args, int *ai, const char *e, int n, Ty et) {
+    while (n > 0 && e[0] == ' ') { e++; n--; }
+    while (n > 0 && e[n - 1] == ' ') n--;
+    
+    const char *inner;
+    int inner_len;
+    if (et == TY_STRING && unwrap_call(e, n, "string_concat", &inner, &inner_len)) {
+        int comma = top_level_comma(inner, inner_len);
+        if (comma > 0) {
+            print_piece(pola, pi, args, ai, inner, comma, TY_STRING);
+            print_piece(pola, pi, args, ai, inner + comma + 1, inner_len - comma - 1, TY_STRING);
+            return;
+        }
+    }
+    if (et == TY_STRING && (unwrap_call(e, n, "int_to_string", &inner, &inner_len) ||
+                            unwrap_call(e, n, "long_to_string", &inner, &inner_len))) {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%i");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", (long long)(%.*s)", inner_len, inner);
+    } else if (et == TY_STRING && unwrap_call(e, n, "double_to_string", &inner, &inner_len)) {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%f");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", (double)(%.*s)", inner_len, inner);
+    } else if (et == TY_STRING && is_fusable_literal(e, n)) {
+        // Literal text goes straight into the pattern
+        for (int i = 1; i + 1 < n; i++) {
+            sb_add(pola, PRINT_PATTERN_MAX, pi, e[i] == '%' ? "%%%%" : "%c", e[i]);
+        }
+    } else if (et == TY_STRING) {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%s");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", %.*s", n, e);
+    } else if (et == TY_BOOL) {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%b");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", (int)(%.*s)", n, e);
+    } else if (et == TY_INT) {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%i");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", (long long)(%.*s)", n, e);
+    } else {
+        sb_add(pola, PRINT_PATTERN_MAX, pi, "%%f");
+        sb_add(args, PRINT_ARGS_MAX, ai, ", (double)(%.*s)", n, e);
+    }
+}
+
+// Each print statement becomes one cithak_format call: literal pieces are
+// fused into the pattern and values are formatted into the output buffer
 void parse_print_statement(const char *line, FILE *out, ParserContext *ctx) {
     const char *q = line + 6; 
     while (*q && isspace((unsigned char)*q)) q++;
     
+    char pola[PRINT_PATTERN_MAX];
+    char args[PRINT_ARGS_MAX];
+    int pi = 0, ai = 0;
+    pola[0] = 0;
+    args[0] = 0;
+    
     // Check if using parentheses syntax: cithak("text")
     bool has_parens = (*q == '(');
     if (has_parens) {
@@ -224,13 +387,9 @@ void parse_print_statement(const char *line, FILE *out, ParserContext *ctx) {
             lex_next(&L);
             Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
             
-            if (et == TY_STRING) {
-                fprintf(out, "printf(\"%%s\\n\", %s);\n", ebuf);
-            } else if (et == TY_BOOL) {
-                fprintf(out, "printf(\"%%s\\n\", (%s) ? \"true\" : \"false\");\n", ebuf);
-            } else {
-                fprintf(out, "printf(\"%%g\\n\", (double)(%s));\n", ebuf);
-            }
+            print_piece(pola, &pi, args, &ai, ebuf, (int)strlen(ebuf), et);
+            sb_add(pola, sizeof(pola), &pi, "\\n");
+            fprintf(out, "cithak_format(\"%s\"%s);\n", pola, args);
             return;
         }
     }
@@ -256,73 +415,77 @@ void parse_print_statement(const char *line, FILE *out, ParserContext *ctx) {
         while (arg_end > arg && isspace((unsigned char)*arg_end)) *arg_end-- = 0;
         
         if (strlen(arg) > 0) {
-            if (*arg == '"') {
-                char ebuf[4096]; 
-                int oi = 0; 
-                ebuf[0] = 0; 
-                Lexer L = {.p = arg}; 
-                lex_next(&L); 
-                Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx); 
-                (void)et;
-                fprintf(out, "printf(\"%%s \", %s);\n", ebuf);
-            } else {
-                char ebuf[4096]; 
-                int oi = 0; 
-                ebuf[0] = 0; 
-                Lexer L = {.p = arg}; 
-                lex_next(&L); 
-                Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
-                
-                if (et == TY_STRING) {
-                    fprintf(out, "printf(\"%%s \", %s);\n", ebuf);
-                } else if (et == TY_BOOL) {
-                    fprintf(out, "printf(\"%%s \", (%s) ? \"true\" : \"false\");\n", ebuf);
-                } else {
-                    fprintf(out, "printf(\"%%g \", (double)(%s));\n", ebuf);
-                }
-            }
+            char ebuf[4096]; 
+            int oi = 0; 
+            ebuf[0] = 0; 
+            Lexer L = {.p = arg}; 
+            lex_next(&L); 
+            Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
+            // Quoted arguments always print as text
+            if (*arg == '"') et = TY_STRING;
+            print_piece(pola, &pi, args, &ai, ebuf, (int)strlen(ebuf), et);
+            sb_add(pola, sizeof(pola), &pi, " ");
         }
         arg = next_arg;
     }
-    fprintf(out, "printf(\"\\n\");\n");
+    sb_add(pola, sizeof(pola), &pi, "\\n");
+    fprintf(out, "cithak_format(\"%s\"%s);\n", pola, args);
 }
 
-void parse_if_statement(const char *line, FILE *out, ParserContext *ctx) {
+// "flush": write buffered output now, e.g. before a long computation
+void parse_flush_statement(FILE *out) {
+    fputs("cithak_flush();\n", out);
+}
+
+// Extract and translate the condition of "yen (cond) {"
+static bool parse_if_condition(const char *line, char *ebuf, size_t ebufsz, Ty *et, ParserContext *ctx) {
     const char *q = line + 3; 
     while (*q && isspace((unsigned char)*q)) q++;
     
     // Find the opening brace
     const char *brace_pos = strchr(q, '{');
-    if (brace_pos) {
-        // Extract condition (everything before {)
-        int cond_len = (int)(brace_pos - q);
-        char cond_buf[512]; 
-        if (cond_len < (int)sizeof(cond_buf)) {
-            strncpy(cond_buf, q, cond_len);
-            cond_buf[cond_len] = 0;
-            
-            // Remove trailing spaces
-            char *end = cond_buf + cond_len - 1;
-            while (end > cond_buf && isspace((unsigned char)*end)) *end-- = 0;
-            
-            // Parse condition expression
-            char ebuf[4096]; 
-            int oi = 0; 
-            ebuf[0] = 0; 
-            Lexer L = {.p = cond_buf}; 
-            lex_next(&L); 
-            Ty et = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
-            
-            fprintf(out, "if (");
-            if (et == TY_BOOL) {
-                fprintf(out, "%s", ebuf);
-            } else {
-                fprintf(out, "(%s)", ebuf); // treat non-zero as true
-            }
-            fputs(") {\n", out);
-            g_if_depth++;
-        }
+    if (!brace_pos) return false;
+    
+    // Extract condition (everything before {)
+    int cond_len = (int)(brace_pos - q);
+    char cond_buf[512]; 
+    if (cond_len >= (int)sizeof(cond_buf)) return false;
+    
+    strncpy(cond_buf, q, cond_len);
+    cond_buf[cond_len] = 0;
+    
+    // Remove trailing spaces
+    char *end = cond_buf + cond_len - 1;
+    while (end > cond_buf && isspace((unsigned char)*end)) *end-- = 0;
+    
+    // Parse condition expression
+    int oi = 0; 
+    ebuf[0] = 0; 
+    Lexer L = {.p = cond_buf}; 
+    lex_next(&L); 
+    *et = parse_expr(&L, ebuf, ebufsz, &oi, ctx);
+    return true;
+}
+
+void parse_if_statement(const char *line, FILE *out, ParserContext *ctx) {
+    char ebuf[4096]; 
+    Ty et;
+    if (!parse_if_condition(line, ebuf, sizeof(ebuf), &et, ctx)) return;
+    
+    fprintf(out, "if (");
+    if (et == TY_BOOL) {
+        fprintf(out, "%s", ebuf);
+    } else {
+        fprintf(out, "(%s)", ebuf); // treat non-zero as true
     }
+    fputs(") {\n", out);
+}
+
+int eval_if_condition(const char *line, ParserContext *ctx) {
+    char ebuf[4096]; 
+    Ty et;
+    if (!parse_if_condition(line, ebuf, sizeof(ebuf), &et, ctx)) return -1;
+    return fold_condition(ebuf);
 }
 
 void parse_else_statement(const char *line, FILE *out) {
@@ -379,12 +542,20 @@ void parse_while_statement(const char *line, FILE *out, ParserContext *ctx) {
 }
 
 void parse_for_statement(const char *line, FILE *out, ParserContext *ctx) {
-    const char *q = line + 7; 
+    const char *q = line + (strncmp(line, "kanggo", 6) == 0 ? 6 : 7); 
     while (*q && isspace((unsigned char)*q)) q++;
     
-    // Find the opening brace
+    // A parallel loop translated here (nested, or in a loop body being
+    // scanned) runs sequentially; its clauses are dropped below
+    if (strncmp(q, "paralel", 7) == 0) {
+        q += 7;
+        while (*q && isspace((unsigned char)*q)) q++;
+    }
+    
+    // Find the opening brace; it may stand on the next line instead
     const char *brace_pos = strchr(q, '{');
-    if (!brace_pos) return;
+    bool brace = brace_pos != NULL;
+    if (!brace) brace_pos = q + strlen(q);
     
     // Extract for statement (everything before {)
     int for_len = (int)(brace_pos - q);
@@ -400,6 +571,14 @@ void parse_for_statement(const char *line, FILE *out, ParserContext *ctx) {
     if (*start == '(') {
         char *end = for_buf + for_len - 1;
         while (end > start && isspace((unsigned char)*end)) end--;
+        if (*end != ')') {
+            // Clauses after the header, e.g. "(...) jumlah(total)"
+            int level = 0;
+            for (end = start; *end; end++) {
+                if (*end == '(') level++;
+                else if (*end == ')' && --level == 0) break;
+            }
+        }
         if (*end == ')') {
             start++;
             *end = 0;
@@ -545,7 +724,7 @@ void parse_for_statement(const char *line, FILE *out, ParserContext *ctx) {
         }
     }
     
-    fputs(") {\n", out);
+    fputs(brace ? ") {\n" : ")\n", out);
 }
 
 void parse_assignment(const char *line, FILE *out, ParserContext *ctx) {
@@ -598,6 +777,11 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
     // Skip "gawe" and whitespace
     const char *p = line + 4;
     while (*p && isspace((unsigned char)*p)) p++;
+    bool is_async = strncmp(p, "async", 5) == 0 && isspace((unsigned char)p[5]);
+    if (is_async) {
+        p += 5;
+        while (*p && isspace((unsigned char)*p)) p++;
+    }
     
     // Parse function name
     char func_name[128] = {0};
@@ -607,6 +791,9 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
         func_name[ni++] = *p++;
     }
     func_name[ni] = 0;
+    snprintf(ctx->fn_name, sizeof(ctx->fn_name), "%s", func_name);
+    ctx->fn_param_count = 0;
+    ctx->fn_tail_loop = false;
     
     // Skip to parameters
     while (*p && isspace((unsigned char)*p)) p++;
@@ -660,11 +847,21 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
     
     // Process parameters for C type declaration
     char c_param_list[1024] = {0};
+    char task_fields[1024] = {0};   // async: argument struct members
+    char task_args[512] = {0};      // async: call from the argument struct
+    char task_copy[1024] = {0};     // async: fill the argument struct
+    int tfi = 0, tai = 0, tci = 0;
+    char memo_kinds[17] = {0};      // memo: key kind per parameter
+    char memo_keys[1024] = {0};     // memo: key array initializer
+    char memo_args[512] = {0};      // memo: call of the real body
+    int mki = 0, mkk = 0, mai = 0;
+    bool memo_ok = true;
     
     if (strlen(param_list) > 0) {
         // Split parameters by commas and add types
         char *param_list_copy = strdup(param_list);
-        char *token = strtok(param_list_copy, ",");
+        char *save = NULL;
+        char *token = strtok_r(param_list_copy, ",", &save);
         int first = 1;
         
         while (token) {
@@ -720,6 +917,22 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
                 else if (strcmp(param_type, "double") == 0) c_param_type = "double";
                 else if (strcmp(param_type, "bool") == 0) c_param_type = "bool";
                 else if (strcmp(param_type, "string") == 0) c_param_type = "const char*";
+                else if (strncmp(param_type, "kanal", 5) == 0) c_param_type = "JawaKanal*";
+                else if (strcmp(param_type, "tugas") == 0) c_param_type = "JawaTugas*";
+                
+                // Memo key: int/bool in .i, double in .d, string in .s
+                char kind = strcmp(c_param_type, "double") == 0 ? 'd'
+                          : strcmp(c_param_type, "const char*") == 0 ? 's'
+                          : strcmp(c_param_type, "int") == 0 || strcmp(c_param_type, "bool") == 0 ? 'i' : 0;
+                if (!kind || mki >= (int)sizeof(memo_kinds) - 1) memo_ok = false;
+                else memo_kinds[mki++] = kind;
+                sb_add(memo_keys, sizeof(memo_keys), &mkk, "%s{ .%c = %s }", first ? "" : ", ",
+                       kind == 'd' ? 'd' : kind == 's' ? 's' : 'i', param_name);
+                sb_add(memo_args, sizeof(memo_args), &mai, "%s%s", first ? "" : ", ", param_name);
+                
+                sb_add(task_fields, sizeof(task_fields), &tfi, "%s %s; ", c_param_type, param_name);
+                sb_add(task_args, sizeof(task_args), &tai, "%s_a->%s", first ? "" : ", ", param_name);
+                sb_add(task_copy, sizeof(task_copy), &tci, "_a->%s = %s;\n", param_name, param_name);
                 
                 strcat(c_param_list, c_param_type);
                 strcat(c_param_list, " ");
@@ -731,16 +944,80 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
                 if (strcmp(param_type, "int") == 0) param_ty = TY_INT;
                 else if (strcmp(param_type, "string") == 0) param_ty = TY_STRING;
                 else if (strcmp(param_type, "bool") == 0) param_ty = TY_BOOL;
+                else if (strncmp(param_type, "kanal", 5) == 0) param_ty = TY_CHAN;
+                else if (strcmp(param_type, "tugas") == 0) param_ty = TY_TASK;
                 
                 parser_add_var(ctx, param_name, param_ty);
+                if (ctx->fn_param_count >= 0 && ctx->fn_param_count < 16) {
+                    snprintf(ctx->fn_params[ctx->fn_param_count++], sizeof(ctx->fn_params[0]), "%s", param_name);
+                } else {
+                    ctx->fn_param_count = -1;
+                }
+                if (param_ty == TY_CHAN) parser_set_var_elem(ctx, param_name, parser_kanal_elem(param_type + 5));
             }
             
-            token = strtok(NULL, ",");
+            token = strtok_r(NULL, ",", &save);
         }
         
         free(param_list_copy);
     }
     
+    // An async function also gets name_async(), which copies the arguments
+    // into a struct and schedules the call on the task pool
+    if (is_async) {
+        Ty ret_ty = TY_DOUBLE;
+        if (strcmp(return_type, "int") == 0) ret_ty = TY_INT;
+        else if (strcmp(return_type, "bool") == 0) ret_ty = TY_BOOL;
+        else if (strcmp(return_type, "string") == 0) ret_ty = TY_STRING;
+        
+        fprintf(out, "struct %s_tugas { %s};\n", func_name, tfi ? task_fields : "char _kosong; ");
+        fprintf(out, "static void %s_jalan(void* arg, JawaNilai* hasil) {\n", func_name);
+        fprintf(out, "struct %s_tugas* _a = arg;\n", func_name);
+        if (!tai) fputs("(void)_a;\n", out);
+        fprintf(out, "hasil->%s = %s(%s);\n", parser_nilai_field(ret_ty), func_name, task_args);
+        fputs("}\n", out);
+        fprintf(out, "JawaTugas* %s_async(%s) {\n", func_name, c_param_list);
+        fprintf(out, "struct %s_tugas* _a = malloc(sizeof(*_a));\n", func_name);
+        fputs(task_copy, out);
+        fprintf(out, "return tugas_mulai(%s_jalan, _a);\n", func_name);
+        fputs("}\n", out);
+    }
+    
+    // A memoized function looks its arguments up first; on a miss the
+    // body, renamed name_asli, runs and its result is stored. Recursive
+    // calls in the body go through the lookup again.
+    MemoSpec memo = ctx->fn_memo;
+    memset(&ctx->fn_memo, 0, sizeof(ctx->fn_memo));
+    if (memo.on && (is_async || strcmp(return_type, "void") == 0 || !memo_ok)) {
+        fprintf(stderr, "Warning: @cache ignored on %s: needs a non-async function returning a value, "
+                "with int, double, bool or string parameters\n", func_name);
+        memo.on = false;
+    }
+    if (memo.on) {
+        Ty ret_ty = TY_DOUBLE;
+        if (strcmp(return_type, "int") == 0) ret_ty = TY_INT;
+        else if (strcmp(return_type, "bool") == 0) ret_ty = TY_BOOL;
+        else if (strcmp(return_type, "string") == 0) ret_ty = TY_STRING;
+        const char *field = parser_nilai_field(ret_ty);
+        
+        fprintf(out, "static %s %s_asli(%s);\n", c_return_type, func_name, c_param_list);
+        fprintf(out, "static JawaMemo* %s_memo;\n", func_name);
+        fprintf(out, "__attribute__((constructor)) static void %s_memo_anyar(void) {\n", func_name);
+        fprintf(out, "%s_memo = memo_anyar(\"%s\", %lld, %d);\n", func_name, memo_kinds, memo.size, memo.safe);
+        fputs("}\n", out);
+        fprintf(out, "%s %s(%s) {\n", c_return_type, func_name, c_param_list);
+        fprintf(out, "JawaNilai jawa_kunci[%d] = { %s };\n", mki ? mki : 1, mki ? memo_keys : "{ .i = 0 }");
+        fputs("JawaNilai jawa_asil;\n", out);
+        fprintf(out, "if (!memo_golek(%s_memo, jawa_kunci, &jawa_asil)) {\n", func_name);
+        fprintf(out, "jawa_asil.%s = %s_asli(%s);\n", field, func_name, memo_args);
+        fprintf(out, "memo_simpen(%s_memo, jawa_kunci, jawa_asil);\n", func_name);
+        fputs("}\n", out);
+        fprintf(out, "return jawa_asil.%s;\n", field);
+        fputs("}\n", out);
+        fprintf(out, "static %s %s_asli(%s) {\n", c_return_type, func_name, c_param_list);
+        return;
+    }
+    
     // Generate function definition
     fprintf(out, "%s %s(%s) {\n", c_return_type, func_name, c_param_list);
     
@@ -748,6 +1025,96 @@ void parse_function_definition(const char *line, FILE *out, ParserContext *ctx)
     // The function body will be processed separately
 }
 
+const char *memo_annotation(const char *line, MemoSpec *spec, bool warn) {
+    if (strncmp(line, "ajek", 4) == 0 && isspace((unsigned char)line[4])) {
+        const char *rest = line + 4;
+        while (*rest && isspace((unsigned char)*rest)) rest++;
+        if (!is_function_definition(rest)) return NULL;
+        spec->on = true;
+        spec->size = 0;
+        spec->safe = false;
+        return rest;
+    }
+    if (strncmp(line, "@cache", 6) != 0 || is_ident_char((unsigned char)line[6])) return NULL;
+    const char *p = line + 6;
+    while (*p && isspace((unsigned char)*p)) p++;
+    spec->on = true;
+    spec->size = 0;
+    spec->safe = false;
+    if (*p == '(') {
+        // Options: an entry count and/or "aman"
+        const char *end = strchr(p, ')');
+        if (!end) return NULL;
+        p++;
+        while (p < end) {
+            while (p < end && (isspace((unsigned char)*p) || *p == ',')) p++;
+            const char *opt = p;
+            while (p < end && *p != ',' && !isspace((unsigned char)*p)) p++;
+            if (p == opt) break;
+            if (isdigit((unsigned char)*opt)) {
+                spec->size = strtoll(opt, NULL, 10);
+            } else if (p - opt == 4 && strncmp(opt, "aman", 4) == 0) {
+                spec->safe = true;
+            } else if (warn) {
+                fprintf(stderr, "Warning: unknown @cache option '%.*s'\n", (int)(p - opt), opt);
+            }
+        }
+        p = end + 1;
+        while (*p && isspace((unsigned char)*p)) p++;
+    }
+    return p;
+}
+
+int self_tail_call(const char *line, const char *fn, char args[][256], int max) {
+    if (!is_return_statement(line) || !isspace((unsigned char)line[4])) return -1;
+    const char *p = line + 4;
+    while (*p && isspace((unsigned char)*p)) p++;
+    size_t n = strlen(fn);
+    if (n == 0 || strncmp(p, fn, n) != 0 || is_ident_char((unsigned char)p[n])) return -1;
+    p += n;
+    while (*p && isspace((unsigned char)*p)) p++;
+    if (*p++ != '(') return -1;
+    
+    // Split the arguments at commas outside brackets and string literals
+    int count = 0, depth = 0;
+    char quote = 0;
+    const char *arg = p;
+    for (;; p++) {
+        if (!*p) return -1;
+        if (quote) {
+            if (*p == '\\' && p[1]) p++;
+            else if (*p == quote) quote = 0;
+            continue;
+        }
+        if (*p == '"' || *p == '\'') quote = *p;
+        else if (*p == '(' || *p == '[') depth++;
+        else if ((*p == ')' || *p == ']') && depth > 0) depth--;
+        else if (*p == ',' || *p == ')') {
+            if (depth > 0) continue;
+            const char *a = arg, *e = p;
+            while (a < e && isspace((unsigned char)*a)) a++;
+            while (e > a && isspace((unsigned char)e[-1])) e--;
+            if (e == a && (*p == ',' || count > 0)) return -1;
+            if (e > a) {
+                if (e - a >= 256) return -1;
+                if (args && count < max) {
+                    memcpy(args[count], a, (size_t)(e - a));
+                    args[count][e - a] = 0;
+                }
+                count++;
+            }
+            arg = p + 1;
+            if (*p == ')') break;
+        }
+    }
+    
+    // Nothing may follow the call: "bali f(x) + 1" is not a tail call
+    for (p++; *p; p++) {
+        if (!isspace((unsigned char)*p) && *p != ';') return -1;
+    }
+    return count;
+}
+
 void parse_return_statement(const char *line, FILE *out, ParserContext *ctx) {
     // Skip "bali" and whitespace
     const char *p = line + 4;
@@ -758,6 +1125,25 @@ void parse_return_statement(const char *line, FILE *out, ParserContext *ctx) {
     int oi = 0;
     ebuf[0] = 0;
     
+    // Self tail call: evaluate the new arguments, rebind the parameters and
+    // jump back to the top of the body, so recursion runs in constant stack
+    char args[16][256];
+    int argc = ctx->fn_tail_loop ? self_tail_call(line, ctx->fn_name, args, 16) : -1;
+    if (argc >= 0 && argc == ctx->fn_param_count) {
+        fputs("{\n", out);
+        for (int i = 0; i < argc; i++) {
+            oi = 0;
+            ebuf[0] = 0;
+            Lexer A = {.p = args[i]};
+            lex_next(&A);
+            (void)parse_expr(&A, ebuf, sizeof(ebuf), &oi, ctx);
+            fprintf(out, "__typeof__(%s) jawa_arg%d = %s;\n", ctx->fn_params[i], i, ebuf);
+        }
+        for (int i = 0; i < argc; i++) fprintf(out, "%s = jawa_arg%d;\n", ctx->fn_params[i], i);
+        fputs("goto jawa_ulang;\n}\n", out);
+        return;
+    }
+    
     Lexer L = {.p = p};
     lex_next(&L);
     (void)parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
@@ -773,7 +1159,9 @@ void parse_standalone_function_call(const char *line, FILE *out, ParserContext *
     
     Lexer L = {.p = line};
     lex_next(&L);
-    (void)parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
+    Ty ty = parse_expr(&L, ebuf, sizeof(ebuf), &oi, ctx);
     
-    fprintf(out, "%s;\n", ebuf);
+    // A task nobody will wait for: drop the handle, the task still runs
+    if (ty == TY_TASK) fprintf(out, "tugas_lali(%s);\n", ebuf);
+    else fprintf(out, "%s;\n", ebuf);
 }
@@ -0,0 +1,126 @@
+#include "statistik.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#define KERANJANG 32   // 0, 1, 2-3, 4-7, ... , >= 2^30 bait
+
+#define STATISTIK_NAMA(id, nama) nama,
+const char* const statistik_jeneng[STAT_JENIS] = { STATISTIK_JENIS(STATISTIK_NAMA) };
+#undef STATISTIK_NAMA
+
+int statistik_aktif;
+
+typedef struct StatBlok {
+    unsigned long long panggil[STAT_JENIS];
+    unsigned long long bait[STAT_JENIS];
+    unsigned long long histogram[STAT_JENIS][KERANJANG];
+    struct StatBlok* sabanjure;
+} StatBlok;
+
+// Blok thread yang sudah berakhir tetap di daftar dan ikut dijumlah
+static StatBlok* kabeh_blok;
+static int cacah_thread;
+static _Thread_local StatBlok* blok_iki;
+#ifndef _WIN32
+static pthread_mutex_t daftar_kunci = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static StatBlok* blok(void) {
+    if (blok_iki) return blok_iki;
+    StatBlok* b = calloc(1, sizeof(StatBlok));
+    if (!b) return NULL;
+#ifndef _WIN32
+    pthread_mutex_lock(&daftar_kunci);
+#endif
+    b->sabanjure = kabeh_blok;
+    kabeh_blok = b;
+    cacah_thread++;
+#ifndef _WIN32
+    pthread_mutex_unlock(&daftar_kunci);
+#endif
+    return blok_iki = b;
+}
+
+static int keranjang(size_t bait) {
+    int k = 0;
+    while (bait && k < KERANJANG - 1) {
+        bait >>= 1;
+        k++;
+    }
+    return k;
+}
+
+void statistik_panggil(int jenis) {
+    StatBlok* b = blok();
+    if (b && jenis >= 0 && jenis < STAT_JENIS) b->panggil[jenis]++;
+}
+
+void statistik_bait(int jenis, size_t bait) {
+    StatBlok* b = blok();
+    if (!b || jenis < 0 || jenis >= STAT_JENIS) return;
+    b->bait[jenis] += bait;
+    b->histogram[jenis][keranjang(bait)]++;
+}
+
+static void tulis_json(void) {
+    StatBlok jumlah;
+    memset(&jumlah, 0, sizeof(jumlah));
+#ifndef _WIN32
+    pthread_mutex_lock(&daftar_kunci);
+#endif
+    for (StatBlok* b = kabeh_blok; b; b = b->sabanjure) {
+        for (int j = 0; j < STAT_JENIS; j++) {
+            jumlah.panggil[j] += b->panggil[j];
+            jumlah.bait[j] += b->bait[j];
+            for (int k = 0; k < KERANJANG; k++) jumlah.histogram[j][k] += b->histogram[j][k];
+        }
+    }
+    int thread = cacah_thread;
+#ifndef _WIN32
+    pthread_mutex_unlock(&daftar_kunci);
+#endif
+
+    const char* path = getenv("JAWA_STATS");
+    FILE* f = path && *path ? fopen(path, "w") : stderr;
+    if (!f) {
+        perror(path);
+        return;
+    }
+    unsigned long long total_panggil = 0, total_bait = 0;
+    for (int j = 0; j < STAT_JENIS; j++) {
+        total_panggil += jumlah.panggil[j];
+        total_bait += jumlah.bait[j];
+    }
+    fprintf(f, "{\n  \"threads\": %d,\n  \"calls\": %llu,\n  \"bytes\": %llu,\n  \"ops\": {",
+            thread, total_panggil, total_bait);
+    bool kapisan = true;
+    for (int j = 0; j < STAT_JENIS; j++) {
+        if (jumlah.panggil[j] == 0 && jumlah.bait[j] == 0) continue;
+        fprintf(f, "%s\n    \"%s\": { \"calls\": %llu, \"bytes\": %llu, \"histogram\": {",
+                kapisan ? "" : ",", statistik_jeneng[j], jumlah.panggil[j], jumlah.bait[j]);
+        kapisan = false;
+        // Kunci keranjang = batas bawah ukuran dalam bait
+        bool awal = true;
+        for (int k = 0; k < KERANJANG; k++) {
+            if (!jumlah.histogram[j][k]) continue;
+            unsigned long long batas = k ? 1ULL << (k - 1) : 0;
+            fprintf(f, "%s\"%llu\": %llu", awal ? " " : ", ", batas, jumlah.histogram[j][k]);
+            awal = false;
+        }
+        fputs(awal ? "} }" : " } }", f);
+    }
+    fputs(kapisan ? "}\n}\n" : "\n  }\n}\n", f);
+    if (f != stderr) fclose(f);
+}
+
+void statistik_mulai(void) {
+    if (statistik_aktif) return;
+    statistik_aktif = 1;
+    atexit(tulis_json);
+}
@@ -0,0 +1,117 @@
+#include "string_case.h"
+#include "string_utf8.h"
+#include <stdbool.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Huruf Turki tanpa pasangan sepanjang sama (dipetakan di ganti_satu):
+// U+0130 İ kecilnya "i" + U+0307, U+0131 ı besarnya "I"
+#define HURUF_I_TITIK 0x130
+#define HURUF_I_TANPA_TITIK 0x131
+
+// Huruf kecil -> besar untuk code point 2 byte (U+0080..U+07FF).
+// Hanya pasangan yang panjang UTF-8-nya sama; selain itu tidak berubah.
+static unsigned int latin_gedhe(unsigned int cp) {
+    if (cp >= 0xE0 && cp <= 0xFE && cp != 0xF7) return cp - 0x20;
+    if (cp == 0xFF) return 0x178;
+    if (cp >= 0x100 && cp <= 0x137 && (cp & 1) && cp != HURUF_I_TANPA_TITIK) return cp - 1;
+    if (cp >= 0x139 && cp <= 0x148 && !(cp & 1)) return cp - 1;
+    if (cp >= 0x14A && cp <= 0x177 && (cp & 1)) return cp - 1;
+    if (cp >= 0x179 && cp <= 0x17E && !(cp & 1)) return cp - 1;
+    return cp;
+}
+
+static unsigned int latin_cilik(unsigned int cp) {
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 0x20;
+    if (cp == 0x178) return 0xFF;
+    if (cp >= 0x100 && cp <= 0x137 && !(cp & 1) && cp != HURUF_I_TITIK) return cp + 1;
+    if (cp >= 0x139 && cp <= 0x148 && (cp & 1)) return cp + 1;
+    if (cp >= 0x14A && cp <= 0x177 && !(cp & 1)) return cp + 1;
+    if (cp >= 0x179 && cp <= 0x17E && (cp & 1)) return cp + 1;
+    return cp;
+}
+
+// Satu karakter mulai di src[i], ditulis ke dst[*o]; mengembalikan
+// jumlah byte src yang diproses. Hasil tidak pernah lebih panjang dari
+// input kecuali İ yang dikecilkan (2 -> 3 byte).
+static size_t ganti_satu(char* dst, size_t* o, const char* src, size_t i, size_t len, bool gedhe) {
+    unsigned char c = (unsigned char)src[i];
+    if (c < 0x80) {
+        if (gedhe && c >= 'a' && c <= 'z') c -= 0x20;
+        else if (!gedhe && c >= 'A' && c <= 'Z') c += 0x20;
+        dst[(*o)++] = (char)c;
+        return 1;
+    }
+    
+    // Urutan 2 byte yang valid: decode, petakan, encode lagi
+    if (c >= 0xC2 && c <= 0xDF && i + 1 < len && ((unsigned char)src[i + 1] & 0xC0) == 0x80) {
+        unsigned int cp = ((c & 0x1Fu) << 6) | ((unsigned char)src[i + 1] & 0x3Fu);
+        if (gedhe && cp == HURUF_I_TANPA_TITIK) {
+            dst[(*o)++] = 'I';
+            return 2;
+        }
+        if (!gedhe && cp == HURUF_I_TITIK) {
+            dst[(*o)++] = 'i';
+            dst[(*o)++] = (char)0xCC;   // U+0307 titik di atas
+            dst[(*o)++] = (char)0x87;
+            return 2;
+        }
+        cp = gedhe ? latin_gedhe(cp) : latin_cilik(cp);
+        dst[(*o)++] = (char)(0xC0 | (cp >> 6));
+        dst[(*o)++] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    
+    // Urutan lain (atau byte tidak valid) disalin utuh
+    dst[(*o)++] = src[i];
+    return 1;
+}
+
+static size_t ganti_huruf(char* dst, const char* src, size_t len, bool gedhe) {
+    size_t i = 0, o = 0;
+#if defined(__SSE2__)
+    // 'a'..'z' (atau 'A'..'Z') digeser ke -128..-103 supaya cukup satu
+    // perbandingan bertanda; bit 0x20 dibalik hanya untuk byte itu
+    const __m128i geser = _mm_set1_epi8((char)(0x80 - (gedhe ? 'a' : 'A')));
+    const __m128i batas = _mm_set1_epi8((char)(-128 + 26));
+    const __m128i bit = _mm_set1_epi8(0x20);
+    while (i + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        if (_mm_movemask_epi8(v)) {
+            // Ada byte non-ASCII: proses karakter demi karakter sampai
+            // melewati blok ini, tanpa memotong urutan UTF-8
+            size_t akhir = i + 16;
+            while (i < akhir) i += ganti_satu(dst, &o, src, i, len, gedhe);
+            continue;
+        }
+        // o <= i bila dst == src, jadi blok ini sudah dimuat sebelum ditimpa
+        __m128i huruf = _mm_cmplt_epi8(_mm_add_epi8(v, geser), batas);
+        _mm_storeu_si128((__m128i*)(dst + o), _mm_xor_si128(v, _mm_and_si128(huruf, bit)));
+        i += 16;
+        o += 16;
+    }
+#endif
+    while (i < len) i += ganti_satu(dst, &o, src, i, len, gedhe);
+    // Indeks UTF-8 untuk isi lama tidak berlaku lagi
+    if (dst == src) string_utf8_lali();
+    return o;
+}
+
+size_t string_huruf_gedhe(char* dst, const char* src, size_t len) {
+    return ganti_huruf(dst, src, len, true);
+}
+
+size_t string_huruf_cilik(char* dst, const char* src, size_t len) {
+    return ganti_huruf(dst, src, len, false);
+}
+
+size_t string_huruf_cilik_dawane(const char* src, size_t len) {
+    // Setiap İ (C4 B0) menjadi 3 byte
+    size_t n = len;
+    for (size_t i = 0; i + 1 < len; i++) {
+        if ((unsigned char)src[i] == 0xC4 && (unsigned char)src[i + 1] == 0xB0) n++;
+    }
+    return n;
+}
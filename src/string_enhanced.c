@@ -1,44 +1,34 @@
 #include "string_enhanced.h"
+#include "string_search.h"
+#include "string_utf8.h"
+#include "string_number.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdio.h>
+#include <stdint.h>
 
 // Helpers for converting int to string
 char* int_to_string(int value) {
-    char buffer[32];
-    snprintf(buffer, sizeof(buffer), "%d", value);
-    return strdup(buffer);
+    char buffer[STRING_INT_MAX];
+    size_t len = string_tulis_int(buffer, value);
+    char* result = malloc(len + 1);
+    if (result) memcpy(result, buffer, len + 1);
+    return result;
 }
 
 // Fungsi untuk menghapus spasi dari kedua sisi string
 char* string_trim_ex(const char* str) {
     if (!str) return NULL;
     
-    int len = strlen(str);
-    if (len == 0) return strdup("");
-    
-    // Temukan awal (tanpa spasi)
-    int start = 0;
-    while (start < len && isspace((unsigned char)str[start])) {
-        start++;
-    }
-    
-    // Semua spasi
-    if (start == len) return strdup("");
+    // Potong tanpa menyalin, lalu salin sekali
+    size_t result_len;
+    const char* start = string_trim_view(str, &result_len);
     
-    // Temukan akhir (tanpa spasi)
-    int end = len - 1;
-    while (end > start && isspace((unsigned char)str[end])) {
-        end--;
-    }
-    
-    // Buat string baru
-    int result_len = end - start + 1;
     char* result = malloc(result_len + 1);
     if (!result) return NULL;
     
-    strncpy(result, str + start, result_len);
+    memcpy(result, start, result_len);
     result[result_len] = '\0';
     
     return result;
@@ -48,19 +38,29 @@ char* string_trim_ex(const char* str) {
 char** string_ke_karakter(const char* str, int* count) {
     if (!str || !count) return NULL;
     
-    int len = strlen(str);
-    *count = len;
+    size_t len = strlen(str);
+    size_t chars = string_utf8_chars(str, len);
+    *count = (int)chars;
     
-    if (len == 0) return NULL;
+    if (chars == 0) return NULL;
     
-    char** result = malloc(len * sizeof(char*));
+    // Satu blok: array pointer, lalu tiap karakter + NUL berurutan
+    char** result = malloc(chars * sizeof(char*) + len + chars);
     if (!result) return NULL;
     
-    for (int i = 0; i < len; i++) {
-        result[i] = malloc(2);
-        result[i][0] = str[i];
-        result[i][1] = '\0';
+    char* cursor = (char*)(result + chars);
+    Utf8Iter it;
+    const char* bytes;
+    size_t nbytes;
+    size_t i = 0;
+    string_utf8_iter(&it, str, len);
+    while (i < chars && string_utf8_next(&it, NULL, &bytes, &nbytes)) {
+        result[i++] = cursor;
+        memcpy(cursor, bytes, nbytes);
+        cursor += nbytes;
+        *cursor++ = '\0';
     }
+    *count = (int)i;
     
     return result;
 }
@@ -68,7 +68,7 @@ char** string_ke_karakter(const char* str, int* count) {
 // Mengecek apakah string berisi substring
 int string_ngandhut(const char* str, const char* substr) {
     if (!str || !substr) return 0;
-    return strstr(str, substr) != NULL;
+    return string_golek(str, strlen(str), substr, strlen(substr)) != NULL;
 }
 
 // Menghitung kemunculan substring dalam string
@@ -77,11 +77,12 @@ int string_ngitung(const char* str, const char* substr) {
     
     int count = 0;
     const char* pos = str;
-    int substr_len = strlen(substr);
+    size_t substr_len = strlen(substr);
     
     if (substr_len == 0) return 0;
     
-    while ((pos = strstr(pos, substr)) != NULL) {
+    const char* end = str + strlen(str);
+    while ((pos = string_golek(pos, end - pos, substr, substr_len)) != NULL) {
         count++;
         pos += substr_len;
     }
@@ -112,62 +113,264 @@ int string_mungkasi(const char* str, const char* suffix) {
     return strcmp(str + (str_len - suffix_len), suffix) == 0;
 }
 
-// Menggabungkan array string dengan delimiter
-char* string_gabung_array(char** arr, int count, const char* delimiter) {
-    if (!arr || count <= 0 || !delimiter) return NULL;
+// Elemen ke-i dari sumber array (char** atau JawaArray)
+typedef const char* (*ambil_elemen_fn)(const void* src, int i);
+
+static const char* elemen_char_array(const void* src, int i) {
+    return ((char* const*)src)[i];
+}
+
+static const char* elemen_jawa_array(const void* src, int i) {
+    const JawaArray* arr = src;
+    char* const* slot = arr->data[i];
+    return slot ? *slot : NULL;
+}
+
+// Gabungan satu lintasan: panjang dihitung sekali, lalu disalin dengan
+// memcpy lewat kursor. NULL kalau ukuran hasil melebihi size_t.
+static char* gabung_elemen(const void* src, int count, ambil_elemen_fn ambil, const char* delimiter) {
+    size_t delim_len = strlen(delimiter);
+    size_t lens_stack[64];
+    size_t* lens = count <= 64 ? lens_stack : malloc(count * sizeof(size_t));
+    if (!lens) return NULL;
     
     // Hitung total panjang
-    int total_len = 0;
-    int delim_len = strlen(delimiter);
-    
+    size_t total_len = 0;
     for (int i = 0; i < count; i++) {
-        if (arr[i]) {
-            total_len += strlen(arr[i]);
-        }
-        
-        // Tambahkan delimiter kecuali untuk elemen terakhir
-        if (i < count - 1) {
-            total_len += delim_len;
+        const char* s = ambil(src, i);
+        lens[i] = s ? strlen(s) : 0;
+        size_t step = lens[i] + (i < count - 1 ? delim_len : 0);
+        if (step < lens[i] || total_len > SIZE_MAX - 1 - step) {
+            if (lens != lens_stack) free(lens);
+            return NULL;
         }
+        total_len += step;
     }
     
     // Alokasi hasil
     char* result = malloc(total_len + 1);
-    if (!result) return NULL;
-    
-    result[0] = '\0';
-    
-    // Gabungkan string
-    for (int i = 0; i < count; i++) {
-        if (arr[i]) {
-            strcat(result, arr[i]);
-        }
-        
-        // Tambahkan delimiter kecuali untuk elemen terakhir
-        if (i < count - 1) {
-            strcat(result, delimiter);
+    if (result) {
+        char* cursor = result;
+        for (int i = 0; i < count; i++) {
+            if (lens[i]) {
+                memcpy(cursor, ambil(src, i), lens[i]);
+                cursor += lens[i];
+            }
+            // Tambahkan delimiter kecuali untuk elemen terakhir
+            if (i < count - 1 && delim_len) {
+                memcpy(cursor, delimiter, delim_len);
+                cursor += delim_len;
+            }
         }
+        *cursor = '\0';
     }
     
+    if (lens != lens_stack) free(lens);
     return result;
 }
 
+// Menggabungkan array string dengan delimiter
+char* string_gabung_array(char** arr, int count, const char* delimiter) {
+    if (!arr || count <= 0 || !delimiter) return NULL;
+    return gabung_elemen(arr, count, elemen_char_array, delimiter);
+}
+
+// Menggabungkan JawaArray berisi char* dengan delimiter
+char* string_gabung_daftar(const JawaArray* arr, const char* delimiter) {
+    if (!arr || !delimiter || arr->element_size != sizeof(char*)) return NULL;
+    if (arr->size <= 0) return strdup("");
+    return gabung_elemen(arr, arr->size, elemen_jawa_array, delimiter);
+}
+
 // Mengulang string sebanyak n kali
 char* string_ulang(const char* str, int count) {
     if (!str || count <= 0) return NULL;
     
-    int str_len = strlen(str);
-    int total_len = str_len * count;
+    size_t str_len = strlen(str);
+    if (str_len && (size_t)count > (SIZE_MAX - 1) / str_len) return NULL;
+    size_t total_len = str_len * (size_t)count;
     
     char* result = malloc(total_len + 1);
     if (!result) return NULL;
     
-    result[0] = '\0';
+    // Salin sekali, lalu gandakan bagian yang sudah jadi: O(n) dengan
+    // hanya log2(count) panggilan memcpy
+    size_t filled = 0;
+    if (str_len) {
+        memcpy(result, str, str_len);
+        filled = str_len;
+        while (filled < total_len) {
+            size_t chunk = filled <= total_len - filled ? filled : total_len - filled;
+            memcpy(result + filled, result, chunk);
+            filled += chunk;
+        }
+    }
+    result[filled] = '\0';
+    
+    return result;
+}
+
+// Automaton Aho-Corasick untuk string_ganti_banyak
+typedef struct {
+    int next[256];   // transisi lengkap (goto + fail sudah digabung)
+    int fail;
+    int pola;        // indeks pola yang berakhir di simpul ini, atau -1
+    int kamus;       // simpul suffix terdekat yang punya pola, atau -1
+    int dalam;       // panjang awalan yang diwakili simpul
+} SimpulAC;
+
+static SimpulAC* bangun_ac(const char* const* finds, int count, int* jumlah_simpul) {
+    size_t total = 1;
+    for (int i = 0; i < count; i++) if (finds[i]) total += strlen(finds[i]);
+    SimpulAC* ac = malloc(total * sizeof(SimpulAC));
+    if (!ac) return NULL;
+    
+    int n = 1;
+    memset(ac[0].next, -1, sizeof(ac[0].next));
+    ac[0].fail = 0; ac[0].pola = -1; ac[0].kamus = -1; ac[0].dalam = 0;
     
+    // Trie
     for (int i = 0; i < count; i++) {
-        strcat(result, str);
+        if (!finds[i] || !finds[i][0]) continue;
+        int s = 0;
+        for (const unsigned char* c = (const unsigned char*)finds[i]; *c; c++) {
+            if (ac[s].next[*c] < 0) {
+                memset(ac[n].next, -1, sizeof(ac[n].next));
+                ac[n].fail = 0; ac[n].pola = -1; ac[n].kamus = -1;
+                ac[n].dalam = ac[s].dalam + 1;
+                ac[s].next[*c] = n++;
+            }
+            s = ac[s].next[*c];
+        }
+        if (ac[s].pola < 0) ac[s].pola = i;  // pola ganda: yang pertama menang
+    }
+    
+    // BFS: link gagal, link kamus, dan transisi lengkap
+    int* antrian = malloc(n * sizeof(int));
+    if (!antrian) { free(ac); return NULL; }
+    int kepala = 0, ekor = 0;
+    for (int c = 0; c < 256; c++) {
+        int t = ac[0].next[c];
+        if (t < 0) ac[0].next[c] = 0;
+        else antrian[ekor++] = t;
+    }
+    while (kepala < ekor) {
+        int s = antrian[kepala++];
+        int f = ac[s].fail;
+        ac[s].kamus = ac[f].pola >= 0 ? f : ac[f].kamus;
+        for (int c = 0; c < 256; c++) {
+            int t = ac[s].next[c];
+            if (t < 0) {
+                ac[s].next[c] = ac[f].next[c];
+            } else {
+                ac[t].fail = s ? ac[f].next[c] : 0;
+                antrian[ekor++] = t;
+            }
+        }
+    }
+    free(antrian);
+    
+    *jumlah_simpul = n;
+    return ac;
+}
+
+typedef struct {
+    size_t awal;
+    size_t panjang;
+    int pola;
+} Kecocokan;
+
+// Mengganti banyak pola sekaligus dalam satu kali pindai.
+// Kecocokan tidak tumpang tindih; bila bersaing, yang mulai paling kiri
+// menang, lalu yang paling panjang.
+char* string_ganti_banyak(const char* str, const char* const* finds, const char* const* replaces, int count) {
+    if (!str || !finds || !replaces || count <= 0) return NULL;
+    
+    int jumlah_simpul = 0;
+    SimpulAC* ac = bangun_ac(finds, count, &jumlah_simpul);
+    if (!ac) return NULL;
+    
+    size_t str_len = strlen(str);
+    size_t kap = 64, n = 0;
+    Kecocokan* cocok = malloc(kap * sizeof(Kecocokan));
+    if (!cocok) { free(ac); return NULL; }
+    
+    // Kecocokan terpanjang per posisi awal ditahan di jendela melingkar
+    // sampai tidak ada kecocokan lain yang bisa mulai lebih kiri
+    size_t lebar = 1;
+    for (int k = 0; k < jumlah_simpul; k++) if ((size_t)ac[k].dalam + 1 > lebar) lebar = ac[k].dalam + 1;
+    Kecocokan* jendela = malloc(lebar * sizeof(Kecocokan));
+    if (!jendela) { free(cocok); free(ac); return NULL; }
+    for (size_t k = 0; k < lebar; k++) jendela[k].pola = -1;
+    
+    size_t periksa = 0;  // posisi awal berikutnya yang belum diputuskan
+    int s = 0;
+    for (size_t i = 0; i <= str_len; i++) {
+        size_t awal_min = i + 1;  // kecocokan nanti tidak bisa mulai sebelum ini
+        if (i < str_len) {
+            s = ac[s].next[(unsigned char)str[i]];
+            awal_min = i + 1 - ac[s].dalam;
+            
+            // Semua pola yang berakhir di sini, masing-masing awal berbeda
+            for (int t = ac[s].pola >= 0 ? s : ac[s].kamus; t >= 0; t = ac[t].kamus) {
+                size_t awal = i + 1 - ac[t].dalam;
+                if (awal < periksa) continue;
+                Kecocokan* slot = &jendela[awal % lebar];
+                if (slot->pola < 0 || slot->awal != awal || slot->panjang < (size_t)ac[t].dalam) {
+                    slot->awal = awal;
+                    slot->panjang = ac[t].dalam;
+                    slot->pola = ac[t].pola;
+                }
+            }
+        }
+        
+        // Putuskan posisi awal yang sudah pasti, dari kiri
+        while (periksa < awal_min && periksa < str_len) {
+            Kecocokan* slot = &jendela[periksa % lebar];
+            if (slot->pola < 0 || slot->awal != periksa) {
+                periksa++;
+                continue;
+            }
+            if (n == kap) {
+                Kecocokan* baru = realloc(cocok, kap * 2 * sizeof(Kecocokan));
+                if (!baru) { free(jendela); free(cocok); free(ac); return NULL; }
+                cocok = baru;
+                kap *= 2;
+            }
+            cocok[n++] = *slot;
+            slot->pola = -1;
+            periksa += cocok[n - 1].panjang;
+        }
+    }
+    free(jendela);
+    free(ac);
+    
+    // Hitung panjang hasil, alokasi sekali, salin dengan memcpy
+    size_t total = str_len;
+    for (size_t k = 0; k < n; k++) {
+        size_t r = replaces[cocok[k].pola] ? strlen(replaces[cocok[k].pola]) : 0;
+        total -= cocok[k].panjang;
+        if (total > SIZE_MAX - 1 - r) { free(cocok); return NULL; }
+        total += r;
+    }
+    
+    char* result = malloc(total + 1);
+    if (result) {
+        char* dst = result;
+        size_t dari = 0;
+        for (size_t k = 0; k < n; k++) {
+            const char* ganti = replaces[cocok[k].pola] ? replaces[cocok[k].pola] : "";
+            size_t r = strlen(ganti);
+            memcpy(dst, str + dari, cocok[k].awal - dari);
+            dst += cocok[k].awal - dari;
+            memcpy(dst, ganti, r);
+            dst += r;
+            dari = cocok[k].awal + cocok[k].panjang;
+        }
+        memcpy(dst, str + dari, str_len - dari + 1);
     }
     
+    free(cocok);
     return result;
 }
 
@@ -0,0 +1,251 @@
+#include "string_number.h"
+#include "statistik.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char digit_pairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Semua pangkat 10 yang bisa dinyatakan persis sebagai double
+static const double pow10_persis[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define DOUBLE_BULAT_MAX 9007199254740992.0   // 2^53
+
+// Digit u ditulis mundur, dua digit per langkah; mengembalikan awal digit
+static char* tulis_digit(char* end, unsigned long long u) {
+    char* p = end;
+    while (u >= 100) {
+        unsigned int r = (unsigned int)(u % 100);
+        u /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + r * 2, 2);
+    }
+    if (u >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + u * 2, 2);
+    } else {
+        *--p = (char)('0' + u);
+    }
+    return p;
+}
+
+size_t string_tulis_int(char* buf, long long value) {
+    char tmp[STRING_INT_MAX];
+    char* end = tmp + sizeof(tmp);
+    unsigned long long u = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    char* p = tulis_digit(end, u);
+    if (value < 0) *--p = '-';
+    size_t n = (size_t)(end - p);
+    memcpy(buf, p, n);
+    buf[n] = 0;
+    return n;
+}
+
+size_t string_tulis_double(char* buf, double value) {
+    char* p = buf;
+    if (isnan(value)) {
+        strcpy(buf, signbit(value) ? "-nan" : "nan");
+        return strlen(buf);
+    }
+    if (signbit(value)) {
+        *p++ = '-';
+        value = -value;
+    }
+    if (isinf(value)) {
+        strcpy(p, "inf");
+        return (size_t)(p - buf) + 3;
+    }
+
+    // Bilangan bulat: tanpa desimal, seperti "%.0f"
+    if (value < DOUBLE_BULAT_MAX && value == (double)(long long)value) {
+        return (size_t)(p - buf) + string_tulis_int(p, (long long)value);
+    }
+    if (value < 1e21 && value == floor(value)) {
+        return (size_t)(p - buf) + (size_t)snprintf(p, STRING_DOUBLE_MAX - 1, "%.0f", value);
+    }
+
+    // Cari k terkecil sehingga m / 10^k == value untuk m bulat < 2^53.
+    // Pembagian dua double yang persis dibulatkan dengan benar, jadi
+    // hasilnya sama dengan yang dibaca strtod dari "m" bertitik desimal.
+    for (int k = 1; k < (int)(sizeof(pow10_persis) / sizeof(pow10_persis[0])); k++) {
+        double scaled = value * pow10_persis[k];
+        if (scaled >= DOUBLE_BULAT_MAX) break;
+        double m = nearbyint(scaled);
+        if (m / pow10_persis[k] != value) continue;
+
+        char tmp[STRING_INT_MAX];
+        char* end = tmp + sizeof(tmp);
+        char* d = tulis_digit(end, (unsigned long long)m);
+        int ndigit = (int)(end - d);
+        if (ndigit > k) {
+            memcpy(p, d, ndigit - k);
+            p += ndigit - k;
+            *p++ = '.';
+            memcpy(p, end - k, k);
+            p += k;
+        } else {
+            *p++ = '0';
+            *p++ = '.';
+            memset(p, '0', k - ndigit);
+            p += k - ndigit;
+            memcpy(p, d, ndigit);
+            p += ndigit;
+        }
+        *p = 0;
+        return (size_t)(p - buf);
+    }
+
+    // Sangat kecil atau butuh 16-17 digit: presisi terkecil yang dibaca balik
+    // sama. Bilangan normal selalu terbaca balik dari 15 digit (%g membuang
+    // nol di belakang), subnormal presisinya lebih rendah: cari dari 1 digit.
+    for (int prec = value < DBL_MIN ? 1 : 15; prec <= 17; prec++) {
+        snprintf(p, STRING_DOUBLE_MAX - 1, "%.*g", prec, value);
+        if (strtod(p, NULL) == value) break;
+    }
+    return (size_t)(p - buf) + strlen(p);
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Buang spasi di kedua ujung [*s, *end)
+static void trim(const char** s, const char** end) {
+    while (*s < *end && is_space(**s)) (*s)++;
+    while (*end > *s && is_space((*end)[-1])) (*end)--;
+}
+
+bool string_maca_int(const char* s, size_t len, long long* out) {
+    if (!s) return false;
+    const char* end = s + len;
+    trim(&s, &end);
+    bool neg = false;
+    if (s < end && (*s == '-' || *s == '+')) neg = *s++ == '-';
+    if (s == end) return false;
+
+    unsigned long long limit = neg ? 9223372036854775808ULL : 9223372036854775807ULL;
+    unsigned long long u = 0;
+    for (; s < end; s++) {
+        unsigned int d = (unsigned int)(*s - '0');
+        if (d > 9) return false;
+        if (u > (limit - d) / 10) return false;
+        u = u * 10 + d;
+    }
+    *out = neg ? (long long)(0ULL - u) : (long long)u;
+    return true;
+}
+
+bool string_maca_double(const char* s, size_t len, double* out) {
+    if (!s) return false;
+    const char* end = s + len;
+    trim(&s, &end);
+    const char* start = s;
+    const char* p = s;
+    bool neg = false;
+    if (p < end && (*p == '-' || *p == '+')) neg = *p++ == '-';
+
+    // Mantisa sampai 19 digit signifikan, eksponen desimal terpisah
+    unsigned long long mant = 0;
+    int ndigit = 0;
+    int exp10 = 0;
+    bool any = false;
+    bool lossy = false;
+    for (; p < end && (unsigned int)(*p - '0') <= 9; p++) {
+        any = true;
+        if (ndigit < 19) {
+            if (mant || *p != '0') ndigit++;
+            mant = mant * 10 + (unsigned int)(*p - '0');
+        } else {
+            if (*p != '0') lossy = true;
+            exp10++;
+        }
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && (unsigned int)(*p - '0') <= 9; p++) {
+            any = true;
+            if (ndigit < 19) {
+                if (mant || *p != '0') ndigit++;
+                mant = mant * 10 + (unsigned int)(*p - '0');
+                exp10--;
+            } else if (*p != '0') {
+                lossy = true;
+            }
+        }
+    }
+    if (any && p < end && (*p == 'e' || *p == 'E')) {
+        const char* q = p + 1;
+        bool eneg = false;
+        if (q < end && (*q == '-' || *q == '+')) eneg = *q++ == '-';
+        if (q < end && (unsigned int)(*q - '0') <= 9) {
+            int e = 0;
+            for (; q < end && (unsigned int)(*q - '0') <= 9; q++) {
+                if (e < 100000) e = e * 10 + (*q - '0');
+            }
+            exp10 += eneg ? -e : e;
+            p = q;
+        }
+    }
+
+    // Jalur cepat (Clinger): mantisa dan 10^|e| sama-sama persis,
+    // jadi satu perkalian/pembagian sudah dibulatkan dengan benar
+    if (any && p == end && !lossy && mant <= (unsigned long long)DOUBLE_BULAT_MAX &&
+        exp10 >= -22 && exp10 <= 22) {
+        double d = (double)mant;
+        d = exp10 < 0 ? d / pow10_persis[-exp10] : d * pow10_persis[exp10];
+        *out = neg ? -d : d;
+        return true;
+    }
+
+    // Sisanya (digit panjang, eksponen besar, inf/nan) lewat strtod
+    size_t n = (size_t)(end - start);
+    if (n == 0) return false;
+    char stack[64];
+    char* copy = n < sizeof(stack) ? stack : malloc(n + 1);
+    if (!copy) return false;
+    memcpy(copy, start, n);
+    copy[n] = 0;
+    char* stop;
+    double d = strtod(copy, &stop);
+    bool ok = stop == copy + n;
+    if (copy != stack) free(copy);
+    if (ok) *out = d;
+    return ok;
+}
+
+// Arena per thread: blok 64 KB yang diisi berurutan dan tidak pernah dibebaskan
+#define ARENA_BLOK (64 * 1024)
+static _Thread_local char* arena_pos;
+static _Thread_local size_t arena_sisa;
+
+char* string_arena_dup(const char* s, size_t len) {
+    char* r;
+    if (len >= ARENA_BLOK / 16) {
+        r = malloc(len + 1);
+    } else {
+        if (arena_sisa < len + 1) {
+            arena_pos = malloc(ARENA_BLOK);
+            arena_sisa = arena_pos ? ARENA_BLOK : 0;
+        }
+        r = arena_pos;
+        if (r) {
+            arena_pos += len + 1;
+            arena_sisa -= len + 1;
+        }
+    }
+    if (!r) return NULL;
+    STATISTIK_PANGGIL(STAT_STRING_ARENA);
+    STATISTIK_BAIT(STAT_STRING_ARENA, len + 1);
+    memcpy(r, s, len);
+    r[len] = 0;
+    return r;
+}
@@ -1,7 +1,11 @@
 #include "string_ops.h"
+#include "string_search.h"
+#include "string_case.h"
+#include "string_utf8.h"
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <stdint.h>
 
 // String operations implementation
 char* string_concat(const char* a, const char* b) {
@@ -21,73 +25,91 @@ char* string_concat(const char* a, const char* b) {
 char** string_split(const char* str, const char* delimiter, int* count) {
     if (!str || !delimiter || !count) return NULL;
     
-    char* temp = strdup(str);
-    if (!temp) return NULL;
-    
-    // Count tokens first
+    // Same tokens as strtok (delimiter is a set, empty tokens skipped) but
+    // reentrant: no hidden state and no copy of the input
     *count = 0;
-    char* token = strtok(temp, delimiter);
-    while (token) {
+    const char* p = str + strspn(str, delimiter);
+    while (*p) {
         (*count)++;
-        token = strtok(NULL, delimiter);
+        p += strcspn(p, delimiter);
+        p += strspn(p, delimiter);
     }
-    
-    free(temp);
     if (*count == 0) return NULL;
     
     // Allocate result array
     char** result = malloc(*count * sizeof(char*));
     if (!result) return NULL;
     
-    // Split again and store
-    temp = strdup(str);
-    token = strtok(temp, delimiter);
-    int i = 0;
-    while (token && i < *count) {
-        result[i] = strdup(token);
-        token = strtok(NULL, delimiter);
-        i++;
+    p = str + strspn(str, delimiter);
+    for (int i = 0; i < *count; i++) {
+        size_t len = strcspn(p, delimiter);
+        result[i] = malloc(len + 1);
+        if (result[i]) {
+            memcpy(result[i], p, len);
+            result[i][len] = '\0';
+        }
+        p += len;
+        p += strspn(p, delimiter);
     }
     
-    free(temp);
     return result;
 }
 
 char* string_replace(const char* str, const char* find, const char* replace) {
     if (!str || !find || !replace) return NULL;
     
-    int find_len = strlen(find);
-    int replace_len = strlen(replace);
-    int str_len = strlen(str);
+    size_t find_len = strlen(find);
+    size_t replace_len = strlen(replace);
+    size_t str_len = strlen(str);
+    if (find_len == 0) return strdup(str);
     
-    // Count occurrences
-    int count = 0;
+    // Find every occurrence once, remembering where it starts
+    size_t pos_stack[64];
+    size_t* pos = pos_stack;
+    size_t cap = 64, count = 0;
     const char* p = str;
-    while ((p = strstr(p, find)) != NULL) {
-        count++;
+    while ((p = string_golek(p, str_len - (p - str), find, find_len)) != NULL) {
+        if (count == cap) {
+            size_t* grown = malloc(cap * 2 * sizeof(size_t));
+            if (!grown) {
+                if (pos != pos_stack) free(pos);
+                return NULL;
+            }
+            memcpy(grown, pos, count * sizeof(size_t));
+            if (pos != pos_stack) free(pos);
+            pos = grown;
+            cap *= 2;
+        }
+        pos[count++] = p - str;
         p += find_len;
     }
     
     if (count == 0) return strdup(str);
     
-    // Calculate new length
-    int new_len = str_len + count * (replace_len - find_len);
+    // Calculate new length (matches never overlap, so this cannot underflow)
+    size_t new_len = str_len - count * find_len;
+    if (replace_len && count > (SIZE_MAX - 1 - new_len) / replace_len) {
+        if (pos != pos_stack) free(pos);
+        return NULL;
+    }
+    new_len += count * replace_len;
     char* result = malloc(new_len + 1);
-    if (!result) return NULL;
     
-    // Perform replacement
-    const char* src = str;
-    char* dst = result;
-    while ((p = strstr(src, find)) != NULL) {
-        int len_before = p - src;
-        strncpy(dst, src, len_before);
-        dst += len_before;
-        strcpy(dst, replace);
-        dst += replace_len;
-        src = p + find_len;
+    // Copy the gaps and replacements in one pass
+    if (result) {
+        char* dst = result;
+        size_t from = 0;
+        for (size_t i = 0; i < count; i++) {
+            memcpy(dst, str + from, pos[i] - from);
+            dst += pos[i] - from;
+            memcpy(dst, replace, replace_len);
+            dst += replace_len;
+            from = pos[i] + find_len;
+        }
+        memcpy(dst, str + from, str_len - from + 1);
     }
-    strcpy(dst, src);
     
+    if (pos != pos_stack) free(pos);
     return result;
 }
 
@@ -95,73 +117,95 @@ int string_length(const char* str) {
     return str ? strlen(str) : 0;
 }
 
+// start and length count characters of valid UTF-8 (bytes otherwise)
 char* string_substring(const char* str, int start, int length) {
     if (!str || start < 0 || length < 0) return NULL;
     
-    int str_len = strlen(str);
-    if (start >= str_len) return strdup("");
+    size_t str_len = strlen(str);
+    size_t from = string_utf8_offset(str, str_len, (size_t)start);
+    if (from >= str_len) return strdup("");
+    size_t to = string_utf8_offset(str, str_len, (size_t)start + (size_t)length);
     
-    if (start + length > str_len) {
-        length = str_len - start;
-    }
-    
-    char* result = malloc(length + 1);
+    size_t n = to - from;
+    char* result = malloc(n + 1);
     if (!result) return NULL;
     
-    strncpy(result, str + start, length);
-    result[length] = '\0';
+    memcpy(result, str + from, n);
+    result[n] = '\0';
     return result;
 }
 
 char* string_to_upper(const char* str) {
     if (!str) return NULL;
     
-    char* result = strdup(str);
+    size_t len = strlen(str);
+    char* result = malloc(len + 1);
     if (!result) return NULL;
     
-    for (int i = 0; result[i]; i++) {
-        result[i] = toupper(result[i]);
-    }
-    
+    result[string_huruf_gedhe(result, str, len)] = '\0';
     return result;
 }
 
 char* string_to_lower(const char* str) {
     if (!str) return NULL;
     
-    char* result = strdup(str);
+    size_t len = strlen(str);
+    char* result = malloc(string_huruf_cilik_dawane(str, len) + 1);
     if (!result) return NULL;
     
-    for (int i = 0; result[i]; i++) {
-        result[i] = tolower(result[i]);
-    }
-    
+    result[string_huruf_cilik(result, str, len)] = '\0';
     return result;
 }
 
+char* string_to_upper_inplace(char* str) {
+    if (str) str[string_huruf_gedhe(str, str, strlen(str))] = '\0';
+    return str;
+}
+
+// İ memanjang saat dikecilkan; string seperti itu disalin ke buffer baru
+char* string_to_lower_inplace(char* str) {
+    if (!str) return str;
+    size_t len = strlen(str);
+    if (string_huruf_cilik_dawane(str, len) != len) return string_to_lower(str);
+    str[string_huruf_cilik(str, str, len)] = '\0';
+    return str;
+}
+
 bool string_contains(const char* str, const char* substr) {
     if (!str || !substr) return false;
-    return strstr(str, substr) != NULL;
+    return string_golek(str, strlen(str), substr, strlen(substr)) != NULL;
 }
 
-char* string_trim(const char* str) {
-    if (!str) return NULL;
+const char* string_trim_view(const char* str, size_t* len) {
+    if (!str) {
+        if (len) *len = 0;
+        return NULL;
+    }
     
     // Skip leading whitespace
-    while (isspace(*str)) str++;
+    while (isspace((unsigned char)*str)) str++;
+    
+    // One pass to the terminator, remembering the last non-space byte
+    const char* end = str;
+    for (const char* p = str; *p; p++) {
+        if (!isspace((unsigned char)*p)) end = p + 1;
+    }
     
-    if (*str == 0) return strdup("");
+    if (len) *len = end - str;
+    return str;
+}
+
+char* string_trim(const char* str) {
+    if (!str) return NULL;
     
-    // Find end
-    const char* end = str + strlen(str) - 1;
-    while (end > str && isspace(*end)) end--;
+    size_t length;
+    const char* start = string_trim_view(str, &length);
     
     // Create result
-    int length = end - str + 1;
     char* result = malloc(length + 1);
     if (!result) return NULL;
     
-    strncpy(result, str, length);
+    memcpy(result, start, length);
     result[length] = '\0';
     return result;
 }
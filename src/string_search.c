@@ -0,0 +1,152 @@
+#include "string_search.h"
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JAWA_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+typedef const char* (*golek_fn)(const char*, size_t, const char*, size_t);
+
+// Versi skalar: memchr mencari byte pertama, lalu byte terakhir
+// disaring sebelum memcmp penuh. needle_len >= 2.
+static const char* golek_skalar(const char* hay, size_t hay_len, const char* needle, size_t needle_len) {
+    if (needle_len > hay_len) return NULL;
+    
+    const char first = needle[0];
+    const char last = needle[needle_len - 1];
+    const char* end = hay + (hay_len - needle_len);  // posisi awal terakhir yang mungkin
+    const char* p = hay;
+    
+    while (p <= end) {
+        p = memchr(p, first, (size_t)(end - p) + 1);
+        if (!p) return NULL;
+        if (p[needle_len - 1] == last && memcmp(p + 1, needle + 1, needle_len - 2) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return NULL;
+}
+
+#ifdef JAWA_SEARCH_X86
+// Filter byte pertama+terakhir: satu blok membandingkan 16/32 posisi awal
+// sekaligus, hanya kandidat yang lolos kedua byte yang dicek memcmp.
+// Empat blok diperiksa bersama; kalau byte pertama tidak muncul sama sekali
+// sisanya dilompati memchr, jadi byte pertama yang langka tetap secepat memchr.
+__attribute__((target("sse2"), always_inline))
+static inline const char* blok_sse2(const char* blok, __m128i f, __m128i last, const char* needle, size_t needle_len) {
+    __m128i b = _mm_loadu_si128((const __m128i*)(blok + needle_len - 1));
+    unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(f, _mm_cmpeq_epi8(b, last)));
+    while (mask) {
+        unsigned bit = (unsigned)__builtin_ctz(mask);
+        if (memcmp(blok + bit + 1, needle + 1, needle_len - 2) == 0) return blok + bit;
+        mask &= mask - 1;
+    }
+    return NULL;
+}
+
+__attribute__((target("sse2")))
+static const char* golek_sse2(const char* hay, size_t hay_len, const char* needle, size_t needle_len) {
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[needle_len - 1]);
+    const char* r;
+    size_t i = 0;
+    
+    for (; i + needle_len - 1 + 64 <= hay_len; i += 64) {
+        __m128i f0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(hay + i)), first);
+        __m128i f1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(hay + i + 16)), first);
+        __m128i f2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(hay + i + 32)), first);
+        __m128i f3 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(hay + i + 48)), first);
+        if (!_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(f0, f1), _mm_or_si128(f2, f3)))) {
+            const char* q = memchr(hay + i + 64, needle[0], hay_len - needle_len + 1 - (i + 64));
+            if (!q) return NULL;
+            i = (size_t)(q - hay) - 64;
+            continue;
+        }
+        if ((r = blok_sse2(hay + i, f0, last, needle, needle_len)) ||
+            (r = blok_sse2(hay + i + 16, f1, last, needle, needle_len)) ||
+            (r = blok_sse2(hay + i + 32, f2, last, needle, needle_len)) ||
+            (r = blok_sse2(hay + i + 48, f3, last, needle, needle_len))) return r;
+    }
+    
+    for (; i + needle_len - 1 + 16 <= hay_len; i += 16) {
+        __m128i f = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(hay + i)), first);
+        if ((r = blok_sse2(hay + i, f, last, needle, needle_len))) return r;
+    }
+    
+    return golek_skalar(hay + i, hay_len - i, needle, needle_len);
+}
+
+__attribute__((target("avx2"), always_inline))
+static inline const char* blok_avx2(const char* blok, __m256i f, __m256i last, const char* needle, size_t needle_len) {
+    __m256i b = _mm256_loadu_si256((const __m256i*)(blok + needle_len - 1));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(f, _mm256_cmpeq_epi8(b, last)));
+    while (mask) {
+        unsigned bit = (unsigned)__builtin_ctz(mask);
+        if (memcmp(blok + bit + 1, needle + 1, needle_len - 2) == 0) return blok + bit;
+        mask &= mask - 1;
+    }
+    return NULL;
+}
+
+__attribute__((target("avx2")))
+static const char* golek_avx2(const char* hay, size_t hay_len, const char* needle, size_t needle_len) {
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[needle_len - 1]);
+    const char* r;
+    size_t i = 0;
+    
+    for (; i + needle_len - 1 + 128 <= hay_len; i += 128) {
+        __m256i f0 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(hay + i)), first);
+        __m256i f1 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(hay + i + 32)), first);
+        __m256i f2 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(hay + i + 64)), first);
+        __m256i f3 = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(hay + i + 96)), first);
+        if (!_mm256_movemask_epi8(_mm256_or_si256(_mm256_or_si256(f0, f1), _mm256_or_si256(f2, f3)))) {
+            const char* q = memchr(hay + i + 128, needle[0], hay_len - needle_len + 1 - (i + 128));
+            if (!q) return NULL;
+            i = (size_t)(q - hay) - 128;
+            continue;
+        }
+        if ((r = blok_avx2(hay + i, f0, last, needle, needle_len)) ||
+            (r = blok_avx2(hay + i + 32, f1, last, needle, needle_len)) ||
+            (r = blok_avx2(hay + i + 64, f2, last, needle, needle_len)) ||
+            (r = blok_avx2(hay + i + 96, f3, last, needle, needle_len))) return r;
+    }
+    
+    for (; i + needle_len - 1 + 32 <= hay_len; i += 32) {
+        __m256i f = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(hay + i)), first);
+        if ((r = blok_avx2(hay + i, f, last, needle, needle_len))) return r;
+    }
+    
+    return golek_skalar(hay + i, hay_len - i, needle, needle_len);
+}
+#endif
+
+static golek_fn pilih_golek(void) {
+#ifdef JAWA_SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return golek_avx2;
+    if (__builtin_cpu_supports("sse2")) return golek_sse2;
+#endif
+    return golek_skalar;
+}
+
+const char* string_golek(const char* hay, size_t hay_len, const char* needle, size_t needle_len) {
+    // Dipilih sekali. Atomik supaya pemilihan bersamaan dari beberapa
+    // thread bukan data race; semua menulis nilai yang sama, relaxed cukup.
+    static _Atomic(golek_fn) impl = NULL;
+    
+    if (needle_len == 0) return hay;
+    if (needle_len > hay_len) return NULL;
+    if (needle_len == 1) return memchr(hay, needle[0], hay_len);
+    
+    golek_fn f = atomic_load_explicit(&impl, memory_order_relaxed);
+    if (!f) {
+        f = pilih_golek();
+        atomic_store_explicit(&impl, f, memory_order_relaxed);
+    }
+    return f(hay, hay_len, needle, needle_len);
+}
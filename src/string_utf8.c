@@ -0,0 +1,201 @@
+#include "string_utf8.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Panjang urutan yang valid mulai di p, atau 0 bila tidak valid
+static size_t panjang_urutan(const unsigned char* p, const unsigned char* end) {
+    unsigned char c = p[0];
+    if (c < 0x80) return 1;
+    if (c < 0xC2 || c > 0xF4) return 0;  // lanjutan, overlong 2 byte, > U+10FFFF
+    
+    size_t n = c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+    if ((size_t)(end - p) < n) return 0;
+    for (size_t i = 1; i < n; i++) {
+        if ((p[i] & 0xC0) != 0x80) return 0;
+    }
+    
+    // Batas byte kedua untuk overlong, surrogate dan > U+10FFFF
+    if (c == 0xE0 && p[1] < 0xA0) return 0;
+    if (c == 0xED && p[1] > 0x9F) return 0;
+    if (c == 0xF0 && p[1] < 0x90) return 0;
+    if (c == 0xF4 && p[1] > 0x8F) return 0;
+    return n;
+}
+
+bool string_utf8_valid(const char* s, size_t len) {
+    const unsigned char* p = (const unsigned char*)s;
+    const unsigned char* end = p + len;
+    
+    while (p < end) {
+#if defined(__SSE2__)
+        // Lewati blok ASCII 16 byte sekaligus
+        while (end - p >= 16 && !_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)p))) p += 16;
+        if (p >= end) break;
+#endif
+        size_t n = panjang_urutan(p, end);
+        if (!n) return false;
+        p += n;
+    }
+    return true;
+}
+
+size_t string_utf8_count(const char* s, size_t len) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Karakter = byte yang bukan lanjutan (0x80..0xBF, bertanda -128..-65)
+    const __m128i batas = _mm_set1_epi8(-65);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        count += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpgt_epi8(v, batas)));
+    }
+#endif
+    for (; i < len; i++) {
+        if (((unsigned char)s[i] & 0xC0) != 0x80) count++;
+    }
+    return count;
+}
+
+size_t string_utf8_chars(const char* s, size_t len) {
+    return string_utf8_valid(s, len) ? string_utf8_count(s, len) : len;
+}
+
+// Indeks jarang: offset byte setiap LANGKAH_INDEKS karakter
+#define LANGKAH_INDEKS 32
+#define INDEKS_MIN_LEN 256
+#define CACHE_INDEKS 8
+
+typedef struct {
+    const char* s;
+    size_t len;
+    unsigned generasi;  // generasi_indeks saat dibangun
+    bool valid;
+    size_t chars;
+    size_t* offsets;   // offsets[k] = byte dari karakter k * LANGKAH_INDEKS
+} IndeksUtf8;
+
+static _Thread_local IndeksUtf8 cache_indeks[CACHE_INDEKS];
+static _Thread_local unsigned cache_berikut;
+
+// Naik setiap ada buffer yang diubah di tempat atau dibebaskan; indeks
+// dari generasi lama tidak dipakai lagi walau alamat dan panjangnya sama
+static atomic_uint generasi_indeks;
+
+void string_utf8_lali(void) {
+    atomic_fetch_add_explicit(&generasi_indeks, 1, memory_order_release);
+}
+
+#ifndef _WIN32
+// Offsets milik thread dibebaskan saat thread selesai
+static pthread_key_t kunci_indeks;
+static pthread_once_t kunci_sekali = PTHREAD_ONCE_INIT;
+
+static void buang_indeks(void* p) {
+    IndeksUtf8* cache = p;
+    for (int i = 0; i < CACHE_INDEKS; i++) {
+        free(cache[i].offsets);
+        cache[i].offsets = NULL;
+        cache[i].s = NULL;
+    }
+}
+
+static void gawe_kunci(void) {
+    pthread_key_create(&kunci_indeks, buang_indeks);
+}
+#endif
+
+// Maju n karakter dari byte p (UTF-8 valid)
+static size_t maju(const char* s, size_t len, size_t p, size_t n) {
+    while (n > 0 && p < len) {
+        p++;
+        while (p < len && ((unsigned char)s[p] & 0xC0) == 0x80) p++;
+        n--;
+    }
+    return p;
+}
+
+static IndeksUtf8* ambil_indeks(const char* s, size_t len) {
+    unsigned generasi = atomic_load_explicit(&generasi_indeks, memory_order_acquire);
+    for (int i = 0; i < CACHE_INDEKS; i++) {
+        IndeksUtf8* e = &cache_indeks[i];
+        if (e->s == s && e->len == len && e->generasi == generasi) return e;
+    }
+    
+#ifndef _WIN32
+    if (!cache_berikut) {
+        pthread_once(&kunci_sekali, gawe_kunci);
+        pthread_setspecific(kunci_indeks, cache_indeks);
+    }
+#endif
+    IndeksUtf8* e = &cache_indeks[cache_berikut++ % CACHE_INDEKS];
+    free(e->offsets);
+    e->s = s;
+    e->len = len;
+    e->generasi = generasi;
+    e->offsets = NULL;
+    e->valid = string_utf8_valid(s, len);
+    e->chars = e->valid ? string_utf8_count(s, len) : len;
+    if (!e->valid) return e;
+    
+    // Satu kali lintasan untuk semua titik indeks
+    size_t slot = e->chars / LANGKAH_INDEKS + 1;
+    e->offsets = malloc(slot * sizeof(size_t));
+    if (!e->offsets) return e;
+    size_t p = 0;
+    for (size_t k = 0; k < slot; k++) {
+        e->offsets[k] = p;
+        p = maju(s, len, p, LANGKAH_INDEKS);
+    }
+    return e;
+}
+
+size_t string_utf8_offset(const char* s, size_t len, size_t n) {
+    if (!s) return 0;
+    if (len < INDEKS_MIN_LEN) {
+        // Pendek: langsung jalan, tanpa cache
+        if (!string_utf8_valid(s, len)) return n < len ? n : len;
+        return maju(s, len, 0, n);
+    }
+    
+    IndeksUtf8* e = ambil_indeks(s, len);
+    if (!e->valid) return n < len ? n : len;
+    if (n >= e->chars) return len;
+    if (!e->offsets) return maju(s, len, 0, n);
+    return maju(s, len, e->offsets[n / LANGKAH_INDEKS], n % LANGKAH_INDEKS);
+}
+
+void string_utf8_iter(Utf8Iter* it, const char* s, size_t len) {
+    it->pos = s;
+    it->end = s + len;
+}
+
+bool string_utf8_next(Utf8Iter* it, uint32_t* cp, const char** bytes, size_t* nbytes) {
+    if (it->pos >= it->end) return false;
+    
+    const unsigned char* p = (const unsigned char*)it->pos;
+    size_t n = panjang_urutan(p, (const unsigned char*)it->end);
+    uint32_t c;
+    switch (n) {
+        case 1: c = p[0]; break;
+        case 2: c = ((uint32_t)(p[0] & 0x1F) << 6) | (p[1] & 0x3F); break;
+        case 3: c = ((uint32_t)(p[0] & 0x0F) << 12) | ((uint32_t)(p[1] & 0x3F) << 6) | (p[2] & 0x3F); break;
+        case 4: c = ((uint32_t)(p[0] & 0x07) << 18) | ((uint32_t)(p[1] & 0x3F) << 12) |
+                    ((uint32_t)(p[2] & 0x3F) << 6) | (p[3] & 0x3F); break;
+        default: c = 0xFFFD; n = 1; break;
+    }
+    
+    if (cp) *cp = c;
+    if (bytes) *bytes = it->pos;
+    if (nbytes) *nbytes = n;
+    it->pos += n;
+    return true;
+}
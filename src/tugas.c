@@ -0,0 +1,400 @@
+#include "tugas.h"
+#include "output.h"
+#include "statistik.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+#define BENANG_MAX 256   // worker paling banyak, termasuk pengganti
+
+struct JawaTugas {
+    TugasFn fn;
+    void* arg;
+    JawaNilai hasil;
+#ifndef _WIN32
+    atomic_int rampung;
+    atomic_int dijupuk;      // 1 setelah ada thread yang menjalankannya
+    atomic_int ref;          // pemilik handle + antrian
+#else
+    int rampung;
+    int ref;
+#endif
+};
+
+struct JawaKanal {
+    JawaNilai* isi;
+    size_t kapasitas;
+    size_t kepala;           // indeks isi berikutnya yang ditampa
+    size_t cacah;
+    bool ditutup;
+#ifndef _WIN32
+    pthread_mutex_t kunci;
+    pthread_cond_t isa_kirim;
+    pthread_cond_t isa_tampa;
+#endif
+};
+
+static void jalankan(JawaTugas* t);
+
+static void tugas_lepas(JawaTugas* t) {
+#ifndef _WIN32
+    if (atomic_fetch_sub(&t->ref, 1) == 1) free(t);
+#else
+    if (--t->ref == 0) free(t);
+#endif
+}
+
+#ifndef _WIN32
+// Antrian tugas satu worker: pemilik menambah dan mengambil dari buntut
+// (LIFO, data masih hangat di cache), pencuri mengambil dari kepala.
+// Antrian 0 menampung tugas dari thread yang bukan worker.
+typedef struct {
+    pthread_mutex_t kunci;
+    JawaTugas** isi;
+    size_t kepala, buntut;   // naik terus, indeks isi = nilai & (cap - 1)
+    size_t cap;
+} Antrian;
+
+static Antrian antrian[BENANG_MAX + 1];
+static pthread_once_t pool_sekali = PTHREAD_ONCE_INIT;
+static pthread_mutex_t jadwal_kunci = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ana_gawe = PTHREAD_COND_INITIALIZER;     // worker nganggur
+static pthread_cond_t ana_rampung = PTHREAD_COND_INITIALIZER;  // tunggu / entekke
+static int target;                // worker yang diusahakan tetap jalan
+static atomic_int cacah_worker;   // worker yang sudah dibuat
+static int aktif;                 // worker yang tidak tertahan (jadwal_kunci)
+static atomic_int turu;           // worker yang tidur menunggu tugas
+static atomic_int nunggu;         // thread yang menunggu ana_rampung
+static atomic_llong antri;        // tugas di antrian
+static atomic_llong isih;         // tugas yang belum selesai
+static _Thread_local int worker_id;    // 0 = bukan worker
+static _Thread_local int blokir_jero;  // blokir bersarang
+
+static int jumlah_benang(void) {
+    const char* env = getenv("JAWA_THREADS");
+    int n = env ? atoi(env) : 0;
+    if (n <= 0) n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) n = 1;
+    return n > BENANG_MAX ? BENANG_MAX : n;
+}
+
+static bool antrian_tambah(Antrian* a, JawaTugas* t) {
+    pthread_mutex_lock(&a->kunci);
+    if (a->buntut - a->kepala == a->cap) {
+        size_t cap = a->cap ? a->cap * 2 : 64;
+        JawaTugas** isi = malloc(sizeof(*isi) * cap);
+        if (!isi) {
+            pthread_mutex_unlock(&a->kunci);
+            return false;
+        }
+        for (size_t i = a->kepala; i != a->buntut; i++) {
+            isi[i & (cap - 1)] = a->isi[i & (a->cap - 1)];
+        }
+        free(a->isi);
+        a->isi = isi;
+        a->cap = cap;
+    }
+    a->isi[a->buntut++ & (a->cap - 1)] = t;
+    pthread_mutex_unlock(&a->kunci);
+    return true;
+}
+
+static JawaTugas* antrian_ambil(Antrian* a, bool dari_buntut) {
+    JawaTugas* t = NULL;
+    pthread_mutex_lock(&a->kunci);
+    if (a->buntut != a->kepala) {
+        if (dari_buntut) t = a->isi[--a->buntut & (a->cap - 1)];
+        else t = a->isi[a->kepala++ & (a->cap - 1)];
+    }
+    pthread_mutex_unlock(&a->kunci);
+    return t;
+}
+
+// Menandai t sebagai sedang dijalankan; false bila sudah diambil thread lain
+static bool jupuk(JawaTugas* t) {
+    int nol = 0;
+    if (!atomic_compare_exchange_strong(&t->dijupuk, &nol, 1)) return false;
+    atomic_fetch_sub(&antri, 1);
+    return true;
+}
+
+// Tugas berikutnya untuk worker id: antrian sendiri, antrian umum,
+// lalu curian dari worker lain. Isi antrian yang sudah dijalankan
+// penunggunya dilewati dan referensinya dilepas.
+static JawaTugas* golek(int id) {
+    while (atomic_load(&antri) > 0) {
+        JawaTugas* t = antrian_ambil(&antrian[id], true);
+        if (!t) t = antrian_ambil(&antrian[0], false);
+        int n = atomic_load(&cacah_worker);
+        for (int k = 1; !t && k < n; k++) {
+            t = antrian_ambil(&antrian[(id + k - 1) % n + 1], false);
+        }
+        if (!t) return NULL;
+        if (jupuk(t)) return t;
+        tugas_lepas(t);
+    }
+    return NULL;
+}
+
+static void* worker(void* arg) {
+    worker_id = (int)(intptr_t)arg;
+    for (;;) {
+        JawaTugas* t = golek(worker_id);
+        if (t) {
+            jalankan(t);
+            tugas_lepas(t);
+            continue;
+        }
+        pthread_mutex_lock(&jadwal_kunci);
+        atomic_fetch_add(&turu, 1);
+        while (atomic_load(&antri) <= 0) pthread_cond_wait(&ana_gawe, &jadwal_kunci);
+        atomic_fetch_sub(&turu, 1);
+        pthread_mutex_unlock(&jadwal_kunci);
+    }
+    return NULL;
+}
+
+// Membuat satu worker lagi; dipanggil dengan jadwal_kunci dipegang
+static void tambah_worker(void) {
+    int id = atomic_load(&cacah_worker) + 1;
+    if (id > BENANG_MAX) {
+        // Dilaporkan sekali: tanpa pengganti, worker yang tertahan I/O
+        // atau tunggu bisa menahan tugas lain sampai macet
+        static bool wis_kabar;
+        if (!wis_kabar) {
+            wis_kabar = true;
+            fprintf(stderr, "Peringatan: worker tugas wis tekan wates %d, ora ana worker pengganti maneh\n", BENANG_MAX);
+        }
+        return;
+    }
+    pthread_mutex_init(&antrian[id].kunci, NULL);
+    pthread_t th;
+    if (pthread_create(&th, NULL, worker, (void*)(intptr_t)id) != 0) return;
+    pthread_detach(th);
+    atomic_store(&cacah_worker, id);
+    aktif++;
+}
+
+static void pool_siapkan(void) {
+    pthread_mutex_init(&antrian[0].kunci, NULL);
+    target = jumlah_benang();
+    // Output sekarang bisa datang dari beberapa thread
+    cithak_bareng();
+    atexit(tugas_entekke);
+    pthread_mutex_lock(&jadwal_kunci);
+    while (aktif < target && atomic_load(&cacah_worker) < BENANG_MAX) {
+        int sebelum = aktif;
+        tambah_worker();
+        if (aktif == sebelum) break;
+    }
+    pthread_mutex_unlock(&jadwal_kunci);
+}
+
+void tugas_blokir_mulai(void) {
+    if (!worker_id || blokir_jero++ > 0) return;
+    // Worker ini bisa lama tertahan: pastikan tetap ada target worker
+    // yang bisa menjalankan tugas lain
+    pthread_mutex_lock(&jadwal_kunci);
+    aktif--;
+    if (aktif < target) tambah_worker();
+    pthread_mutex_unlock(&jadwal_kunci);
+}
+
+void tugas_blokir_rampung(void) {
+    if (!worker_id || --blokir_jero > 0) return;
+    pthread_mutex_lock(&jadwal_kunci);
+    aktif++;
+    pthread_mutex_unlock(&jadwal_kunci);
+}
+
+static void kabari_rampung(void) {
+    if (atomic_load(&nunggu) > 0) {
+        pthread_mutex_lock(&jadwal_kunci);
+        pthread_cond_broadcast(&ana_rampung);
+        pthread_mutex_unlock(&jadwal_kunci);
+    }
+}
+#else
+void tugas_blokir_mulai(void) {}
+void tugas_blokir_rampung(void) {}
+#endif
+
+static void jalankan(JawaTugas* t) {
+    t->fn(t->arg, &t->hasil);
+    free(t->arg);
+    t->arg = NULL;
+#ifndef _WIN32
+    atomic_store(&t->rampung, 1);
+    atomic_fetch_sub(&isih, 1);
+    kabari_rampung();
+#else
+    t->rampung = 1;
+#endif
+}
+
+JawaTugas* tugas_mulai(TugasFn fn, void* arg) {
+    JawaTugas* t = calloc(1, sizeof(*t));
+    if (!t) {
+        fprintf(stderr, "Error: ora cukup memori kanggo tugas anyar\n");
+        exit(1);
+    }
+    t->fn = fn;
+    t->arg = arg;
+    t->ref = 2;
+    STATISTIK_PANGGIL(STAT_TUGAS);
+#ifndef _WIN32
+    pthread_once(&pool_sekali, pool_siapkan);
+    atomic_fetch_add(&isih, 1);
+    if (antrian_tambah(&antrian[worker_id], t)) {
+        atomic_fetch_add(&antri, 1);
+        if (atomic_load(&turu) > 0) {
+            pthread_mutex_lock(&jadwal_kunci);
+            pthread_cond_signal(&ana_gawe);
+            pthread_mutex_unlock(&jadwal_kunci);
+        }
+        return t;
+    }
+#endif
+    // Tanpa thread (atau antrian gagal tumbuh): langsung dijalankan
+    jalankan(t);
+    tugas_lepas(t);
+    return t;
+}
+
+JawaNilai tugas_tunggu(JawaTugas** tp) {
+    JawaTugas* t = tp ? *tp : NULL;
+    if (!t) {
+        JawaNilai nol = {0};
+        return nol;
+    }
+    *tp = NULL;
+#ifndef _WIN32
+    // Tugas yang belum mulai langsung dijalankan di sini. Tugas lain dari
+    // antrian tidak dikerjakan: bisa saja menunggu sesuatu yang baru
+    // dilakukan pemanggil setelah tunggu ini, padahal stack-nya ada di
+    // atas pemanggil. Selama menunggu, worker ini diganti worker baru.
+    if (jupuk(t)) {
+        jalankan(t);
+    } else if (!atomic_load(&t->rampung)) {
+        tugas_blokir_mulai();
+        pthread_mutex_lock(&jadwal_kunci);
+        atomic_fetch_add(&nunggu, 1);
+        while (!atomic_load(&t->rampung)) pthread_cond_wait(&ana_rampung, &jadwal_kunci);
+        atomic_fetch_sub(&nunggu, 1);
+        pthread_mutex_unlock(&jadwal_kunci);
+        tugas_blokir_rampung();
+    }
+#endif
+    JawaNilai hasil = t->hasil;
+    tugas_lepas(t);
+    return hasil;
+}
+
+void tugas_lali(JawaTugas* t) {
+    if (t) tugas_lepas(t);
+}
+
+void tugas_entekke(void) {
+#ifndef _WIN32
+    if (worker_id) return;   // exit() dari dalam tugas
+    pthread_mutex_lock(&jadwal_kunci);
+    atomic_fetch_add(&nunggu, 1);
+    while (atomic_load(&isih) > 0) pthread_cond_wait(&ana_rampung, &jadwal_kunci);
+    atomic_fetch_sub(&nunggu, 1);
+    pthread_mutex_unlock(&jadwal_kunci);
+#endif
+    cithak_flush();
+}
+
+JawaKanal* kanal_anyar(long long kapasitas) {
+    JawaKanal* k = calloc(1, sizeof(*k));
+    if (!k) return NULL;
+    k->kapasitas = kapasitas > 0 ? (size_t)kapasitas : 1;
+    k->isi = malloc(sizeof(JawaNilai) * k->kapasitas);
+    if (!k->isi) {
+        free(k);
+        return NULL;
+    }
+#ifndef _WIN32
+    pthread_mutex_init(&k->kunci, NULL);
+    pthread_cond_init(&k->isa_kirim, NULL);
+    pthread_cond_init(&k->isa_tampa, NULL);
+#endif
+    return k;
+}
+
+void kanal_kirim(JawaKanal* k, JawaNilai v) {
+    if (!k) return;
+    STATISTIK_PANGGIL(STAT_KANAL_KIRIM);
+#ifndef _WIN32
+    pthread_mutex_lock(&k->kunci);
+    if (k->cacah == k->kapasitas && !k->ditutup) {
+        tugas_blokir_mulai();
+        while (k->cacah == k->kapasitas && !k->ditutup) pthread_cond_wait(&k->isa_kirim, &k->kunci);
+        tugas_blokir_rampung();
+    }
+#else
+    // Tanpa thread tidak ada yang menampa selama menunggu: kanal tumbuh
+    if (k->cacah == k->kapasitas) {
+        JawaNilai* isi = malloc(sizeof(JawaNilai) * k->kapasitas * 2);
+        if (!isi) return;
+        for (size_t i = 0; i < k->cacah; i++) isi[i] = k->isi[(k->kepala + i) % k->kapasitas];
+        free(k->isi);
+        k->isi = isi;
+        k->kepala = 0;
+        k->kapasitas *= 2;
+    }
+#endif
+    if (!k->ditutup) {
+        k->isi[(k->kepala + k->cacah) % k->kapasitas] = v;
+        k->cacah++;
+    }
+#ifndef _WIN32
+    pthread_cond_signal(&k->isa_tampa);
+    pthread_mutex_unlock(&k->kunci);
+#endif
+}
+
+JawaNilai kanal_tampa(JawaKanal* k) {
+    JawaNilai v = {0};
+    if (!k) return v;
+#ifndef _WIN32
+    pthread_mutex_lock(&k->kunci);
+    if (k->cacah == 0 && !k->ditutup) {
+        tugas_blokir_mulai();
+        while (k->cacah == 0 && !k->ditutup) pthread_cond_wait(&k->isa_tampa, &k->kunci);
+        tugas_blokir_rampung();
+    }
+#endif
+    if (k->cacah > 0) {
+        v = k->isi[k->kepala];
+        k->kepala = (k->kepala + 1) % k->kapasitas;
+        k->cacah--;
+    }
+#ifndef _WIN32
+    pthread_cond_signal(&k->isa_kirim);
+    pthread_mutex_unlock(&k->kunci);
+#endif
+    return v;
+}
+
+void kanal_tutup(JawaKanal* k) {
+    if (!k) return;
+#ifndef _WIN32
+    pthread_mutex_lock(&k->kunci);
+    k->ditutup = true;
+    pthread_cond_broadcast(&k->isa_kirim);
+    pthread_cond_broadcast(&k->isa_tampa);
+    pthread_mutex_unlock(&k->kunci);
+#else
+    k->ditutup = true;
+#endif
+}